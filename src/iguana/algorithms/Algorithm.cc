@@ -23,12 +23,22 @@ namespace iguana {
 
   void Algorithm::Start(hipo::banklist& banks)
   {
-    ParseYAMLConfig();
+    m_bank_access.clear();
+    {
+      Tracer::Span span(m_name, "ParseYAMLConfig");
+      ParseYAMLConfig();
+    }
     m_log->Debug(fmt::format("/{}\\", Logger::Header("ConfigHook")));
-    ConfigHook();
+    {
+      Tracer::Span span(m_name, "ConfigHook");
+      ConfigHook();
+    }
     m_log->Debug(fmt::format("\\{:=^50}/", ""));
     m_log->Debug(fmt::format("/{}\\", Logger::Header("StartHook")));
-    StartHook(banks);
+    {
+      Tracer::Span span(m_name, "StartHook");
+      StartHook(banks);
+    }
     m_log->Debug(fmt::format("\\{:=^50}/", ""));
   }
 
@@ -45,17 +55,70 @@ namespace iguana {
 
   bool Algorithm::Run(hipo::banklist& banks) const
   {
+    Tracer::Span span(m_name, "Run", Tracer::SpanKind::event);
+    ScratchArena::Scope const scratch_scope;
+    BankIndexCache::Scope const index_scope;
     m_log->Trace("=========== {}::RunHook ===========", m_class_name);
+    if(m_profiler)
+      return RunProfiled(banks);
     return RunHook(banks);
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
+  void Algorithm::RunBatch(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const
+  {
+    if(accepted.size() != batch.size()) {
+      m_log->Error("RunBatch called with {} events, but {} accepted flags", batch.size(), accepted.size());
+      throw std::runtime_error("RunBatch failed");
+    }
+    Tracer::Span span(m_name, "RunBatch", Tracer::SpanKind::event);
+    ScratchArena::Scope const scratch_scope;
+    BankIndexCache::Scope const index_scope;
+    m_log->Trace("=========== {}::RunBatchHook ({} events) ===========", m_class_name, batch.size());
+    if(m_profiler)
+      RunBatchProfiled(batch, accepted);
+    else
+      RunBatchHook(batch, accepted);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::vector<bool> Algorithm::RunBatch(std::vector<hipo::banklist>& batch) const
+  {
+    std::vector<bool> accepted(batch.size(), true);
+    RunBatch(batch, accepted);
+    return accepted;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const
+  {
+    for(decltype(batch.size()) i = 0; i < batch.size(); i++) {
+      if(accepted[i])
+        accepted[i] = RunHook(batch[i]);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
   void Algorithm::Stop()
   {
     m_log->Trace(fmt::format("/{}\\", Logger::Header("StopHook")));
-    StopHook();
+    {
+      Tracer::Span span(m_name, "StopHook");
+      StopHook();
+    }
     m_log->Trace(fmt::format("\\{:=^50}/", ""));
+    if(m_profiler && m_profile_report) {
+      auto summaries = GetProfileSummaries();
+      Profiler::PrintTable(summaries, *m_log);
+      if(!m_profile_json.empty()) {
+        Profiler::WriteJSON(summaries, m_profile_json);
+        m_log->Info("wrote profile to {:?}", m_profile_json);
+      }
+    }
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -119,13 +182,13 @@ namespace iguana {
   void Algorithm::SetName(std::string_view name)
   {
     Object::SetName(name);
-    if(m_yaml_config)
+    if(m_yaml_config && !m_yaml_config_shared)
       m_yaml_config->SetName("config|" + m_name);
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
-  std::unique_ptr<YAMLReader> const& Algorithm::GetConfig() const
+  std::shared_ptr<YAMLReader> const& Algorithm::GetConfig() const
   {
     return m_yaml_config;
   }
@@ -134,7 +197,8 @@ namespace iguana {
 
   void Algorithm::SetConfig(std::unique_ptr<YAMLReader>&& yaml_config)
   {
-    m_yaml_config = std::move(yaml_config);
+    m_yaml_config        = std::move(yaml_config);
+    m_yaml_config_shared = false;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -162,7 +226,7 @@ namespace iguana {
       o_user_config_file = GetCachedOption<std::string>("config_file").value_or("");
       o_user_config_dir  = GetCachedOption<std::string>("config_dir").value_or("");
       m_log->Debug("Instantiating `YAMLReader`");
-      m_yaml_config = std::make_unique<YAMLReader>("config|" + m_name);
+      m_yaml_config = std::make_shared<YAMLReader>("config|" + m_name);
       m_yaml_config->SetLogLevel(m_log->GetLevel()); // synchronize log levels
       m_yaml_config->AddDirectory(o_user_config_dir);
       try {
@@ -179,11 +243,12 @@ namespace iguana {
     // parse the files
     m_yaml_config->LoadFiles();
 
-    // set log level
+    // set log level; a shared `YAMLReader` already has the original algorithm's level
     try {
       auto log_level = GetOptionScalar<std::string>({"log"});
       m_log->SetLevel(log_level);
-      m_yaml_config->SetLogLevel(log_level);
+      if(!m_yaml_config_shared)
+        m_yaml_config->SetLogLevel(log_level);
     }
     catch(std::runtime_error const& ex) {
       PrintOptionValue("log", m_log->GetLevelName() + " (default)");
@@ -194,12 +259,29 @@ namespace iguana {
 
   void Algorithm::StartRCDBReader()
   {
-    m_rcdb = std::make_unique<RCDBReader>("RCDB|" + GetName(), m_log->GetLevel());
+    if(m_rcdb) {
+      m_log->Debug("`RCDBReader` already instantiated for this algorithm; using that");
+      return;
+    }
+    m_rcdb = std::make_shared<RCDBReader>("RCDB|" + GetName(), m_log->GetLevel());
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
-  hipo::banklist::size_type Algorithm::GetBankIndex(hipo::banklist& banks, std::string const& bank_name) const
+  hipo::banklist::size_type Algorithm::GetBankIndex(
+      hipo::banklist& banks,
+      std::string const& bank_name,
+      BankAccess const access) const
+  {
+    auto idx = FindBankIndex(banks, bank_name);
+    if(!m_rows_only)
+      RecordBankAccess(idx, access);
+    return idx;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  hipo::banklist::size_type Algorithm::FindBankIndex(hipo::banklist& banks, std::string const& bank_name) const
   {
     if(m_rows_only)
       return 0;
@@ -371,13 +453,126 @@ namespace iguana {
 
   ///////////////////////////////////////////////////////////////////////////////
 
-  std::unique_ptr<RCDBReader>& Algorithm::GetRCDBReader()
+  std::shared_ptr<RCDBReader>& Algorithm::GetRCDBReader()
   {
     return m_rcdb;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
+  std::unique_ptr<Algorithm> Algorithm::Clone(hipo::banklist& banks) const noexcept(false)
+  {
+    auto replica = CreateReplica();
+    replica->Start(banks);
+    return replica;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<Algorithm> Algorithm::Clone() const noexcept(false)
+  {
+    auto replica = CreateReplica();
+    replica->Start();
+    return replica;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<Algorithm> Algorithm::CreateReplica() const noexcept(false)
+  {
+    auto replica = AlgorithmFactory::Create(m_class_name);
+    if(replica == nullptr) {
+      m_log->Error("cannot replicate algorithm {:?}, since its class {:?} is not registered", m_name, m_class_name);
+      throw std::runtime_error("cannot Clone algorithm");
+    }
+    replica->SetName(m_name);
+    replica->SetLogLevel(m_log->GetLevel());
+    replica->m_option_cache       = m_option_cache;
+    replica->m_yaml_config        = m_yaml_config;
+    replica->m_yaml_config_shared = m_yaml_config != nullptr;
+    replica->m_rcdb               = m_rcdb;
+    replica->m_profiler           = m_profiler;
+    return replica;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::EnableProfiling(std::string const& json_file)
+  {
+    m_profile_report = true;
+    m_profile_json   = json_file;
+    CreateProfilers();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::CreateProfilers()
+  {
+    m_profiler = std::make_shared<Profiler>(m_name);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::vector<ProfileSummary> Algorithm::GetProfileSummaries() const
+  {
+    if(!m_profiler)
+      return {};
+    return {m_profiler->Summarize()};
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool Algorithm::RunProfiled(hipo::banklist& banks) const
+  {
+    auto rows_in    = CountRows(banks, true);
+    auto start      = Profiler::clock_t::now();
+    auto result     = RunHook(banks);
+    auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Profiler::clock_t::now() - start).count();
+    m_profiler->GetThreadCounters().Record(elapsed_ns, result, rows_in, CountRows(banks, false));
+    return result;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::RunBatchProfiled(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const
+  {
+    unsigned long long num_calls = 0;
+    unsigned long long rows_in   = 0;
+    for(decltype(batch.size()) i = 0; i < batch.size(); i++) {
+      if(accepted[i]) {
+        num_calls++;
+        rows_in += CountRows(batch[i], true);
+      }
+    }
+    auto const was_accepted = accepted;
+    auto start              = Profiler::clock_t::now();
+    RunBatchHook(batch, accepted);
+    auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Profiler::clock_t::now() - start).count();
+    unsigned long long num_passed = 0;
+    unsigned long long rows_out   = 0;
+    for(decltype(batch.size()) i = 0; i < batch.size(); i++) {
+      if(was_accepted[i]) {
+        num_passed += accepted[i] ? 1 : 0;
+        rows_out += CountRows(batch[i], false);
+      }
+    }
+    m_profiler->GetThreadCounters().RecordBatch(elapsed_ns, num_calls, num_passed, rows_in, rows_out);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  unsigned long long Algorithm::CountRows(hipo::banklist& banks, bool const input) const
+  {
+    unsigned long long num_rows = 0;
+    for(auto const& [bank_idx, access] : m_bank_access) {
+      if(bank_idx < banks.size() && (input ? access != BankAccess::create : access != BankAccess::read))
+        num_rows += banks[bank_idx].getRowList().size();
+    }
+    return num_rows;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
   hipo::schema Algorithm::CreateBank(
       hipo::banklist& banks,
       hipo::banklist::size_type& bank_idx,
@@ -392,30 +587,94 @@ namespace iguana {
     auto bank_schema = GetCreatedBankSchema(bank_name);
     bank_idx         = banks.size();
     banks.emplace_back(bank_schema, 0);
+    RecordBankAccess(bank_idx, BankAccess::create);
     return bank_schema;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
-  void Algorithm::ShowBanks(hipo::banklist const& banks, std::string_view message, Logger::Level const level) const
+  PindexIndex const& Algorithm::GetPindexIndex(hipo::bank const& bank) const
   {
-    if(m_log->GetLevel() <= level) {
-      if(!message.empty())
-        m_log->Print(level, message);
-      for(auto& bank : banks)
-        bank.show();
+    try {
+      if(auto cache = BankIndexCache::GetActive(); cache != nullptr)
+        return cache->GetPindexIndex(bank);
+      // no `Run` call has made a cache active, _e.g._, for a `Run` function which takes `hipo::bank` parameters, so use this
+      // function's own cache, which is invalidated by every call, so that it only holds one bank
+      thread_local BankIndexCache local_cache;
+      local_cache.Invalidate();
+      return local_cache.GetPindexIndex(bank);
+    }
+    catch(std::runtime_error const& ex) {
+      m_log->Error("{}", ex.what());
+      throw std::runtime_error("cannot GetPindexIndex");
     }
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
-  void Algorithm::ShowBank(hipo::bank const& bank, std::string_view message, Logger::Level const level) const
+  RowListMask const& Algorithm::GetRowListMask(hipo::bank const& bank) const
   {
-    if(m_log->GetLevel() <= level) {
-      if(!message.empty())
-        m_log->Print(level, message);
-      bank.show();
+    if(auto cache = BankIndexCache::GetActive(); cache != nullptr)
+      return cache->GetRowListMask(bank);
+    // no `Run` call has made a cache active, so use this function's own cache, which is invalidated by every call
+    thread_local BankIndexCache local_cache;
+    local_cache.Invalidate();
+    return local_cache.GetRowListMask(bank);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::RecordBankAccess(hipo::banklist::size_type const bank_idx, BankAccess const access) const
+  {
+    if(auto it{m_bank_access.find(bank_idx)}; it != m_bank_access.end())
+      it->second = std::max(it->second, access);
+    else
+      m_bank_access.insert({bank_idx, access});
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  row_kernel_t Algorithm::MakeRowKernel(hipo::banklist& banks) const noexcept(false)
+  {
+    m_log->Error("algorithm {:?} has no row filter kernel", m_class_name);
+    throw std::runtime_error("cannot MakeRowKernel");
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::ApplyRowMask(hipo::bank& bank, row_mask_t const& accept)
+  {
+    thread_local hipo::bank::rowlist::list_t accepted_rows; // reused, to avoid reallocation for each event
+    auto const& rows = bank.getRowList();
+    accepted_rows.clear();
+    for(decltype(rows.size()) i = 0; i < rows.size(); i++) {
+      if(accept[i] != 0)
+        accepted_rows.push_back(rows[i]);
     }
+    if(accepted_rows.size() != rows.size())
+      bank.getMutableRowList().setList(accepted_rows);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::map<hipo::banklist::size_type, Algorithm::BankAccess> const& Algorithm::GetBankAccess() const
+  {
+    return m_bank_access;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::PrintMessage(std::string_view message, Logger::Level const level) const
+  {
+    if(!message.empty())
+      m_log->Print(level, message);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Algorithm::PrintHeader(std::string_view header, Logger::Level const level) const
+  {
+    m_log->Print(level, Logger::Header(header));
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <mutex>
 #include <optional>
 #include <set>
@@ -7,8 +8,14 @@
 #include <hipo4/bank.h>
 
 #include "AlgorithmBoilerplate.h"
+#include "BankColumn.h"
+#include "BankIndex.h"
+#include "FunctionRef.h"
+#include "ScratchArena.h"
 #include "iguana/bankdefs/BankDefs.h"
 #include "iguana/services/Deprecated.h"
+#include "iguana/services/Profiler.h"
+#include "iguana/services/Tracer.h"
 #include "iguana/services/RCDBReader.h"
 #include "iguana/services/YAMLReader.h"
 #include <iguana/services/GlobalParam.h>
@@ -56,6 +63,14 @@ namespace iguana {
       std::vector<double>,
       std::vector<std::string>>;
 
+  /// Accept flags of the rows in a bank's row list: element `i` is nonzero if the `i`-th row of the row list is accepted
+  using row_mask_t = std::vector<uint8_t>;
+
+  /// Row filter kernel of a filter algorithm, for one event: given a bank, its row list and the rows' accept flags, it clears the flag
+  /// of each row which it rejects. It must not set any flag, and it may skip the rows whose flags are already cleared. It is a non-owning
+  /// reference to a callable, so that making one does not allocate; `Algorithm::MakeRowKernel` keeps the callable in the `ScratchArena`.
+  using row_kernel_t = FunctionRef<void(hipo::bank const&, hipo::bank::rowlist::list_t const&, row_mask_t&)>;
+
   /// @brief Base class for all algorithms to inherit from
   ///
   /// This is the base class for all algorithms. It provides common members, such as
@@ -67,8 +82,24 @@ namespace iguana {
   class Algorithm : public Object
   {
 
+      // `AlgorithmSequence` replicates its algorithms with `Algorithm::CreateReplica`
+      friend class AlgorithmSequence;
+
     public:
 
+      /// @brief How an algorithm uses a bank
+      ///
+      /// This is recorded for each bank when its index is cached by `Algorithm::GetBankIndex` or `Algorithm::CreateBank`,
+      /// and is used by `AlgorithmSequence` to find algorithms which may run concurrently
+      enum class BankAccess {
+        /// the bank is only read
+        read,
+        /// the bank may be modified, _e.g._, filtered or transformed
+        modify,
+        /// the bank is created by this algorithm
+        create
+      };
+
       /// @param name the unique name for a derived class instance
       Algorithm(std::string_view name)
           : Object(name)
@@ -105,6 +136,22 @@ namespace iguana {
       /// @see Specialized `%Run` function(s) above/below; they take individual `hipo::bank` objects as parameters, and their documentation explains which banks are used by this algorithm and how.
       virtual bool Run(hipo::banklist& banks) const final;
 
+      /// @brief **Run Function:** Process a batch of events, each with its own `hipo::banklist`
+      ///
+      /// This is equivalent to calling `Algorithm::Run` on each event whose `accepted` value is `true`, but the
+      /// per-call framework overhead is paid once per batch, and algorithms may override the batch hook with a tighter
+      /// loop over the events, _e.g._, to reload run-dependent parameters only when the run number changes.
+      /// @param batch the events' bank lists; each one must have the same layout as the `hipo::banklist` used in `Algorithm::Start`
+      /// @param [in,out] accepted must have the same size as `batch`; events whose value is `false` are skipped, and the
+      /// value for each processed event is set to what `Algorithm::Run` would have returned
+      virtual void RunBatch(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const final;
+
+      /// @brief **Run Function:** Process a batch of events, each with its own `hipo::banklist`
+      /// @see `Algorithm::RunBatch(std::vector<hipo::banklist>&, std::vector<bool>&) const` for details
+      /// @param batch the events' bank lists
+      /// @returns for each event, the value `Algorithm::Run` would have returned
+      std::vector<bool> RunBatch(std::vector<hipo::banklist>& batch) const;
+
       /// @brief **Stop Function:** Finalize this algorithm after all events are processed.
       ///
       /// Call this when you are done with an algorithm.
@@ -167,13 +214,13 @@ namespace iguana {
       template <typename OPTION_TYPE>
       std::set<OPTION_TYPE> GetOptionSet(YAMLReader::node_path_t node_path = {}) const;
 
-      /// Set the name of this algorithm
+      /// Set the name of this algorithm; the name of its configuration is also set, unless it is shared with the original algorithm
       /// @param name the new name
       void SetName(std::string_view name);
 
       /// Get a reference to this algorithm's configuration (`YAMLReader`)
-      /// @returns the configuration
-      std::unique_ptr<YAMLReader> const& GetConfig() const;
+      /// @returns the configuration; it may be shared with replicas of this algorithm (see `Algorithm::Clone`)
+      std::shared_ptr<YAMLReader> const& GetConfig() const;
 
       /// Set a custom `YAMLReader` to use for this algorithm
       /// @param yaml_config the custom `YAMLReader` instance
@@ -192,10 +239,15 @@ namespace iguana {
       /// Get the index of a bank in a `hipo::banklist`; throws an exception if the bank is not found
       /// @param banks the list of banks this algorithm will use
       /// @param bank_name the name of the bank
+      /// @param access how this algorithm uses the bank; algorithms which only read a bank should set this to `BankAccess::read`,
+      /// so that `AlgorithmSequence` may run them concurrently with other readers of the same bank
       /// @returns the `hipo::banklist` index of the bank
       /// @see tools::GetBankIndex for a function that is independent of algorithm
       /// @see GetCreatedBankIndex, a convenience method for _Iguana-created_ banks
-      hipo::banklist::size_type GetBankIndex(hipo::banklist& banks, std::string const& bank_name) const noexcept(false);
+      hipo::banklist::size_type GetBankIndex(
+          hipo::banklist& banks,
+          std::string const& bank_name,
+          BankAccess const access = BankAccess::modify) const noexcept(false);
 
       /// Get the index of an _Iguana-created_ bank in a `hipo::banklist`; throws an exception if the bank is not found, or if the algorithm
       /// creates more than one bank
@@ -231,12 +283,48 @@ namespace iguana {
       /// @see tools::GetBankIndex for details
       unsigned int GetCreatedBankVariant() const;
 
-      /// @returns the RCDB reader instance
-      std::unique_ptr<RCDBReader>& GetRCDBReader();
+      /// @returns the RCDB reader instance; it may be shared with replicas of this algorithm (see `Algorithm::Clone`)
+      std::shared_ptr<RCDBReader>& GetRCDBReader();
+
+      /// @brief Create a started replica of this algorithm, for example, for another thread
+      ///
+      /// The replica has the same name, log level and options as this algorithm. Instead of parsing the configuration files
+      /// and connecting to RCDB again, it shares this algorithm's parsed configuration (`YAMLReader`) and `RCDBReader`,
+      /// which are both thread safe. The replica has its own copy of any per-event and run-dependent state, so this algorithm
+      /// and the replica may `Run` concurrently. This algorithm should already be started, otherwise the replica
+      /// will parse the configuration files itself.
+      /// @param banks the replica's list of banks, which should have the same banks as those used to start this algorithm;
+      /// any banks that the replica creates will be appended
+      /// @returns the started replica
+      std::unique_ptr<Algorithm> Clone(hipo::banklist& banks) const noexcept(false);
+
+      /// @brief Create a started replica of this algorithm, for use without `hipo::banklist`
+      /// @see `Algorithm::Clone(hipo::banklist&)`; this version corresponds to `Algorithm::Start()`
+      /// @returns the started replica
+      std::unique_ptr<Algorithm> Clone() const noexcept(false);
+
+      /// @returns how this algorithm uses each bank, keyed by `hipo::banklist` index; this is filled when `Algorithm::Start` is called
+      std::map<hipo::banklist::size_type, BankAccess> const& GetBankAccess() const;
+
+      /// @brief Enable profiling of this algorithm, and of any algorithms it owns, such as those in an `AlgorithmSequence`
+      ///
+      /// For each algorithm instance, `Algorithm::Run` and `Algorithm::RunBatch` record the number of events, the wall time, the latency
+      /// distribution (per event for `Algorithm::Run`, and per batch for `Algorithm::RunBatch`), the fraction of events for which `true` was
+      /// returned, and the numbers of bank rows in and out; the rows in are those of the banks it reads or modifies, before it runs, and the
+      /// rows out are those of the banks it modifies or creates, after it runs.
+      /// Replicas made by `Algorithm::Clone` share this algorithm's counters. When this algorithm is stopped, a table of the
+      /// profile is printed and, optionally, written to a JSON file. Call this after naming the algorithm, but before `Algorithm::Start`;
+      /// if this is not called, profiling costs one branch per `Run` call.
+      /// @param json_file if not empty, the profile is also written to this JSON file
+      void EnableProfiling(std::string const& json_file = "");
+
+      /// @returns the profile of this algorithm and of any algorithms it owns, merged over all of its replicas, if profiling is enabled
+      /// (see `Algorithm::EnableProfiling`); this must not be called while any replica is running
+      virtual std::vector<ProfileSummary> GetProfileSummaries() const;
 
     protected: // methods
 
-      /// Instantiate the `RCDBReader` instance for this algorithm
+      /// Instantiate the `RCDBReader` instance for this algorithm, unless it already has one, _e.g._, if it is a replica
       void StartRCDBReader();
 
       /// Get the reference to a bank from a `hipo::banklist`; optionally checks if the bank name matches the expectation
@@ -256,17 +344,130 @@ namespace iguana {
           hipo::banklist::size_type& bank_idx,
           std::string const& bank_name) noexcept(false);
 
-      /// Dump all banks in a `hipo::banklist`
+      /// Resolve `BankColumn` handles from a bank in a `hipo::banklist`; call this in `StartHook`. This does nothing if the algorithm was
+      /// started without a `hipo::banklist` (see `Algorithm::Start()`), in which case the handles must be resolved by the `Run` functions
+      /// @param banks the list of banks this algorithm will use
+      /// @param bank_idx the `hipo::banklist` index of the bank
+      /// @param columns the handles to resolve
+      template <typename... COLUMNS>
+      void ResolveBankColumns(hipo::banklist& banks, hipo::banklist::size_type const bank_idx, COLUMNS const&... columns) const noexcept(false)
+      {
+        if(!m_rows_only)
+          ResolveBankColumns(GetBank(banks, bank_idx), columns...);
+      }
+
+      /// Resolve `BankColumn` handles from a bank, unless they are already resolved; call this at the top of `Run` functions which take
+      /// `hipo::bank` parameters
+      /// @param bank the bank
+      /// @param columns the handles to resolve
+      template <typename... COLUMNS>
+      void ResolveBankColumns(hipo::bank const& bank, COLUMNS const&... columns) const noexcept(false)
+      {
+        try {
+          (columns.Resolve(bank), ...);
+        }
+        catch(std::runtime_error const& ex) {
+          m_log->Error("{}", ex.what());
+          throw std::runtime_error("cannot resolve bank columns");
+        }
+      }
+
+      /// Get the inverted index from particle `pindex` to the rows of a detector bank (see `PindexIndex`). Within `Algorithm::Run` or
+      /// `Algorithm::RunBatch`, the index is cached (see `BankIndexCache`), so it is shared with the other algorithms of an `AlgorithmSequence`,
+      /// and is built at most once per event; otherwise, _e.g._, in a `Run` function with `hipo::bank` parameters which is called directly,
+      /// it is rebuilt by each call, and it is only valid until the next call, so call this once per `Run` for each bank.
+      /// @param bank the detector bank, which must have a `pindex` column
+      /// @returns the index, which is valid until the `Run` call returns
+      PindexIndex const& GetPindexIndex(hipo::bank const& bank) const noexcept(false);
+
+      /// Get the membership of a bank's rows in its row list (see `RowListMask`), to test in constant time whether a row passed the
+      /// upstream filters. As with `GetPindexIndex`, the mask is shared with the other algorithms of an `AlgorithmSequence`, and
+      /// outside of `Algorithm::Run` or `Algorithm::RunBatch`, it is rebuilt by each call, so call this once per `Run` for each bank.
+      /// @param bank the bank
+      /// @returns the mask, which is valid until the `Run` call returns
+      RowListMask const& GetRowListMask(hipo::bank const& bank) const;
+
+      /// @brief Filter a bank's row list with a row filter kernel
+      ///
+      /// Rather than calling a function for each row, as `hipo::bank::rowlist::filter` does, the kernel is called once, for all of the
+      /// rows in the row list, and it sets their accept flags (see `row_kernel_t`); the rejected rows are then removed from the row
+      /// list in one step. Kernels should read the columns that they need with `BankColumn::Gather`, so that their loops are over
+      /// contiguous arrays.
+      /// @param bank the bank to filter
+      /// @param kernel the kernel, which may be any callable with the signature of `row_kernel_t`
+      template <typename KERNEL>
+      void FilterRowList(hipo::bank& bank, KERNEL&& kernel) const
+      {
+        thread_local row_mask_t accept; // reused, to avoid reallocation for each event
+        auto const& rows = bank.getRowList();
+        accept.assign(rows.size(), 1);
+        kernel(static_cast<hipo::bank const&>(bank), rows, accept);
+        ApplyRowMask(bank, accept);
+      }
+
+      /// Remove the rejected rows from a bank's row list
+      /// @param bank the bank
+      /// @param accept the accept flags of the rows in the bank's row list
+      static void ApplyRowMask(hipo::bank& bank, row_mask_t const& accept);
+
+      /// Record how this algorithm uses a bank; if it was already recorded, the most permissive access is kept
+      /// @param bank_idx the `hipo::banklist` index of the bank
+      /// @param access how this algorithm uses the bank
+      void RecordBankAccess(hipo::banklist::size_type const bank_idx, BankAccess const access) const;
+
+      /// Dump all banks in a `hipo::banklist`; this is inlined, so that it costs nothing if `level` is not enabled
       /// @param banks the banks to show
-      /// @param message if specified, print a header message
+      /// @param message if specified, print this message first
       /// @param level the log level
-      void ShowBanks(hipo::banklist const& banks, std::string_view message = "", Logger::Level const level = Logger::trace) const;
+      /// @see ShowBanksWithHeader, to print the message as a header, formatted only if `level` is enabled
+      void ShowBanks(hipo::banklist const& banks, std::string_view message = "", Logger::Level const level = Logger::trace) const
+      {
+        if(m_log->IsEnabled(level)) {
+          PrintMessage(message, level);
+          for(auto& bank : banks)
+            bank.show();
+        }
+      }
 
-      /// Dump a single bank
+      /// Dump a single bank; this is inlined, so that it costs nothing if `level` is not enabled
       /// @param bank the bank to show
-      /// @param message if specified, print a header message
+      /// @param message if specified, print this message first
       /// @param level the log level
-      void ShowBank(hipo::bank const& bank, std::string_view message = "", Logger::Level const level = Logger::trace) const;
+      /// @see ShowBankWithHeader, to print the message as a header, formatted only if `level` is enabled
+      void ShowBank(hipo::bank const& bank, std::string_view message = "", Logger::Level const level = Logger::trace) const
+      {
+        if(m_log->IsEnabled(level)) {
+          PrintMessage(message, level);
+          bank.show();
+        }
+      }
+
+      /// Dump all banks in a `hipo::banklist`, after a header; this is inlined, so that it costs nothing if `level` is not enabled,
+      /// whereas `ShowBanks(banks, Logger::Header(header))` would always format the header
+      /// @param banks the banks to show
+      /// @param header print a header with this message, formatted by `Logger::Header`
+      /// @param level the log level
+      void ShowBanksWithHeader(hipo::banklist const& banks, std::string_view header, Logger::Level const level = Logger::trace) const
+      {
+        if(m_log->IsEnabled(level)) {
+          PrintHeader(header, level);
+          for(auto& bank : banks)
+            bank.show();
+        }
+      }
+
+      /// Dump a single bank, after a header; this is inlined, so that it costs nothing if `level` is not enabled,
+      /// whereas `ShowBank(bank, Logger::Header(header))` would always format the header
+      /// @param bank the bank to show
+      /// @param header print a header with this message, formatted by `Logger::Header`
+      /// @param level the log level
+      void ShowBankWithHeader(hipo::bank const& bank, std::string_view header, Logger::Level const level = Logger::trace) const
+      {
+        if(m_log->IsEnabled(level)) {
+          PrintHeader(header, level);
+          bank.show();
+        }
+      }
 
       /// Throw a runtime exception since this algorithm has been renamed.
       /// Guidance will be printed for the user.
@@ -276,6 +477,23 @@ namespace iguana {
 
     private: // methods
 
+      /// Get the index of a bank in a `hipo::banklist`, as `Algorithm::GetBankIndex` does, but without recording how this algorithm
+      /// uses the bank; this is for lookups on behalf of users, such as `AlgorithmSequence::GetBankIndex`, which may be called after `Start`
+      /// @param banks the list of banks this algorithm will use
+      /// @param bank_name the name of the bank
+      /// @returns the `hipo::banklist` index of the bank
+      hipo::banklist::size_type FindBankIndex(hipo::banklist& banks, std::string const& bank_name) const noexcept(false);
+
+      /// Print a message for `ShowBank` and `ShowBanks`
+      /// @param message the message; if empty, nothing is printed
+      /// @param level the log level
+      void PrintMessage(std::string_view message, Logger::Level const level) const;
+
+      /// Print a header for `ShowBankWithHeader` and `ShowBanksWithHeader`
+      /// @param header the header message, formatted by `Logger::Header`
+      /// @param level the log level
+      void PrintHeader(std::string_view header, Logger::Level const level) const;
+
       /// Hook called by user from `Algorithm::Start`, typically to load an algorithm's configuration parameters.
       /// Override this method in algorithm implementations.
       /// It is called before `Algorithm::StartHook`.
@@ -290,13 +508,54 @@ namespace iguana {
       /// Override this method in algorithm implementations.
       virtual bool RunHook(hipo::banklist& banks) const { return true; }
 
+      /// Hook called by user from `Algorithm::RunBatch`; by default, it calls `Algorithm::RunHook` for each accepted event.
+      /// Override this method in algorithm implementations which benefit from looping over many events at once.
+      /// @param batch the events' bank lists
+      /// @param accepted see `Algorithm::RunBatch`
+      virtual void RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const;
+
       /// Hook called by user from `Algorithm::Stop`
       /// Override this method in algorithm implementations.
       virtual void StopHook() {}
 
+      /// @brief Hook for filter algorithms which filter the rows of one bank, so that `AlgorithmSequence` may fuse them
+      ///
+      /// Adjacent algorithms in an `AlgorithmSequence` which filter the same bank are _fused_: their row filter kernels are applied
+      /// in turn to the bank's row list, and the row list is updated once, rather than once per algorithm. An algorithm may only
+      /// override this if its `RunHook` is equivalent to filtering the bank's row list with `Algorithm::MakeRowKernel`, then returning
+      /// `true` if any rows remain.
+      /// @returns the `hipo::banklist` index of the bank that this algorithm filters, or `std::nullopt` if it cannot be fused (default)
+      virtual std::optional<hipo::banklist::size_type> GetRowFilterBank() const { return std::nullopt; }
+
+      /// Hook for filter algorithms which override `Algorithm::GetRowFilterBank`: prepare the event, as `RunHook` would, and make its row filter kernel
+      /// @param banks the event's banks
+      /// @returns the kernel, which is only valid for this event; its callable is made with `ScratchArena::Make`, so that making it
+      /// does not allocate, and it must be applied within the `ScratchArena::Scope` in which it was made
+      virtual row_kernel_t MakeRowKernel(hipo::banklist& banks) const noexcept(false);
+
       /// Parse YAML configuration files. Sets `m_yaml_config`.
       void ParseYAMLConfig();
 
+      /// Create an un-started replica of this algorithm, which shares this algorithm's configuration and `RCDBReader`;
+      /// algorithms which own other algorithms, such as `AlgorithmSequence`, override this to replicate them too
+      /// @returns the replica
+      virtual std::unique_ptr<Algorithm> CreateReplica() const noexcept(false);
+
+      /// Create the profilers for this algorithm, and for any algorithms it owns
+      virtual void CreateProfilers();
+
+      /// `Algorithm::Run`, with profiling
+      bool RunProfiled(hipo::banklist& banks) const;
+
+      /// `Algorithm::RunBatch`, with profiling
+      void RunBatchProfiled(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const;
+
+      /// Count the bank rows used by this algorithm, for profiling
+      /// @param banks the banks
+      /// @param input if true, count the rows of read or modified banks, otherwise count the rows of modified or created banks
+      /// @returns the number of rows
+      unsigned long long CountRows(hipo::banklist& banks, bool const input) const;
+
       /// Get an option from the option cache
       /// @param key the key name associated with this option
       /// @returns the option value, if found (using `std::optional`)
@@ -337,16 +596,32 @@ namespace iguana {
       /// instances that are configured differently
       unsigned int m_created_bank_variant{0};
 
-      /// RCDB reader
-      std::unique_ptr<RCDBReader> m_rcdb;
+      /// RCDB reader, which may be shared with replicas of this algorithm
+      std::shared_ptr<RCDBReader> m_rcdb;
 
     private: // members
 
-      /// YAML reader
-      std::unique_ptr<YAMLReader> m_yaml_config;
+      /// YAML reader, which may be shared with replicas of this algorithm
+      std::shared_ptr<YAMLReader> m_yaml_config;
+
+      /// True if this algorithm is a replica, which shares `m_yaml_config` with the original; the replica must not modify it,
+      /// since the original and its other replicas may use it concurrently
+      bool m_yaml_config_shared{false};
 
       /// Data structure to hold configuration options set by `Algorithm::SetOption`
       std::unordered_map<std::string, option_t> m_option_cache;
+
+      /// How this algorithm uses each bank, keyed by `hipo::banklist` index
+      mutable std::map<hipo::banklist::size_type, BankAccess> m_bank_access;
+
+      /// Profiler, which is shared with replicas of this algorithm; null if profiling is disabled
+      std::shared_ptr<Profiler> m_profiler;
+
+      /// If true, this algorithm reports its profile when stopped; algorithms owned by a sequence, and replicas, do not
+      bool m_profile_report{false};
+
+      /// JSON file for the profile report, if not empty
+      std::string m_profile_json;
   };
 
   //////////////////////////////////////////////////////////////////////////////
@@ -4,25 +4,380 @@ namespace iguana {
 
   REGISTER_IGUANA_ALGORITHM(AlgorithmSequence);
 
+  namespace {
+    /// the events from which a sequence reads banks lazily, for the duration of its lazy `Run` or `RunBatch` call
+    struct lazy_source_t
+    {
+        AlgorithmSequence const* seq;
+        std::vector<hipo::event*> const* events;
+    };
+    thread_local lazy_source_t const* t_lazy_source = nullptr;
+
+    /// sets `t_lazy_source` while in scope
+    class LazySourceScope
+    {
+      public:
+        LazySourceScope(lazy_source_t const& source)
+            : m_prev_source(t_lazy_source)
+        {
+          t_lazy_source = &source;
+        }
+        ~LazySourceScope() { t_lazy_source = m_prev_source; }
+
+      private:
+        lazy_source_t const* m_prev_source;
+    };
+
+    /// read some banks from an event
+    void ReadBanks(hipo::event& event, hipo::banklist& banks, std::vector<hipo::banklist::size_type> const& bank_indices)
+    {
+      for(auto const& bank_idx : bank_indices)
+        event.read(banks[bank_idx]);
+    }
+  }
+
   void AlgorithmSequence::StartHook(hipo::banklist& banks)
   {
     for(auto const& algo : m_sequence)
       algo->Start(banks);
+    BuildSchedule();
+    if(m_num_threads > 1 && m_schedule.size() < m_sequence.size())
+      m_task_pool = std::make_unique<TaskPool>(m_num_threads - 1, m_name + "|task_pool");
+    else
+      m_task_pool.reset();
+    BuildStages();
+    PlanLazyReading(banks);
   }
 
   bool AlgorithmSequence::RunHook(hipo::banklist& banks) const
   {
-    for(auto const& algo : m_sequence) {
-      if(!algo->Run(banks))
-        return false;
+    // if reading lazily, read the banks as they are needed
+    auto const lazy_events = GetLazyEvents();
+    auto const event       = lazy_events != nullptr ? lazy_events->front() : nullptr;
+
+    // share bank indices among the algorithms; `Algorithm::Run` made a cache active, which the tasks make active on their threads
+    BankIndexCache::Scope const index_scope;
+    auto& index_cache = *BankIndexCache::GetActive();
+
+    if(!m_task_pool) {
+      for(auto const& stage : m_stages) {
+        if(event != nullptr) {
+          for(auto i = stage.first; i < stage.last; i++)
+            ReadBanks(*event, banks, m_lazy_read_steps[i]);
+        }
+        if(!RunStage(stage, banks))
+          return false;
+      }
     }
+    else {
+      // run each level's algorithms concurrently; once one rejects the event, the level's algorithms which have not yet started are skipped
+      for(decltype(m_schedule.size()) l = 0; l < m_schedule.size(); l++) {
+        auto const& level = m_schedule[l];
+        if(event != nullptr)
+          ReadBanks(*event, banks, m_lazy_read_steps[l]);
+        auto const level_accepted = m_task_pool->RunEach(level.size(), [this, &banks, &level, &index_cache](std::size_t const i) {
+          BankIndexCache::Scope const task_index_scope(index_cache);
+          return m_sequence[level[i]]->Run(banks);
+        });
+        if(!level_accepted)
+          return false;
+      }
+    }
+
+    if(event != nullptr)
+      ReadBanks(*event, banks, m_lazy_read_on_accept);
     return true;
   }
 
+  void AlgorithmSequence::RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const
+  {
+    // if reading lazily, read the banks as they are needed, for the events which have not been rejected
+    auto const lazy_events = GetLazyEvents();
+    auto read_step         = [&batch, &accepted, lazy_events](std::vector<hipo::banklist::size_type> const& bank_indices) {
+      if(lazy_events == nullptr)
+        return;
+      for(decltype(batch.size()) e = 0; e < batch.size(); e++) {
+        if(accepted[e])
+          ReadBanks(*(*lazy_events)[e], batch[e], bank_indices);
+      }
+    };
+
+    // share bank indices among the algorithms; `Algorithm::RunBatch` made a cache active, which the tasks make active on their threads
+    BankIndexCache::Scope const index_scope;
+    auto& index_cache = *BankIndexCache::GetActive();
+
+    if(!m_task_pool) {
+      for(auto const& stage : m_stages) {
+        for(auto i = stage.first; i < stage.last; i++)
+          read_step(m_lazy_read_steps[i]);
+        if(stage.fused_bank_idx.has_value()) {
+          for(decltype(batch.size()) e = 0; e < batch.size(); e++) {
+            if(accepted[e])
+              accepted[e] = RunStage(stage, batch[e]);
+          }
+        }
+        else
+          m_sequence[stage.first]->RunBatch(batch, accepted);
+      }
+    }
+    else {
+      // run each level's algorithms concurrently, each with its own copy of the accepted flags, then combine them;
+      // the copies are reused by each batch, and once every event is rejected, the level's algorithms which have not yet started are skipped
+      thread_local std::vector<std::vector<bool>> t_level_accepted;
+      auto& level_accepted = t_level_accepted; // the tasks run on other threads, so they must not name `t_level_accepted`
+      for(decltype(m_schedule.size()) l = 0; l < m_schedule.size(); l++) {
+        auto const& level = m_schedule[l];
+        read_step(m_lazy_read_steps[l]);
+        if(level_accepted.size() < level.size())
+          level_accepted.resize(level.size());
+        for(decltype(level.size()) i = 0; i < level.size(); i++)
+          level_accepted[i] = accepted;
+        m_task_pool->RunEach(level.size(), [this, &batch, &level, &level_accepted, &index_cache](std::size_t const i) {
+          BankIndexCache::Scope const task_index_scope(index_cache);
+          auto& algo_accepted = level_accepted[i];
+          m_sequence[level[i]]->RunBatch(batch, algo_accepted);
+          return std::find(algo_accepted.begin(), algo_accepted.end(), true) != algo_accepted.end();
+        });
+        for(decltype(level.size()) i = 0; i < level.size(); i++) {
+          for(decltype(accepted.size()) e = 0; e < accepted.size(); e++)
+            accepted[e] = accepted[e] && level_accepted[i][e];
+        }
+        if(std::find(accepted.begin(), accepted.end(), true) == accepted.end())
+          break;
+      }
+    }
+
+    read_step(m_lazy_read_on_accept);
+  }
+
+  bool AlgorithmSequence::RunStage(stage_t const& stage, hipo::banklist& banks) const
+  {
+    if(!stage.fused_bank_idx.has_value())
+      return m_sequence[stage.first]->Run(banks);
+    // make each algorithm's row filter kernel for this event, then apply them all to the same accept flags, so that the row list is updated once;
+    // as in `Algorithm::Run`, each algorithm has a `Tracer` span, here one for making its kernel and one for applying it, and the kernels'
+    // scratch memory, which holds the kernels and their list, is released at the end of the stage, rather than at the end of each algorithm,
+    // since the kernels are applied together; once the arena has grown, a stage makes no heap allocations
+    Tracer::Span span(m_name, "RunFused");
+    ScratchArena::Scope const scratch_scope;
+    std::pmr::vector<row_kernel_t> kernels(&ScratchArena::Get());
+    kernels.reserve(stage.last - stage.first);
+    for(auto i = stage.first; i < stage.last; i++) {
+      Tracer::Span algo_span(m_sequence[i]->m_name, "MakeRowKernel");
+      kernels.push_back(m_sequence[i]->MakeRowKernel(banks));
+    }
+    auto& bank = GetBank(banks, stage.fused_bank_idx.value());
+    FilterRowList(bank, [this, &stage, &kernels](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      for(decltype(kernels.size()) k = 0; k < kernels.size(); k++) {
+        Tracer::Span algo_span(m_sequence[stage.first + k]->m_name, "RowKernel");
+        kernels[k](bank, rows, accept);
+      }
+    });
+    return !bank.getRowList().empty();
+  }
+
+  bool AlgorithmSequence::Run(hipo::banklist& banks, hipo::event& event) const
+  {
+    // clear the banks, so that those which are not read do not hold a previous event
+    for(auto const& bank_idx : m_lazy_banks)
+      banks[bank_idx].reset();
+    std::vector<hipo::event*> const events = {&event};
+    lazy_source_t const source{this, &events};
+    LazySourceScope const scope(source);
+    return Run(banks);
+  }
+
+  void AlgorithmSequence::RunBatch(std::vector<hipo::banklist>& batch, std::vector<hipo::event*> const& events, std::vector<bool>& accepted) const
+  {
+    if(events.size() != batch.size()) {
+      m_log->Error("RunBatch called with {} events, but {} bank lists", events.size(), batch.size());
+      throw std::runtime_error("RunBatch failed");
+    }
+    // clear the banks, so that those which are not read do not hold a previous event
+    for(auto& banks : batch) {
+      for(auto const& bank_idx : m_lazy_banks)
+        banks[bank_idx].reset();
+    }
+    lazy_source_t const source{this, &events};
+    LazySourceScope const scope(source);
+    RunBatch(batch, accepted);
+  }
+
+  std::vector<hipo::event*> const* AlgorithmSequence::GetLazyEvents() const
+  {
+    // only the sequence which set the lazy source reads from it; a sequence within this one runs on banks which are already read
+    if(t_lazy_source != nullptr && t_lazy_source->seq == this)
+      return t_lazy_source->events;
+    return nullptr;
+  }
+
   void AlgorithmSequence::StopHook()
   {
     for(auto const& algo : m_sequence)
       algo->Stop();
+    m_task_pool.reset();
+  }
+
+  void AlgorithmSequence::BuildSchedule()
+  {
+    m_schedule.clear();
+    std::vector<decltype(m_schedule)::size_type> algo_levels;
+    for(decltype(m_sequence)::size_type i = 0; i < m_sequence.size(); i++) {
+      // an algorithm must run after every earlier algorithm it conflicts with
+      decltype(m_schedule)::size_type level = 0;
+      for(decltype(m_sequence)::size_type j = 0; j < i; j++) {
+        if(HasBankConflict(*m_sequence[i], *m_sequence[j]))
+          level = std::max(level, algo_levels[j] + 1);
+      }
+      algo_levels.push_back(level);
+      if(m_schedule.size() <= level)
+        m_schedule.resize(level + 1);
+      m_schedule[level].push_back(i);
+    }
+    // this sequence uses all of its algorithms' banks, in case it is itself part of a sequence
+    for(auto const& algo : m_sequence) {
+      for(auto const& [bank_idx, access] : algo->GetBankAccess())
+        RecordBankAccess(bank_idx, access);
+    }
+    // print the schedule
+    m_log->Debug("algorithm schedule:");
+    for(decltype(m_schedule)::size_type level = 0; level < m_schedule.size(); level++) {
+      std::vector<std::string> level_names;
+      for(auto const& i : m_schedule[level])
+        level_names.push_back(m_sequence[i]->GetName());
+      m_log->Debug(" - level {}: [{}]", level, fmt::join(level_names, ", "));
+    }
+  }
+
+  void AlgorithmSequence::BuildStages()
+  {
+    m_stages.clear();
+    // filters are not fused if they are profiled, so that each algorithm has its own profile, nor if any of them prints debugging information
+    auto row_filter_bank = [this](algo_t const& algo) -> std::optional<hipo::banklist::size_type> {
+      if(m_profiler || algo->m_profiler || algo->GetLog()->IsEnabled(Logger::debug))
+        return std::nullopt;
+      return algo->GetRowFilterBank();
+    };
+    for(decltype(m_sequence)::size_type first = 0; first < m_sequence.size();) {
+      auto bank_idx = row_filter_bank(m_sequence[first]);
+      auto last     = first + 1;
+      if(bank_idx.has_value()) {
+        while(last < m_sequence.size() && row_filter_bank(m_sequence[last]) == bank_idx)
+          last++;
+      }
+      m_stages.push_back({first, last, last - first > 1 ? bank_idx : std::nullopt});
+      if(last - first > 1) {
+        std::vector<std::string> fused_names;
+        for(auto i = first; i < last; i++)
+          fused_names.push_back(m_sequence[i]->GetName());
+        m_log->Debug("fused filters: [{}]", fmt::join(fused_names, ", "));
+      }
+      first = last;
+    }
+  }
+
+  void AlgorithmSequence::PlanLazyReading(hipo::banklist& banks)
+  {
+    m_lazy_banks.clear();
+    m_lazy_read_steps.clear();
+    m_lazy_read_on_accept.clear();
+    // banks which can be read from an event: those which are not created by an algorithm
+    std::set<hipo::banklist::size_type> unread_banks;
+    for(decltype(banks.size()) bank_idx = 0; bank_idx < banks.size(); bank_idx++) {
+      if(!AlgorithmFactory::GetCreatorAlgorithms(banks[bank_idx].getSchema().getName()).has_value()) {
+        m_lazy_banks.push_back(bank_idx);
+        unread_banks.insert(bank_idx);
+      }
+    }
+    // each step reads the banks which its algorithms use, and which no earlier step has read
+    auto plan_step = [this, &unread_banks](std::vector<decltype(m_sequence)::size_type> const& algo_indices) {
+      auto& step = m_lazy_read_steps.emplace_back();
+      for(auto const& i : algo_indices) {
+        for(auto const& [bank_idx, access] : m_sequence[i]->GetBankAccess()) {
+          if(unread_banks.erase(bank_idx) > 0)
+            step.push_back(bank_idx);
+        }
+      }
+    };
+    if(m_task_pool) {
+      for(auto const& level : m_schedule)
+        plan_step(level);
+    }
+    else {
+      for(decltype(m_sequence)::size_type i = 0; i < m_sequence.size(); i++)
+        plan_step({i});
+    }
+    m_lazy_read_on_accept.assign(unread_banks.begin(), unread_banks.end());
+    // print the plan
+    if(m_log->IsEnabled(Logger::debug)) {
+      auto bank_names = [&banks](std::vector<hipo::banklist::size_type> const& bank_indices) {
+        std::vector<std::string> names;
+        for(auto const& bank_idx : bank_indices)
+          names.push_back(banks[bank_idx].getSchema().getName());
+        return names;
+      };
+      m_log->Debug("lazy bank reading plan:");
+      for(decltype(m_lazy_read_steps.size()) step = 0; step < m_lazy_read_steps.size(); step++)
+        m_log->Debug(" - {} {}: [{}]", m_task_pool ? "level" : "algorithm", step, fmt::join(bank_names(m_lazy_read_steps[step]), ", "));
+      m_log->Debug(" - if accepted: [{}]", fmt::join(bank_names(m_lazy_read_on_accept), ", "));
+    }
+  }
+
+  bool AlgorithmSequence::HasBankConflict(Algorithm const& algo_a, Algorithm const& algo_b)
+  {
+    auto const& access_b = algo_b.GetBankAccess();
+    for(auto const& [bank_idx, access_a] : algo_a.GetBankAccess()) {
+      if(auto it{access_b.find(bank_idx)}; it != access_b.end()) {
+        if(access_a != BankAccess::read || it->second != BankAccess::read)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  std::unique_ptr<Algorithm> AlgorithmSequence::CreateReplica() const noexcept(false)
+  {
+    auto replica = std::make_unique<AlgorithmSequence>(m_name);
+    replica->Object::SetLogLevel(m_log->GetLevel());
+    replica->m_option_cache       = m_option_cache;
+    replica->m_yaml_config        = m_yaml_config;
+    replica->m_yaml_config_shared = m_yaml_config != nullptr;
+    replica->m_num_threads        = m_num_threads;
+    replica->m_profiler           = m_profiler;
+    // replicate each algorithm, in sequence order, and `Add` it with its original instance name
+    std::vector<std::string> algo_instance_names(m_sequence.size());
+    for(auto const& [algo_instance_name, idx] : m_algo_names)
+      algo_instance_names[idx] = algo_instance_name;
+    for(decltype(m_sequence)::size_type i = 0; i < m_sequence.size(); i++) {
+      auto algo = m_sequence[i]->CreateReplica();
+      algo->SetName(algo_instance_names[i]);
+      replica->Add(std::move(algo));
+    }
+    return replica;
+  }
+
+  void AlgorithmSequence::CreateProfilers()
+  {
+    Algorithm::CreateProfilers();
+    for(auto const& algo : m_sequence)
+      algo->CreateProfilers();
+  }
+
+  std::vector<ProfileSummary> AlgorithmSequence::GetProfileSummaries() const
+  {
+    std::vector<ProfileSummary> summaries;
+    for(auto const& algo : m_sequence) {
+      auto algo_summaries = algo->GetProfileSummaries();
+      summaries.insert(summaries.end(), algo_summaries.begin(), algo_summaries.end());
+    }
+    auto seq_summaries = Algorithm::GetProfileSummaries();
+    summaries.insert(summaries.end(), seq_summaries.begin(), seq_summaries.end());
+    return summaries;
+  }
+
+  void AlgorithmSequence::SetNumThreads(unsigned int const num_threads)
+  {
+    m_num_threads = num_threads;
   }
 
   void AlgorithmSequence::Add(std::string const& algo_class_name, std::string const& algo_instance_name)
@@ -112,7 +467,7 @@ namespace iguana {
       std::string const& algo_instance_name) const noexcept(false)
   {
     if(auto it{m_algo_names.find(algo_instance_name)}; it != m_algo_names.end())
-      return m_sequence.at(it->second)->GetBankIndex(banks, bank_name);
+      return m_sequence.at(it->second)->FindBankIndex(banks, bank_name);
     m_log->Error("cannot find algorithm '{}' in sequence", algo_instance_name);
     throw std::runtime_error("cannot Get algorithm");
   }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <hipo4/event.h>
+
 #include "Algorithm.h"
+#include "iguana/services/TaskPool.h"
 
 namespace iguana {
 
@@ -42,6 +45,54 @@ namespace iguana {
   /// if(!seq2.Run(banks)) continue;
   /// @endcode
   ///
+  /// @par Batches of Events
+  /// `AlgorithmSequence::RunBatch` runs each algorithm over the whole batch before moving on to the next algorithm; events
+  /// which are rejected by an algorithm are skipped by the algorithms which follow it.
+  ///
+  /// @par Profiling
+  /// `Algorithm::EnableProfiling` enables profiling for the sequence and for each of its algorithms; when the sequence is stopped,
+  /// the table it prints has one row for each algorithm, followed by one for the whole sequence.
+  ///
+  /// @par Concurrent Algorithms
+  /// By default, the algorithms run one at a time, in order. If `AlgorithmSequence::SetNumThreads` is used to set more than one thread,
+  /// algorithms which do not depend on each other will instead run concurrently, within each event. Dependencies are found
+  /// from the banks each algorithm reads, modifies and creates (see `Algorithm::BankAccess`): two algorithms are independent if
+  /// neither one modifies or creates a bank that the other one uses. The algorithms are grouped into _levels_, where each
+  /// level only depends on earlier levels, and the levels run in order. This is only beneficial for expensive algorithms; if you
+  /// are already processing events in parallel, _e.g._, with `EventProcessor`, you do not need it.
+  ///
+  /// If any algorithm's `Run` function returns `false`, the sequence's `Run` function returns `false` once its level is finished;
+  /// in that case, algorithms in the same level may have run even if they come later in the sequence.
+  ///
+  /// @par Fused Filters
+  /// When running serially, adjacent filter algorithms which filter the same bank, such as `clas12::EventBuilderFilter` followed by
+  /// `clas12::ZVertexFilter` on `REC::Particle`, are _fused_: their row filter kernels are applied in turn to the bank's row list, each one
+  /// skipping the rows which an earlier one rejected, and the row list is updated once (see `Algorithm::GetRowFilterBank`). The result is the
+  /// same as running them one at a time. Filters are not fused if profiling is enabled, so that each algorithm is profiled separately, nor if any of them has a log level of
+  /// `debug` or lower, so that their printouts are not skipped. Fused algorithms keep their own `Tracer` spans, named `MakeRowKernel` and
+  /// `RowKernel` rather than `Run`, and their scratch memory (see `ScratchArena`) is released when the whole fused stage is done.
+  ///
+  /// @par Shared Bank Indices
+  /// Algorithms which associate particles with detector banks, such as `clas12::TrajLinker` and `clas12::rga::FiducialFilterPass2`,
+  /// look up the detector rows of each particle with a `PindexIndex` (see `Algorithm::GetPindexIndex`), and creator algorithms, such as
+  /// `physics::SingleHadronKinematics`, test whether rows passed the upstream filters with a `RowListMask` (see `Algorithm::GetRowListMask`).
+  /// The sequence shares these indices among its algorithms, so that each bank is indexed at most once per event.
+  ///
+  /// @par Lazy Bank Reading
+  /// Reading (deserializing) banks is often more expensive than the algorithms themselves, and it is wasted for events which
+  /// are rejected by an early filter algorithm. Instead of reading all of an event's banks before calling `Run`, you may pass
+  /// the `hipo::event` itself to `AlgorithmSequence::Run(hipo::banklist&, hipo::event&) const` (or to the corresponding `RunBatch`),
+  /// which reads each bank just before the first algorithm that uses it. If the event is accepted, the banks which no algorithm uses are
+  /// read at the end, so all of the banks are available to you; if it is rejected, the banks which were not read yet are left empty.
+  /// @code
+  /// hipo::event event;
+  /// while(reader.next()) {
+  ///   reader.read(event);
+  ///   if(!seq.Run(banks, event)) continue;
+  ///   // ... all of `banks` have been read ...
+  /// }
+  /// @endcode
+  ///
   class AlgorithmSequence : public Algorithm
   {
 
@@ -50,10 +101,32 @@ namespace iguana {
     private: // hooks
       void StartHook(hipo::banklist& banks) override;
       bool RunHook(hipo::banklist& banks) const override;
+      void RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const override;
       void StopHook() override;
 
     public:
 
+      using Algorithm::RunBatch;
+
+      /// @brief Run the sequence on an event, reading its banks lazily
+      ///
+      /// Each bank is read from `event` just before the first algorithm which uses it is run; if the event is accepted, the remaining
+      /// banks are read at the end, otherwise they are left empty. Banks which are created by algorithms are never read.
+      /// @see the "Lazy Bank Reading" section of this class's documentation
+      /// @param banks the banks, which do not need to be read from `event` beforehand
+      /// @param event the event from which the banks are read
+      /// @returns the return value of `Algorithm::Run`
+      bool Run(hipo::banklist& banks, hipo::event& event) const;
+
+      /// @brief Run the sequence on a batch of events, reading their banks lazily
+      ///
+      /// This is the batch version of `AlgorithmSequence::Run(hipo::banklist&, hipo::event&) const`; banks are only read for events
+      /// which have not been rejected yet.
+      /// @param batch the banks of each event
+      /// @param events the event from which each element of `batch` is read
+      /// @param accepted the accepted flag of each event, as in `Algorithm::RunBatch`
+      void RunBatch(std::vector<hipo::banklist>& batch, std::vector<hipo::event*> const& events, std::vector<bool>& accepted) const;
+
       /// Create and add an algorithm to the sequence, by name.
       ///
       /// **Example**
@@ -172,7 +245,18 @@ namespace iguana {
       /// @param func the function to call for each algorithm `algo`
       void ForEachAlgorithm(std::function<void(algo_t&)> func);
 
-      /// Get the index of a bank in a `hipo::banklist`; throws an exception if the bank is not found
+      /// @brief Set the number of threads used to run independent algorithms concurrently within an event
+      ///
+      /// This must be called before `Start`.
+      /// @param num_threads the number of threads, including the thread which calls `Run`; if 0 or 1, the algorithms run serially (default)
+      void SetNumThreads(unsigned int const num_threads);
+
+      /// @returns the profile of each algorithm in the sequence, followed by that of the whole sequence
+      /// @see `Algorithm::EnableProfiling`
+      std::vector<ProfileSummary> GetProfileSummaries() const override;
+
+      /// Get the index of a bank in a `hipo::banklist`; throws an exception if the bank is not found. This only looks up the index,
+      /// so it may be called after `Start` without changing how the sequence schedules its algorithms.
       /// @param banks the list of banks this algorithm will use
       /// @param bank_name the name of the bank
       /// @param algo_instance_name the algorithm instance name,
@@ -198,10 +282,74 @@ namespace iguana {
 
     private:
 
+      /// Replicate this sequence, along with each of its algorithms
+      /// @see `Algorithm::Clone`
+      /// @returns the un-started replica
+      std::unique_ptr<Algorithm> CreateReplica() const noexcept(false) override;
+
+      /// Create the profilers for this sequence and for each of its algorithms
+      void CreateProfilers() override;
+
+      /// Group the algorithms into levels of mutually independent algorithms; sets `m_schedule`
+      void BuildSchedule();
+
+      /// @returns true if `algo_a` and `algo_b` use a common bank, and at least one of them modifies or creates it
+      static bool HasBankConflict(Algorithm const& algo_a, Algorithm const& algo_b);
+
+      /// @brief A range of algorithms in the sequence, run serially as one step
+      ///
+      /// A stage is either one algorithm, or adjacent filter algorithms which are fused
+      struct stage_t
+      {
+          /// index of the first algorithm
+          std::vector<algo_t>::size_type first;
+          /// index after the last algorithm
+          std::vector<algo_t>::size_type last;
+          /// the `hipo::banklist` index of the bank filtered by the fused algorithms, if they are fused
+          std::optional<hipo::banklist::size_type> fused_bank_idx;
+      };
+
+      /// Group adjacent filter algorithms of the same bank into fused stages; sets `m_stages`
+      void BuildStages();
+
+      /// Run a stage on an event
+      /// @param stage the stage
+      /// @param banks the event's banks
+      /// @returns the stage's event-level filter result
+      bool RunStage(stage_t const& stage, hipo::banklist& banks) const;
+
+      /// Plan which banks lazy reading reads, and when; sets the `m_lazy_*` members, and must be called after `BuildSchedule`
+      /// @param banks the banks this sequence uses
+      void PlanLazyReading(hipo::banklist& banks);
+
+      /// @returns the events from which the current `Run` or `RunBatch` call reads banks lazily, or null if it does not
+      std::vector<hipo::event*> const* GetLazyEvents() const;
+
       /// The sequence of algorithms
       std::vector<algo_t> m_sequence;
 
       /// Association of algorithm name to its index in the sequence
       std::unordered_map<std::string, std::vector<algo_t>::size_type> m_algo_names;
+
+      /// Levels of mutually independent algorithms, as indices of `m_sequence`
+      std::vector<std::vector<std::vector<algo_t>::size_type>> m_schedule;
+
+      /// Number of threads used to run independent algorithms concurrently
+      unsigned int m_num_threads{1};
+
+      /// Task pool for running independent algorithms concurrently; null if running serially
+      std::unique_ptr<TaskPool> m_task_pool;
+
+      /// Stages for running serially; algorithms in the same stage are fused
+      std::vector<stage_t> m_stages;
+
+      /// Banks which lazy reading reads from an event, _i.e._, those which are not created by an algorithm
+      std::vector<hipo::banklist::size_type> m_lazy_banks;
+
+      /// For lazy reading, the banks to read before each step: a step is an algorithm if running serially, or a level of `m_schedule` otherwise
+      std::vector<std::vector<hipo::banklist::size_type>> m_lazy_read_steps;
+
+      /// For lazy reading, the banks to read once an event is accepted, since no algorithm uses them
+      std::vector<hipo::banklist::size_type> m_lazy_read_on_accept;
   };
 }
@@ -0,0 +1,205 @@
+/// @file
+/// @brief typed handles for fast access to bank columns, and fills of bank columns
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <hipo4/bank.h>
+
+namespace iguana {
+
+  /// @brief Handle for fast, typed access to one column of a bank
+  ///
+  /// Accessing a bank column by name, _e.g._, `bank.getFloat("px", row)`, looks up the name in the bank's schema for every
+  /// call. A `BankColumn` looks it up once, when it is resolved, so that each access is an indexed load. Algorithms should
+  /// hold one handle per column that they use in hot loops, and resolve them with `Algorithm::ResolveBankColumns`:
+  /// - in `StartHook`, from the `hipo::banklist`, so that a missing column is reported early
+  /// - at the top of each `Run` function which takes `hipo::bank` parameters, for the case where the algorithm was started
+  ///   without a `hipo::banklist`; this does nothing if the handles are already resolved
+  ///
+  /// A handle assumes that the layout of its bank does not change once it is resolved.
+  /// @tparam T the column type, which must match the column's type in the bank's schema: `int8_t`, `int16_t`, `int32_t`, `int64_t`, `float` or `double`
+  template <typename T>
+  class BankColumn
+  {
+      static_assert(
+          std::is_same_v<T, int8_t> ||
+              std::is_same_v<T, int16_t> ||
+              std::is_same_v<T, int32_t> ||
+              std::is_same_v<T, int64_t> ||
+              std::is_same_v<T, float> ||
+              std::is_same_v<T, double>,
+          "unsupported bank column type");
+
+    public:
+
+      /// @param column_name the column name, which must have static storage duration, _e.g._, a string literal
+      BankColumn(char const* column_name)
+          : m_column_name(column_name)
+      {}
+
+      BankColumn(BankColumn const&)            = delete;
+      BankColumn& operator=(BankColumn const&) = delete;
+
+      /// Resolve this handle from a bank's schema, if it is not already resolved; this is thread safe. Throws an exception if
+      /// the bank has no such column, or if the column's type is not `T`.
+      /// @param bank the bank
+      void Resolve(hipo::bank const& bank) const noexcept(false)
+      {
+        if(IsResolved())
+          return;
+        auto& schema = const_cast<hipo::bank&>(bank).getSchema();
+        if(!schema.exists(m_column_name))
+          throw std::runtime_error(fmt::format("bank {:?} has no column {:?}", schema.getName(), m_column_name));
+        auto const item = schema.getEntryOrder(m_column_name);
+        if(schema.getEntryType(item) != hipo_type)
+          throw std::runtime_error(fmt::format("column {:?} of bank {:?} has hipo type {}, but its handle has type {}", m_column_name, schema.getName(), schema.getEntryType(item), hipo_type));
+        m_index.store(item, std::memory_order_relaxed);
+      }
+
+      /// @returns true if this handle has been resolved
+      bool IsResolved() const
+      {
+        return m_index.load(std::memory_order_relaxed) >= 0;
+      }
+
+      /// @returns the column name
+      char const* GetName() const
+      {
+        return m_column_name;
+      }
+
+      /// Get a value from the bank
+      /// @param bank the bank
+      /// @param row the bank row
+      /// @returns the value
+      T Get(hipo::bank const& bank, int const row) const
+      {
+        return Read(bank, m_index.load(std::memory_order_relaxed), row);
+      }
+
+      /// Get the values of a list of rows from the bank, _e.g._, for a row filter kernel (see `Algorithm::FilterRowList`)
+      /// @param bank the bank
+      /// @param rows the bank rows
+      /// @param values set to the values, in the order of `rows`
+      void Gather(hipo::bank const& bank, std::vector<int> const& rows, std::vector<T>& values) const
+      {
+        auto const item = m_index.load(std::memory_order_relaxed);
+        values.resize(rows.size());
+        for(decltype(rows.size()) i = 0; i < rows.size(); i++)
+          values[i] = Read(bank, item, rows[i]);
+      }
+
+      /// Set a value in the bank
+      /// @param bank the bank
+      /// @param row the bank row
+      /// @param val the value
+      void Put(hipo::bank& bank, int const row, T const val) const
+      {
+        auto const item = m_index.load(std::memory_order_relaxed);
+        if constexpr(std::is_same_v<T, int8_t>)
+          bank.putByte(item, row, val);
+        else if constexpr(std::is_same_v<T, int16_t>)
+          bank.putShort(item, row, val);
+        else if constexpr(std::is_same_v<T, int32_t>)
+          bank.putInt(item, row, val);
+        else if constexpr(std::is_same_v<T, int64_t>)
+          bank.putLong(item, row, val);
+        else if constexpr(std::is_same_v<T, float>)
+          bank.putFloat(item, row, val);
+        else
+          bank.putDouble(item, row, val);
+      }
+
+    private:
+
+      /// the hipo type of a column which this handle may access, _e.g._, `hipo::kFloat`
+      static int constexpr hipo_type =
+          std::is_same_v<T, int8_t>    ? hipo::kByte
+          : std::is_same_v<T, int16_t> ? hipo::kShort
+          : std::is_same_v<T, int32_t> ? hipo::kInt
+          : std::is_same_v<T, int64_t> ? hipo::kLong
+          : std::is_same_v<T, float>   ? hipo::kFloat
+                                       : hipo::kDouble;
+
+      /// @returns the value of column `item` in a row of the bank
+      static T Read(hipo::bank const& bank, int const item, int const row)
+      {
+        if constexpr(std::is_same_v<T, int8_t>)
+          return bank.getByte(item, row);
+        else if constexpr(std::is_same_v<T, int16_t>)
+          return bank.getShort(item, row);
+        else if constexpr(std::is_same_v<T, int32_t>)
+          return bank.getInt(item, row);
+        else if constexpr(std::is_same_v<T, int64_t>)
+          return bank.getLong(item, row);
+        else if constexpr(std::is_same_v<T, float>)
+          return bank.getFloat(item, row);
+        else
+          return bank.getDouble(item, row);
+      }
+
+      /// the column name
+      char const* m_column_name;
+
+      /// the column index in the schema, or -1 if not yet resolved; it is atomic, since `Run` functions may resolve it concurrently
+      mutable std::atomic<int> m_index{-1};
+  };
+
+
+  /// @brief Fill a range of rows of some bank columns with the same value
+  ///
+  /// Bank data are stored column by column, so a column's range of rows is contiguous; each column's range is written with
+  /// one `memset` when the value converts to zero, otherwise with a loop of stores, rather than one `put` call per cell.
+  /// Creator algorithms use this function to zero the rows of a created bank which do not get computed values.
+  /// @param bank the bank
+  /// @param columns the columns to fill, as pairs of column index and type, from `hipo::schema::getEntryOrder` and `hipo::schema::getEntryType`
+  /// @param first_row the first row to fill
+  /// @param last_row one past the last row to fill
+  /// @param value the value, which is converted to each column's type
+  inline void FillBankRows(
+      hipo::bank& bank,
+      std::vector<std::pair<int, int>> const& columns,
+      int const first_row,
+      int const last_row,
+      double const value = 0)
+  {
+    if(first_row < 0 || last_row > bank.getRows())
+      throw std::out_of_range(fmt::format("cannot fill rows [{}, {}) of bank {:?}, which has {} rows", first_row, last_row, bank.getSchema().getName(), bank.getRows()));
+    if(first_row >= last_row)
+      return;
+    // the bank's data follow the header of its `hipo::structure`; `hipo::schema::getOffset` gives the offset of a cell within them
+    int const header_size = 8;
+    auto const& schema    = bank.getSchema();
+    auto* const data      = const_cast<char*>(bank.getAddress()) + header_size;
+    auto fill_column = [&](int const item, auto const column_value) {
+      auto* const first = data + schema.getOffset(item, first_row, bank.getRows());
+      auto const size   = sizeof(column_value);
+      if(column_value == 0)
+        std::memset(first, 0, size * (last_row - first_row));
+      else {
+        // the column may not be aligned for its type, since the columns are packed
+        for(int row = first_row; row < last_row; row++)
+          std::memcpy(first + size * (row - first_row), &column_value, size);
+      }
+    };
+    for(auto const& [item, type] : columns) {
+      switch(type) {
+      case hipo::kByte: fill_column(item, static_cast<int8_t>(value)); break;
+      case hipo::kShort: fill_column(item, static_cast<int16_t>(value)); break;
+      case hipo::kInt: fill_column(item, static_cast<int32_t>(value)); break;
+      case hipo::kLong: fill_column(item, static_cast<int64_t>(value)); break;
+      case hipo::kFloat: fill_column(item, static_cast<float>(value)); break;
+      case hipo::kDouble: fill_column(item, value); break;
+      }
+    }
+  }
+
+}
@@ -0,0 +1,222 @@
+#include "BankIndex.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace iguana {
+
+  namespace {
+    /// the cache which is active on the current thread
+    thread_local BankIndexCache* t_active_cache = nullptr;
+    /// the current thread's own cache, which is used by the outermost scope on the thread
+    thread_local BankIndexCache t_own_cache;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void PindexIndex::Build(hipo::bank const& bank)
+  {
+    auto& schema = const_cast<hipo::bank&>(bank).getSchema();
+    if(!schema.exists("pindex"))
+      throw std::runtime_error(fmt::format("bank {:?} has no column \"pindex\"", schema.getName()));
+    auto const item_pindex   = schema.getEntryOrder("pindex");
+    auto const item_detector = schema.exists("detector") ? schema.getEntryOrder("detector") : -1;
+    auto const item_layer    = schema.exists("layer") ? schema.getEntryOrder("layer") : -1;
+    auto const& row_list     = bank.getRowList();
+    m_num_rows               = row_list.size();
+
+    // count the rows for each `pindex`, then place them with a counting sort, which keeps them in ascending order
+    int max_pindex = -1;
+    for(auto const& row : row_list)
+      max_pindex = std::max(max_pindex, bank.getInt(item_pindex, row));
+    m_offsets.assign(max_pindex + 2, 0);
+    for(auto const& row : row_list) {
+      if(auto const pindex = bank.getInt(item_pindex, row); pindex >= 0)
+        m_offsets[pindex + 1]++;
+    }
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+    m_rows.resize(m_offsets.back());
+    std::vector<std::size_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+    for(auto const& row : row_list) {
+      if(auto const pindex = bank.getInt(item_pindex, row); pindex >= 0)
+        m_rows[fill[pindex]++] = row;
+    }
+
+    // for each `pindex`, order its rows by detector and layer; a stable sort keeps each detector and layer's rows in ascending order
+    m_keys.resize(m_rows.size());
+    for(decltype(m_rows.size()) i = 0; i < m_rows.size(); i++) {
+      m_keys[i] = {
+          item_detector >= 0 ? bank.getInt(item_detector, m_rows[i]) : 0,
+          item_layer >= 0 ? bank.getInt(item_layer, m_rows[i]) : 0};
+    }
+    std::vector<std::size_t> order(m_rows.size());
+    std::iota(order.begin(), order.end(), 0);
+    for(decltype(m_offsets.size()) p = 0; p + 1 < m_offsets.size(); p++) {
+      std::stable_sort(order.begin() + m_offsets[p], order.begin() + m_offsets[p + 1], [this](auto const a, auto const b) {
+        return m_keys[a] < m_keys[b];
+      });
+    }
+    m_keyed_rows.resize(m_rows.size());
+    std::vector<key_t> keys(m_rows.size());
+    for(decltype(order.size()) i = 0; i < order.size(); i++) {
+      m_keyed_rows[i] = m_rows[order[i]];
+      keys[i]         = m_keys[order[i]];
+    }
+    m_keys = std::move(keys);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::pair<std::size_t, std::size_t> PindexIndex::GetSpan(int const pindex) const
+  {
+    if(pindex < 0 || static_cast<std::size_t>(pindex) + 1 >= m_offsets.size())
+      return {0, 0};
+    return {m_offsets[pindex], m_offsets[pindex + 1]};
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  RowRange PindexIndex::GetRows(int const pindex) const
+  {
+    auto const [first, last] = GetSpan(pindex);
+    return {m_rows.data() + first, m_rows.data() + last};
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  RowRange PindexIndex::GetRows(int const pindex, int const detector) const
+  {
+    auto const [first, last] = GetSpan(pindex);
+    auto const keys_first    = m_keys.begin() + first;
+    auto const keys_last     = m_keys.begin() + last;
+    auto const lower         = std::lower_bound(keys_first, keys_last, detector, [](key_t const& key, int const det) { return key.first < det; });
+    auto const upper         = std::upper_bound(lower, keys_last, detector, [](int const det, key_t const& key) { return det < key.first; });
+    return {m_keyed_rows.data() + (lower - m_keys.begin()), m_keyed_rows.data() + (upper - m_keys.begin())};
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  RowRange PindexIndex::GetRows(int const pindex, int const detector, int const layer) const
+  {
+    auto const [first, last] = GetSpan(pindex);
+    auto const [lower, upper] = std::equal_range(m_keys.begin() + first, m_keys.begin() + last, key_t{detector, layer});
+    return {m_keyed_rows.data() + (lower - m_keys.begin()), m_keyed_rows.data() + (upper - m_keys.begin())};
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void RowListMask::Build(hipo::bank const& bank)
+  {
+    auto const& row_list = bank.getRowList();
+    m_num_rows           = row_list.size();
+    m_num_bank_rows      = bank.getRows();
+    m_words.assign((m_num_bank_rows + 63) / 64, 0);
+    for(auto const& row : row_list) {
+      if(row >= 0 && row < m_num_bank_rows)
+        m_words[row >> 6] |= uint64_t{1} << (row & 63);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  BankIndexCache::Scope::Scope()
+      : m_prev_cache(t_active_cache)
+  {
+    if(t_active_cache == nullptr) {
+      t_active_cache   = &t_own_cache;
+      m_own_generation = true;
+    }
+  }
+
+  BankIndexCache::Scope::Scope(BankIndexCache& cache)
+      : m_prev_cache(t_active_cache)
+  {
+    t_active_cache = &cache;
+  }
+
+  BankIndexCache::Scope::~Scope()
+  {
+    t_active_cache = m_prev_cache;
+    if(m_own_generation)
+      t_own_cache.Invalidate();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  BankIndexCache::entry_t& BankIndexCache::GetEntry(hipo::bank const& bank)
+  {
+    auto& entry = m_entries[&bank];
+    if(!entry) {
+      if(!m_free_entries.empty()) {
+        entry = std::move(m_free_entries.back());
+        m_free_entries.pop_back();
+      }
+      else
+        entry = std::make_unique<entry_t>();
+    }
+    return *entry;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  PindexIndex const& BankIndexCache::GetPindexIndex(hipo::bank const& bank)
+  {
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    auto& entry      = GetEntry(bank);
+    auto const& rows = bank.getRowList();
+    if(!entry.has_index || entry.index_rows != rows) {
+      entry.has_index = false; // in case `Build` throws
+      entry.index.Build(bank);
+      entry.index_rows = rows;
+      entry.has_index  = true;
+    }
+    return entry.index;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  RowListMask const& BankIndexCache::GetRowListMask(hipo::bank const& bank)
+  {
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    auto& entry      = GetEntry(bank);
+    auto const& rows = bank.getRowList();
+    if(!entry.has_mask || entry.mask_rows != rows || entry.mask.GetNumBankRows() != bank.getRows()) {
+      entry.mask.Build(bank);
+      entry.mask_rows = rows;
+      entry.has_mask  = true;
+    }
+    return entry.mask;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void BankIndexCache::Invalidate()
+  {
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    for(auto& [bank, entry] : m_entries) {
+      entry->has_index = false;
+      entry->has_mask  = false;
+      m_free_entries.push_back(std::move(entry));
+    }
+    m_entries.clear();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::size_t BankIndexCache::GetNumEntries()
+  {
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    return m_entries.size();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  BankIndexCache* BankIndexCache::GetActive()
+  {
+    return t_active_cache;
+  }
+
+}
@@ -0,0 +1,220 @@
+/// @file
+/// @brief per-event indices of banks: an inverted index from particle `pindex` to the rows of a detector bank, and the membership of rows in a bank's row list
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <hipo4/bank.h>
+
+namespace iguana {
+
+  /// @brief A contiguous range of bank row numbers, which may be used in a range-based `for` loop
+  class RowRange
+  {
+    public:
+
+      /// @param first pointer to the first row number
+      /// @param last pointer past the last row number
+      RowRange(int const* first = nullptr, int const* last = nullptr)
+          : m_first(first)
+          , m_last(last)
+      {}
+
+      /// @returns pointer to the first row number
+      int const* begin() const { return m_first; }
+      /// @returns pointer past the last row number
+      int const* end() const { return m_last; }
+      /// @returns the number of rows
+      std::size_t size() const { return static_cast<std::size_t>(m_last - m_first); }
+      /// @returns true if there are no rows
+      bool empty() const { return m_first == m_last; }
+
+    private:
+
+      int const* m_first;
+      int const* m_last;
+  };
+
+  /// @brief Inverted index from particle `pindex` to the rows of a detector bank, such as `REC::Traj` or `REC::Calorimeter`
+  ///
+  /// Algorithms which associate particles with detector responses typically loop over the full detector bank for each particle,
+  /// which scales as the product of the two banks' sizes. Building this index is a single pass over the detector bank, after which
+  /// the rows for a particle are found in constant time, and the rows for a particle in a particular detector (and layer) are found
+  /// with a binary search.
+  ///
+  /// Only the rows in the bank's row list are indexed, and rows with a negative `pindex` are skipped. The `detector` and `layer` columns
+  /// are optional; if the bank has neither, they are taken to be zero.
+  ///
+  /// Algorithms should get indices with `Algorithm::GetPindexIndex`, which shares them among the algorithms of an `AlgorithmSequence`.
+  class PindexIndex
+  {
+    public:
+
+      /// Build the index; any previous index is discarded
+      /// @param bank the detector bank, which must have a `pindex` column
+      void Build(hipo::bank const& bank) noexcept(false);
+
+      /// @param pindex the particle `pindex`
+      /// @returns the rows for this particle, in ascending order
+      RowRange GetRows(int const pindex) const;
+
+      /// @param pindex the particle `pindex`
+      /// @param detector the detector ID
+      /// @returns the rows for this particle and detector, ordered by layer, then by row
+      RowRange GetRows(int const pindex, int const detector) const;
+
+      /// @param pindex the particle `pindex`
+      /// @param detector the detector ID
+      /// @param layer the detector layer
+      /// @returns the rows for this particle, detector and layer, in ascending order
+      RowRange GetRows(int const pindex, int const detector, int const layer) const;
+
+      /// @returns the number of rows in the bank's row list when the index was built
+      std::size_t GetNumRows() const { return m_num_rows; }
+
+    private:
+
+      /// @returns the range of `m_rows` and `m_keyed_rows` for this `pindex`
+      std::pair<std::size_t, std::size_t> GetSpan(int const pindex) const;
+
+      /// detector and layer of a row
+      using key_t = std::pair<int, int>;
+
+      /// the number of rows in the row list
+      std::size_t m_num_rows = 0;
+      /// for each `pindex`, the offset of its rows in `m_rows` and `m_keyed_rows`; the last element is the total
+      std::vector<std::size_t> m_offsets;
+      /// rows grouped by `pindex`, in ascending order
+      std::vector<int> m_rows;
+      /// rows grouped by `pindex`, then ordered by detector, layer and row
+      std::vector<int> m_keyed_rows;
+      /// the detector and layer of each element of `m_keyed_rows`
+      std::vector<key_t> m_keys;
+  };
+
+  /// @brief Membership of rows in a bank's row list, for constant-time lookup
+  ///
+  /// A bank's row list holds the rows which passed upstream filters; testing whether a row is in it with `std::find` scales
+  /// as the size of the row list, so doing it for each row of the bank scales as its square. This is a bitmask of the bank's rows,
+  /// built with a single pass over the row list, after which the test takes constant time.
+  ///
+  /// Algorithms should get masks with `Algorithm::GetRowListMask`, which shares them among the algorithms of an `AlgorithmSequence`.
+  class RowListMask
+  {
+    public:
+
+      /// Build the mask; any previous mask is discarded
+      /// @param bank the bank
+      void Build(hipo::bank const& bank);
+
+      /// @param row the bank row
+      /// @returns true if the row is in the bank's row list
+      bool Contains(int const row) const
+      {
+        return row >= 0 && row < m_num_bank_rows && ((m_words[row >> 6] >> (row & 63)) & 1) != 0;
+      }
+
+      /// @returns the number of rows in the bank's row list when the mask was built
+      std::size_t GetNumRows() const { return m_num_rows; }
+
+      /// @returns the number of rows in the bank when the mask was built, whether or not they are in its row list
+      int GetNumBankRows() const { return m_num_bank_rows; }
+
+    private:
+
+      /// the number of rows in the row list
+      std::size_t m_num_rows = 0;
+      /// the number of rows in the bank
+      int m_num_bank_rows = 0;
+      /// one bit per bank row, which is set if the row is in the row list
+      std::vector<uint64_t> m_words;
+  };
+
+  /// @brief Cache of `PindexIndex` and `RowListMask` objects, at most one of each per bank, which is shared by the algorithms that process an event
+  ///
+  /// `Algorithm::Run` and `Algorithm::RunBatch` open a `BankIndexCache::Scope`, which makes a cache active on their thread, and
+  /// `Algorithm::GetPindexIndex` and `Algorithm::GetRowListMask` use the active cache, so that each bank is indexed at most once per
+  /// event, however many algorithms of an `AlgorithmSequence` use it. Each index is built lazily, when it is first requested, and it is
+  /// rebuilt if its bank's row list has changed since it was built, _e.g._, by a filter algorithm.
+  ///
+  /// The cached indices are keyed by their banks' addresses, so they must not outlive their banks: each _generation_ of the cache,
+  /// which is the outermost scope of a thread's own cache, or the time between two calls of `Invalidate`, only caches the banks which
+  /// are processed during it, and its indices are evicted when it ends, before the caller may destroy or reuse the banks. The evicted
+  /// indices' storage is kept for the next generation, so once the cache has grown, it makes no heap allocations.
+  class BankIndexCache
+  {
+    public:
+
+      /// @brief Make a cache active on the current thread while in scope
+      class Scope
+      {
+        public:
+
+          /// Keep the active cache, if there is one; otherwise make the current thread's own cache active, and evict its indices
+          /// when this scope ends
+          Scope();
+
+          /// @param cache the cache to make active, _e.g._, the active cache of the thread which started a task
+          Scope(BankIndexCache& cache);
+
+          ~Scope();
+          Scope(Scope const&)            = delete;
+          Scope& operator=(Scope const&) = delete;
+
+        private:
+
+          BankIndexCache* m_prev_cache;
+          /// true if this scope started a generation of the thread's own cache
+          bool m_own_generation = false;
+      };
+
+      /// Get the `pindex` index of a bank, building it if needed; this is thread safe. The returned reference remains valid until the
+      /// cache is invalidated, or until this function is called for the same bank after its row list changes.
+      /// @param bank the detector bank
+      /// @returns the index
+      PindexIndex const& GetPindexIndex(hipo::bank const& bank) noexcept(false);
+
+      /// Get the row list mask of a bank, building it if needed; this is thread safe. The returned reference remains valid until the
+      /// cache is invalidated, or until this function is called for the same bank after its row list changes.
+      /// @param bank the bank
+      /// @returns the mask
+      RowListMask const& GetRowListMask(hipo::bank const& bank);
+
+      /// Invalidate all indices, by evicting them, and start a new generation, _e.g._, when new events are read into the banks
+      void Invalidate();
+
+      /// @returns the number of banks with cached indices in the current generation
+      std::size_t GetNumEntries();
+
+      /// @returns the cache which is active on the current thread, or `nullptr` if there is none
+      static BankIndexCache* GetActive();
+
+    private:
+
+      /// the cached indices of a bank, which are built lazily, with the row lists from which they were built
+      struct entry_t
+      {
+          PindexIndex index;
+          hipo::bank::rowlist::list_t index_rows;
+          bool has_index = false;
+          RowListMask mask;
+          hipo::bank::rowlist::list_t mask_rows;
+          bool has_mask = false;
+      };
+
+      /// @returns the entry for a bank, taking one from `m_free_entries`, or creating one, if needed; `m_mutex` must be locked
+      entry_t& GetEntry(hipo::bank const& bank);
+
+      /// the entries of the current generation
+      std::unordered_map<hipo::bank const*, std::unique_ptr<entry_t>> m_entries;
+      /// the evicted entries, whose storage is reused
+      std::vector<std::unique_ptr<entry_t>> m_free_entries;
+      std::mutex m_mutex;
+  };
+
+}
@@ -0,0 +1,372 @@
+#include "EventProcessor.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace iguana {
+
+  namespace {
+    /// disables tracing, which writes the trace file, when it goes out of scope, so that tracing does not stay enabled
+    /// if `EventProcessor::Process` throws
+    class TraceScope
+    {
+      public:
+
+        /// @param file_name the trace file name; if empty, tracing is not enabled
+        /// @param sample_period the sampling period, for `Tracer::Enable`
+        TraceScope(std::string const& file_name, unsigned int const sample_period)
+            : m_enabled(!file_name.empty())
+        {
+          if(m_enabled)
+            Tracer::Enable(file_name, sample_period);
+        }
+
+        ~TraceScope()
+        {
+          try {
+            Disable();
+          }
+          catch(...) {
+            // do not throw while unwinding; the trace file is lost
+          }
+        }
+
+        TraceScope(TraceScope const&)            = delete;
+        TraceScope& operator=(TraceScope const&) = delete;
+
+        /// disable tracing, and write the trace file, if it is enabled
+        /// @returns true if the trace file was written
+        bool Disable() noexcept(false)
+        {
+          if(!m_enabled)
+            return false;
+          m_enabled = false;
+          Tracer::Disable();
+          return true;
+        }
+
+      private:
+
+        bool m_enabled;
+    };
+  }
+
+  EventProcessor::EventProcessor(std::string_view name)
+      : Object(name)
+  {}
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetSequence(sequence_definition_t sequence_definition)
+  {
+    m_sequence_definition = std::move(sequence_definition);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetSequence(std::vector<std::string> const& algo_class_names)
+  {
+    m_sequence_definition = [algo_class_names](AlgorithmSequence& seq) {
+      for(auto const& algo_class_name : algo_class_names)
+        seq.Add(algo_class_name);
+    };
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetBanks(std::vector<std::string> const& bank_names)
+  {
+    m_bank_names = bank_names;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetNumThreads(unsigned int const num_threads)
+  {
+    m_num_threads = num_threads;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetFrameSize(unsigned int const frame_size)
+  {
+    if(frame_size == 0) {
+      m_log->Error("frame size must be positive");
+      throw std::runtime_error("cannot set frame size");
+    }
+    m_frame_size = frame_size;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetMaxEvents(unsigned long const max_events)
+  {
+    m_max_events = max_events;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetEventCallback(event_callback_t callback)
+  {
+    m_event_callback = std::move(callback);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetEventPreparer(event_preparer_t preparer)
+  {
+    m_event_preparer = std::move(preparer);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::SetLazyReading(bool const lazy)
+  {
+    m_lazy_reading = lazy;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::EnableProfiling(std::string const& json_file)
+  {
+    m_profile      = true;
+    m_profile_json = json_file;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::EnableTracing(std::string const& file_name, unsigned int const sample_period)
+  {
+    m_trace_file          = file_name;
+    m_trace_sample_period = sample_period;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  unsigned long EventProcessor::Process(hipo::readerstream& stream) noexcept(false)
+  {
+    if(!m_sequence_definition) {
+      m_log->Error("no sequence definition; call `SetSequence` before `Process`");
+      throw std::runtime_error("cannot Process");
+    }
+    if(m_bank_names.empty()) {
+      m_log->Error("no banks; call `SetBanks` before `Process`");
+      throw std::runtime_error("cannot Process");
+    }
+
+    // reset the state from any previous call
+    m_next_frame            = 0;
+    m_num_claimed           = 0;
+    m_input_exhausted       = false;
+    m_next_frame_to_deliver = 0;
+    m_reorder_buffer.clear();
+    m_abort         = false;
+    m_exception     = nullptr;
+    m_num_processed = 0;
+    m_num_accepted  = 0;
+
+    // number of threads
+    auto num_threads   = m_num_threads > 0 ? m_num_threads : std::max(std::thread::hardware_concurrency(), 1u);
+    m_max_frames_ahead = 4 * static_cast<long>(num_threads);
+    m_log->Info("processing events with {} threads, {} events per frame", num_threads, m_frame_size);
+
+    // start tracing before the sequences are started, so that their `Start` phases are included; only this call is traced
+    TraceScope trace_scope(m_trace_file, m_trace_sample_period);
+    auto const trace_file = std::move(m_trace_file);
+    m_trace_file.clear();
+
+    // start one sequence, then clone it for the other threads, so that they share its parsed configuration
+    m_replicas.clear();
+    m_replica_banks.clear();
+    m_replica_banks.resize(num_threads);
+    for(auto const& bank_name : m_bank_names)
+      m_replica_banks[0].push_back(hipo::bank(stream.dictionary().getSchema(bank_name.c_str()), 48));
+    auto seq = std::make_unique<AlgorithmSequence>(fmt::format("{}_thread0", m_name));
+    m_sequence_definition(*seq);
+    if(m_profile)
+      seq->EnableProfiling(m_profile_json);
+    seq->Start(m_replica_banks[0]);
+    for(unsigned int order = 1; order < num_threads; order++) {
+      for(auto const& bank_name : m_bank_names)
+        m_replica_banks[order].push_back(hipo::bank(stream.dictionary().getSchema(bank_name.c_str()), 48));
+      m_replicas.push_back(seq->Clone(m_replica_banks[order]));
+      m_replicas.back()->SetName(fmt::format("{}_thread{}", m_name, order));
+    }
+    m_replicas.insert(m_replicas.begin(), std::move(seq));
+
+    // run the workers
+    stream.run([this, &stream](int order) { return Work(stream, order); }, static_cast<int>(num_threads));
+
+    // stop the sequences; the first one reports the profile, if enabled, which includes the other replicas
+    for(auto& replica : m_replicas)
+      replica->Stop();
+    m_replicas.clear();
+    m_replica_banks.clear();
+    if(trace_scope.Disable())
+      m_log->Info("wrote trace to {:?}", trace_file);
+
+    // rethrow the first worker exception, if any
+    if(m_exception) {
+      m_log->Error("event processing was aborted");
+      std::rethrow_exception(m_exception);
+    }
+
+    m_log->Info("processed {} events; {} accepted", m_num_processed.load(), m_num_accepted.load());
+    return m_num_processed;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  unsigned long EventProcessor::GetNumEventsProcessed() const
+  {
+    return m_num_processed;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  unsigned long EventProcessor::GetNumEventsAccepted() const
+  {
+    return m_num_accepted;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  int EventProcessor::Work(hipo::readerstream& stream, int order)
+  {
+    int num_processed = 0;
+    try {
+
+      // this thread's replica of the sequence, and its bank list, which is the template for each event in a batch
+      auto& seq   = dynamic_cast<AlgorithmSequence&>(*m_replicas.at(order));
+      auto& banks = m_replica_banks.at(order);
+      auto lazy   = m_lazy_reading && !m_event_preparer;
+
+      // loop over frames; each frame's events are run together, as one batch
+      std::vector<hipo::event> events;
+      std::vector<hipo::event*> batch_events;
+      std::vector<hipo::banklist> batch;
+      std::vector<bool> accepted;
+      long frame_num;
+      while((frame_num = ClaimFrame(stream, events)) >= 0) {
+
+        // collect the non-empty events of the batch
+        batch_events.clear();
+        for(auto& event : events) {
+          if(event.getSize() > 16)
+            batch_events.push_back(&event);
+        }
+        batch.resize(batch_events.size(), banks);
+        accepted.assign(batch.size(), true);
+
+        // run the sequence; if not reading lazily, read all of the banks first
+        if(lazy)
+          seq.RunBatch(batch, batch_events, accepted);
+        else {
+          for(decltype(batch.size()) i = 0; i < batch.size(); i++) {
+            for(auto& bank : batch[i])
+              batch_events[i]->read(bank);
+            if(m_event_preparer)
+              m_event_preparer(batch[i]);
+          }
+          seq.RunBatch(batch, accepted);
+        }
+        num_processed += batch.size();
+        m_num_processed += batch.size();
+        m_num_accepted += std::count(accepted.begin(), accepted.end(), true);
+
+        // hand the results to the event callback, or to the reorder buffer
+        DeliverFrame(frame_num, batch, accepted);
+      }
+
+      seq.GetLog()->Debug("nProcessed = {}", num_processed);
+    }
+    catch(...) {
+      Abort(std::current_exception());
+    }
+    return num_processed;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  long EventProcessor::ClaimFrame(hipo::readerstream& stream, std::vector<hipo::event>& events)
+  {
+    std::unique_lock<std::mutex> const input_lock(m_input_mutex);
+    if(m_input_exhausted || m_abort)
+      return -1;
+
+    // if the callback is used, bound the reorder buffer: frames can only pile up behind a frame which
+    // has been claimed but not yet delivered, so this waits for that frame's thread, which is never blocked here
+    if(m_event_callback) {
+      std::unique_lock<std::mutex> output_lock(m_output_mutex);
+      m_output_cv.wait(output_lock, [this]() {
+        return m_abort || m_next_frame - m_next_frame_to_deliver < m_max_frames_ahead;
+      });
+      if(m_abort)
+        return -1;
+    }
+
+    // number of events in this frame
+    unsigned long num_events = m_frame_size;
+    if(m_max_events > 0) {
+      num_events = std::min(num_events, m_max_events - m_num_claimed);
+      if(num_events == 0) {
+        m_input_exhausted = true;
+        return -1;
+      }
+    }
+
+    // read the frame
+    events.resize(num_events);
+    stream.pull(events);
+    m_num_claimed += num_events;
+    if(std::none_of(events.begin(), events.end(), [](auto& event) { return event.getSize() > 16; })) {
+      m_input_exhausted = true;
+      return -1;
+    }
+    return m_next_frame++;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::DeliverFrame(long const frame_num, std::vector<hipo::banklist>& batch, std::vector<bool> const& accepted)
+  {
+    if(!m_event_callback)
+      return;
+    std::lock_guard<std::mutex> const output_lock(m_output_mutex);
+    auto const CallBack = [this](std::vector<hipo::banklist> const& frame_batch, std::vector<bool> const& frame_accepted) {
+      if(m_abort)
+        return;
+      for(decltype(frame_batch.size()) i = 0; i < frame_batch.size(); i++)
+        m_event_callback(frame_batch[i], frame_accepted[i]);
+    };
+    // a frame which is in order is handed over directly; otherwise its bank lists are moved to the reorder buffer,
+    // and the worker's batch is rebuilt from its template bank list for the next frame
+    if(frame_num == m_next_frame_to_deliver) {
+      CallBack(batch, accepted);
+      m_next_frame_to_deliver++;
+    }
+    else {
+      m_reorder_buffer.emplace(frame_num, processed_frame_t{std::move(batch), accepted});
+      batch.clear();
+    }
+    // flush all frames which are now in order
+    for(auto it = m_reorder_buffer.begin(); it != m_reorder_buffer.end() && it->first == m_next_frame_to_deliver;) {
+      CallBack(it->second.batch, it->second.accepted);
+      it = m_reorder_buffer.erase(it);
+      m_next_frame_to_deliver++;
+    }
+    m_output_cv.notify_all();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void EventProcessor::Abort(std::exception_ptr ex)
+  {
+    std::lock_guard<std::mutex> const output_lock(m_output_mutex);
+    if(!m_exception)
+      m_exception = ex;
+    m_abort = true;
+    m_output_cv.notify_all();
+  }
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include <hipo4/reader.h>
+
+#include "AlgorithmSequence.h"
+
+namespace iguana {
+
+  /// @brief Multithreaded event loop, which runs an `AlgorithmSequence` over a HIPO file
+  ///
+  /// Each worker thread owns its own replica of the algorithm sequence and its own `hipo::banklist`.
+  /// The sequence is built from a _sequence definition_, a function which `Add`s algorithms to (and configures) a
+  /// fresh `AlgorithmSequence`; it is started once, then replicated for the other threads with `Algorithm::Clone`.
+  ///
+  /// Events are read from a `hipo::readerstream` in _frames_ (groups of consecutive events). Idle threads
+  /// claim the next available frame from the stream, so a thread which is stuck on an expensive frame does not
+  /// stall the others. Each frame is run as one batch, with `Algorithm::RunBatch`. By default, banks are read lazily, so that the banks of
+  /// events which are rejected early in the sequence are not read (see `EventProcessor::SetLazyReading`). If an event callback is set with `EventProcessor::SetEventCallback`, the processed
+  /// events are handed to it _in input order_, by way of a reorder buffer; the callback is never called
+  /// concurrently, so it does not need to be thread safe.
+  ///
+  /// **Example**
+  /// @code
+  /// hipo::readerstream stream;
+  /// stream.open("data.hipo");
+  /// iguana::EventProcessor proc;
+  /// proc.SetSequence({"clas12::EventBuilderFilter", "clas12::SectorFinder"});
+  /// proc.SetBanks({"REC::Particle", "REC::Calorimeter", "REC::Track", "REC::Scintillator"});
+  /// proc.SetNumThreads(8);
+  /// proc.SetEventCallback([](hipo::banklist const& banks, bool accepted) { /* ... */ });
+  /// proc.Process(stream);
+  /// @endcode
+  class EventProcessor : public Object
+  {
+
+    public:
+
+      /// Function which defines an algorithm sequence
+      using sequence_definition_t = std::function<void(AlgorithmSequence&)>;
+
+      /// Function called for each processed event, in input order; the `bool` is the return value of `AlgorithmSequence::Run`
+      using event_callback_t = std::function<void(hipo::banklist const&, bool)>;
+
+      /// Function called for each event, after its banks are read and before the sequence is run
+      using event_preparer_t = std::function<void(hipo::banklist&)>;
+
+      /// @param name the name of this event processor
+      EventProcessor(std::string_view name = "event_processor");
+      ~EventProcessor() {}
+
+      /// Set the sequence definition
+      /// @param sequence_definition a function which `Add`s (and configures) algorithms to the given sequence
+      void SetSequence(sequence_definition_t sequence_definition);
+
+      /// Set the sequence definition from a list of algorithm class names, which will be run in this order
+      /// @param algo_class_names the list of algorithm class names
+      void SetSequence(std::vector<std::string> const& algo_class_names);
+
+      /// Set the list of input banks to read from each event
+      /// @param bank_names the list of bank names
+      void SetBanks(std::vector<std::string> const& bank_names);
+
+      /// Set the number of worker threads
+      /// @param num_threads the number of threads; if zero, use `std::thread::hardware_concurrency`
+      void SetNumThreads(unsigned int const num_threads);
+
+      /// Set the number of events per frame
+      /// @param frame_size the number of events per frame
+      void SetFrameSize(unsigned int const frame_size);
+
+      /// Set the maximum number of events to process
+      /// @param max_events the maximum number of events; if zero, process all of them
+      void SetMaxEvents(unsigned long const max_events);
+
+      /// Set the function to call for each processed event, in input order
+      /// @param callback the callback function
+      void SetEventCallback(event_callback_t callback);
+
+      /// Set a function which may modify each event's banks before the sequence is run; since all of the banks must be read before it
+      /// is called, this disables lazy reading
+      /// @param preparer the function; it is called concurrently from the worker threads, so it must be thread safe
+      void SetEventPreparer(event_preparer_t preparer);
+
+      /// Set whether banks are read lazily, which is the default: each bank is read just before the first algorithm which uses it,
+      /// so the banks of events which are rejected early in the sequence are not read; as a result, the banks of rejected events which
+      /// are given to the event callback may be empty. Lazy reading is not used if an event preparer is set.
+      /// @see `AlgorithmSequence::Run(hipo::banklist&, hipo::event&) const`
+      /// @param lazy if true, read banks lazily
+      void SetLazyReading(bool const lazy);
+
+      /// Enable profiling of the sequence and each of its algorithms, merged over all threads; the profile is printed at the end of `EventProcessor::Process`
+      /// @see `Algorithm::EnableProfiling`
+      /// @param json_file if not empty, the profile is also written to this JSON file
+      void EnableProfiling(std::string const& json_file = "");
+
+      /// Enable tracing for the next call to `EventProcessor::Process`, which writes a trace-event JSON file at the end
+      /// @see `Tracer`; sampling applies to frames, since each frame is run as one batch
+      /// @param file_name the output file name
+      /// @param sample_period trace one in every `sample_period` frames; if 0 or 1, trace all of them
+      void EnableTracing(std::string const& file_name, unsigned int const sample_period = 1);
+
+      /// Run the event loop, until the stream is exhausted or the maximum number of events is reached
+      /// @param stream the input stream, which must already be open
+      /// @returns the number of events processed
+      unsigned long Process(hipo::readerstream& stream) noexcept(false);
+
+      /// @returns the number of events processed by the last call to `EventProcessor::Process`
+      unsigned long GetNumEventsProcessed() const;
+
+      /// @returns the number of events accepted by the sequence in the last call to `EventProcessor::Process`
+      unsigned long GetNumEventsAccepted() const;
+
+    private:
+
+      /// a processed frame, waiting in the reorder buffer
+      struct processed_frame_t
+      {
+          std::vector<hipo::banklist> batch;
+          std::vector<bool> accepted;
+      };
+
+      /// the worker function, run by each thread
+      int Work(hipo::readerstream& stream, int order);
+
+      /// claim the next frame of events from the stream; returns the frame number, or -1 if there are no more events
+      long ClaimFrame(hipo::readerstream& stream, std::vector<hipo::event>& events);
+
+      /// hand a processed frame to the event callback if it is the next one in order, otherwise to the reorder buffer,
+      /// then flush any frames which are now in order; a buffered frame's bank lists are moved out of `batch`
+      void DeliverFrame(long const frame_num, std::vector<hipo::banklist>& batch, std::vector<bool> const& accepted);
+
+      /// record a worker exception and stop the other workers
+      void Abort(std::exception_ptr ex);
+
+      sequence_definition_t m_sequence_definition;
+      event_callback_t m_event_callback;
+      event_preparer_t m_event_preparer;
+      std::vector<std::string> m_bank_names;
+      unsigned int m_num_threads = 0;
+      unsigned int m_frame_size  = 50;
+      unsigned long m_max_events = 0;
+      bool m_lazy_reading        = true;
+
+      // profiling
+      bool m_profile = false;
+      std::string m_profile_json;
+
+      // tracing
+      std::string m_trace_file;
+      unsigned int m_trace_sample_period = 1;
+
+      /// maximum number of frames the reorder buffer may hold; bounds memory when one frame is slow
+      long m_max_frames_ahead = 0;
+
+      // each thread's sequence replica and bank list, indexed by thread number
+      std::vector<std::unique_ptr<Algorithm>> m_replicas;
+      std::vector<hipo::banklist> m_replica_banks;
+
+      // input state, guarded by `m_input_mutex`
+      std::mutex m_input_mutex;
+      long m_next_frame           = 0;
+      unsigned long m_num_claimed = 0;
+      bool m_input_exhausted      = false;
+
+      // reorder buffer, guarded by `m_output_mutex`
+      std::mutex m_output_mutex;
+      std::condition_variable m_output_cv;
+      std::map<long, processed_frame_t> m_reorder_buffer;
+      long m_next_frame_to_deliver = 0;
+
+      // worker exception handling
+      std::atomic<bool> m_abort{false};
+      std::exception_ptr m_exception;
+
+      // counters
+      std::atomic<unsigned long> m_num_processed{0};
+      std::atomic<unsigned long> m_num_accepted{0};
+  };
+}
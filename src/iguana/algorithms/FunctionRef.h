@@ -0,0 +1,53 @@
+/// @file
+/// @brief non-owning reference to a callable
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace iguana {
+
+  template <typename SIGNATURE>
+  class FunctionRef;
+
+  /// @brief Non-owning reference to a callable, such as a lambda
+  ///
+  /// Unlike `std::function`, it neither copies nor owns the callable, so making one never allocates; instead, the callable must
+  /// outlive it. It is the size of two pointers, and it is cheap to copy. It may only refer to an lvalue, so that it cannot be
+  /// bound to a temporary callable by mistake.
+  /// @tparam RESULT the result type of the callable
+  /// @tparam ARGS the argument types of the callable
+  template <typename RESULT, typename... ARGS>
+  class FunctionRef<RESULT(ARGS...)>
+  {
+    public:
+
+      /// @param callable the callable, which must outlive this reference
+      template <
+          typename CALLABLE,
+          typename = std::enable_if_t<!std::is_same_v<std::remove_cv_t<CALLABLE>, FunctionRef> && std::is_invocable_r_v<RESULT, CALLABLE&, ARGS...>>>
+      FunctionRef(CALLABLE& callable)
+          : m_callable(const_cast<void*>(static_cast<void const*>(std::addressof(callable))))
+          , m_call([](void* ptr, ARGS... args) -> RESULT {
+            return (*static_cast<CALLABLE*>(ptr))(std::forward<ARGS>(args)...);
+          })
+      {}
+
+      /// Call the callable
+      /// @param args the arguments
+      /// @returns the result
+      RESULT operator()(ARGS... args) const
+      {
+        return m_call(m_callable, std::forward<ARGS>(args)...);
+      }
+
+    private:
+
+      /// the callable
+      void* m_callable;
+      /// calls the callable, which has the type that this reference was made from
+      RESULT (*m_call)(void*, ARGS...);
+  };
+
+}
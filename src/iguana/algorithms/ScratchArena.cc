@@ -0,0 +1,77 @@
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace iguana {
+
+  ScratchArena::Scope::Scope()
+  {
+    Get().m_depth++;
+  }
+
+  ScratchArena::Scope::~Scope()
+  {
+    auto& arena = Get();
+    if(--arena.m_depth == 0)
+      arena.Reset();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  ScratchArena& ScratchArena::Get()
+  {
+    thread_local ScratchArena arena;
+    return arena;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void ScratchArena::Reset()
+  {
+    // destroy the objects in the reverse order of their construction; the list keeps its capacity
+    for(auto it = m_destructors.rbegin(); it != m_destructors.rend(); ++it)
+      it->second(it->first);
+    m_destructors.clear();
+    m_block = 0;
+    m_used  = 0;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  std::size_t ScratchArena::GetCapacity() const
+  {
+    std::size_t capacity = 0;
+    for(auto const& block : m_blocks)
+      capacity += block.size;
+    return capacity;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void* ScratchArena::do_allocate(std::size_t bytes, std::size_t alignment)
+  {
+    if(m_depth == 0)
+      throw std::runtime_error("cannot allocate from the ScratchArena outside of a ScratchArena::Scope");
+    // take the memory from the current block, or from the next one which has room
+    for(; m_block < m_blocks.size(); m_block++, m_used = 0) {
+      auto& block = m_blocks[m_block];
+      void* ptr   = block.data.get() + m_used;
+      auto space  = block.size - m_used;
+      if(std::align(alignment, bytes, ptr, space) != nullptr) {
+        m_used = block.size - space + bytes;
+        return ptr;
+      }
+    }
+    // no block has room, so add one, which is at least twice as large as the last one
+    auto const size = std::max({s_first_block_size, m_blocks.empty() ? 0 : 2 * m_blocks.back().size, bytes + alignment});
+    m_blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+    m_block     = m_blocks.size() - 1;
+    void* ptr   = m_blocks.back().data.get();
+    auto space  = size;
+    std::align(alignment, bytes, ptr, space);
+    m_used = size - space + bytes;
+    return ptr;
+  }
+
+}
@@ -0,0 +1,113 @@
+/// @file
+/// @brief per-thread arena for the temporary containers of algorithms, which is reset for each event
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace iguana {
+
+  /// @brief Per-thread arena for the temporary containers of algorithms, which is reset for each event
+  ///
+  /// Algorithms often need short-lived containers while processing an event, such as lists of particle pairs or maps of
+  /// detector hits. Allocating them on the heap for each event is slow, and at high thread counts, contention in the heap
+  /// allocator becomes significant. Instead, they may allocate from the thread's arena, which is a `std::pmr::memory_resource`
+  /// for the `std::pmr` containers:
+  /// @code
+  /// ScratchArena::Scope const scratch_scope;
+  /// std::pmr::vector<int> rows(&ScratchArena::Get());
+  /// @endcode
+  ///
+  /// Allocation takes the next free bytes of the arena's current block, and deallocation does nothing; instead, all of the memory
+  /// is reclaimed at once, when the outermost `ScratchArena::Scope` on the thread ends. The blocks are kept for the next event,
+  /// so once the arena has grown to the size that the events need, it makes no heap allocations.
+  ///
+  /// `Algorithm::Run` and `Algorithm::RunBatch` open a scope, so algorithms may use the arena in their `RunHook` and `RunBatchHook`;
+  /// memory is reclaimed after each event for `Run`, or after each batch for `RunBatch`. `Run` functions which take `hipo::bank`
+  /// parameters must open their own scope, since they may be called directly. Containers which use the arena must not outlive the
+  /// scope in which they are created, and must not be shared with other threads. Allocating from the arena outside of any scope throws
+  /// an exception, since that memory would never be reclaimed, or would be reclaimed by an unrelated scope while it is still in use.
+  class ScratchArena : public std::pmr::memory_resource
+  {
+    public:
+
+      /// @brief Use the current thread's arena while in scope; when the outermost scope ends, the arena is reset
+      class Scope
+      {
+        public:
+
+          Scope();
+          ~Scope();
+          Scope(Scope const&)            = delete;
+          Scope& operator=(Scope const&) = delete;
+      };
+
+      ScratchArena()                               = default;
+      ScratchArena(ScratchArena const&)            = delete;
+      ScratchArena& operator=(ScratchArena const&) = delete;
+      ~ScratchArena() override { Reset(); }
+
+      /// @returns the arena of the current thread; it may only allocate while a `ScratchArena::Scope` is open on the thread
+      static ScratchArena& Get();
+
+      /// Move or copy an object into this arena, _e.g._, the callable of a row filter kernel (see `Algorithm::MakeRowKernel`),
+      /// so that it may be referred to until the outermost `ScratchArena::Scope` ends, when it is destroyed
+      /// @param value the object
+      /// @returns the object in this arena
+      template <typename T>
+      std::decay_t<T>& Make(T&& value)
+      {
+        using object_t = std::decay_t<T>;
+        auto* object   = new(allocate(sizeof(object_t), alignof(object_t))) object_t(std::forward<T>(value));
+        if constexpr(!std::is_trivially_destructible_v<object_t>) {
+          try {
+            m_destructors.push_back({object, [](void* ptr) { static_cast<object_t*>(ptr)->~object_t(); }});
+          }
+          catch(...) {
+            object->~object_t();
+            throw;
+          }
+        }
+        return *object;
+      }
+
+      /// Reclaim all of the memory allocated from this arena, keeping its blocks for reuse; the objects made with `Make` are destroyed
+      void Reset();
+
+      /// @returns the total size of this arena's blocks, in bytes
+      std::size_t GetCapacity() const;
+
+    private:
+
+      void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+      void do_deallocate(void*, std::size_t, std::size_t) override {}
+      bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override { return this == &other; }
+
+      /// the size of the first block, in bytes
+      static constexpr std::size_t s_first_block_size = 64 * 1024;
+
+      /// a block of memory
+      struct block_t
+      {
+          std::unique_ptr<std::byte[]> data;
+          std::size_t size;
+      };
+
+      /// the blocks, in the order they were added; each one is larger than the previous one
+      std::vector<block_t> m_blocks;
+      /// the index of the block from which memory is currently allocated
+      std::size_t m_block = 0;
+      /// the number of bytes used in the current block
+      std::size_t m_used = 0;
+      /// the number of scopes which are open
+      int m_depth = 0;
+      /// the objects made with `Make` which have destructors, in the order they were made, with their destructors
+      std::vector<std::pair<void*, void (*)(void*)>> m_destructors;
+  };
+
+}
@@ -1,7 +1,18 @@
 #include "Validator.h"
 
+#include <atomic>
+#include <unordered_set>
+
 namespace iguana {
 
+#ifdef IGUANA_ROOT_FOUND
+  namespace {
+    /// the keys of the validators which have not been destroyed, so that threads may drop the shards of destroyed validators
+    std::unordered_set<unsigned long> live_hist_shards_keys;
+    std::mutex live_hist_shards_keys_mutex;
+  }
+#endif
+
   void Validator::SetOutputDirectory(std::string_view output_dir)
   {
     m_output_dir = output_dir;
@@ -14,4 +25,69 @@ namespace iguana {
     return {};
   }
 
+#ifdef IGUANA_ROOT_FOUND
+
+  void Validator::MergeHistShards()
+  {
+    std::scoped_lock<std::mutex> lock(m_hist_shards_mutex);
+    for(auto& shards : m_hist_shards) {
+      for(auto& [hist, shard] : *shards) {
+        const_cast<TH1*>(hist)->Add(shard.get());
+        shard->Reset();
+      }
+    }
+  }
+
+  Validator::hist_shards_t& Validator::GetThreadHistShards() const
+  {
+    // each thread has a table of the shards of each validator; validators are keyed by a unique number rather than by
+    // their address, since a new validator may have the address of a deleted one
+    thread_local std::unordered_map<unsigned long, hist_shards_t*> thread_shards;
+    auto it = thread_shards.find(m_hist_shards_key);
+    if(it != thread_shards.end())
+      return *it->second;
+    // drop the dangling entries of destroyed validators, so that the table does not grow without bound
+    {
+      std::scoped_lock<std::mutex> lock(live_hist_shards_keys_mutex);
+      for(auto jt = thread_shards.begin(); jt != thread_shards.end();) {
+        if(live_hist_shards_keys.find(jt->first) == live_hist_shards_keys.end())
+          jt = thread_shards.erase(jt);
+        else
+          ++jt;
+      }
+    }
+    std::scoped_lock<std::mutex> lock(m_hist_shards_mutex);
+    auto& shards = m_hist_shards.emplace_back(std::make_unique<hist_shards_t>());
+    thread_shards.emplace(m_hist_shards_key, shards.get());
+    return *shards;
+  }
+
+  std::unique_ptr<TH1> Validator::CloneHist(TH1 const* hist)
+  {
+    // `TH1::Clone` may attach the clone to the current directory, which is global, so serialize cloning
+    static std::mutex clone_mutex;
+    std::scoped_lock<std::mutex> lock(clone_mutex);
+    std::unique_ptr<TH1> clone(static_cast<TH1*>(hist->Clone()));
+    clone->SetDirectory(nullptr);
+    clone->Reset();
+    return clone;
+  }
+
+  unsigned long Validator::NextHistShardsKey()
+  {
+    static std::atomic<unsigned long> next_key{0};
+    auto const key = next_key++;
+    std::scoped_lock<std::mutex> lock(live_hist_shards_keys_mutex);
+    live_hist_shards_keys.insert(key);
+    return key;
+  }
+
+  void Validator::ReleaseHistShardsKey(unsigned long const key)
+  {
+    std::scoped_lock<std::mutex> lock(live_hist_shards_keys_mutex);
+    live_hist_shards_keys.erase(key);
+  }
+
+#endif
+
 }
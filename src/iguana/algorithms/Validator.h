@@ -1,7 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include <hipo4/bank.h>
 
@@ -9,6 +12,7 @@
 #include "iguana/algorithms/AlgorithmSequence.h"
 
 #ifdef IGUANA_ROOT_FOUND
+#include <TH1.h>
 #include <TStyle.h>
 #endif
 
@@ -34,7 +38,12 @@ namespace iguana {
         gStyle->SetPalette(55);
 #endif
       }
-      virtual ~Validator() {}
+      virtual ~Validator()
+      {
+#ifdef IGUANA_ROOT_FOUND
+        ReleaseHistShardsKey(m_hist_shards_key);
+#endif
+      }
 
       /// Set this validator's output directory
       /// @param output_dir the output directory
@@ -49,9 +58,33 @@ namespace iguana {
       /// An `iguana::AlgorithmSequence` to be used for this validator
       std::unique_ptr<AlgorithmSequence> m_algo_seq;
 
-      /// Mutex for locking procedures such as histogram filling in `Validator::Run`
+      /// Mutex for locking procedures in `Validator::Run` which mutate shared state, such as counters; histograms should
+      /// instead be filled through their shards, from `Validator::GetHistShard`
       mutable std::mutex m_mutex;
 
+#ifdef IGUANA_ROOT_FOUND
+      /// @brief Get the current thread's shard of a histogram, to fill in `Validator::RunHook`
+      ///
+      /// Filling a shared histogram from many threads requires a lock, which serializes the threads. Instead, each thread
+      /// fills its own clone of the histogram, its _shard_, which is created the first time the thread asks for it. Call
+      /// `Validator::MergeHistShards` at the beginning of `Validator::StopHook`, to add the shards to the histograms
+      /// before they are drawn or written.
+      /// @param hist the histogram, which should be booked in `Validator::StartHook`
+      /// @returns the current thread's shard of `hist`
+      template <typename HIST>
+      HIST* GetHistShard(HIST* hist) const
+      {
+        auto& shards = GetThreadHistShards();
+        auto it      = shards.find(hist);
+        if(it == shards.end())
+          it = shards.emplace(hist, CloneHist(hist)).first;
+        return static_cast<HIST*>(it->second.get());
+      }
+
+      /// Add each thread's histogram shards to their histograms, and reset the shards; see `Validator::GetHistShard`
+      void MergeHistShards();
+#endif
+
     private:
 
       // hooks are no-ops, since subclasses will implement
@@ -62,5 +95,29 @@ namespace iguana {
 
       /// output directory
       std::string m_output_dir;
+
+#ifdef IGUANA_ROOT_FOUND
+      /// a thread's histogram shards, keyed by their histograms
+      using hist_shards_t = std::unordered_map<TH1 const*, std::unique_ptr<TH1>>;
+
+      /// @returns the current thread's histogram shards, which are created on the first call from this thread
+      hist_shards_t& GetThreadHistShards() const;
+
+      /// @returns an empty clone of a histogram, which is not attached to any directory
+      static std::unique_ptr<TH1> CloneHist(TH1 const* hist);
+
+      /// @returns a unique key for a validator instance, which is live until it is released by `Validator::ReleaseHistShardsKey`
+      static unsigned long NextHistShardsKey();
+
+      /// Release the key of a destroyed validator, so that threads may drop its entry from their tables of histogram shards
+      /// @param key the key
+      static void ReleaseHistShardsKey(unsigned long const key);
+
+      /// every thread's histogram shards
+      mutable std::vector<std::unique_ptr<hist_shards_t>> m_hist_shards;
+      mutable std::mutex m_hist_shards_mutex;
+      /// the key of this validator's histogram shards in each thread's table
+      unsigned long const m_hist_shards_key = NextHistShardsKey();
+#endif
   };
 }
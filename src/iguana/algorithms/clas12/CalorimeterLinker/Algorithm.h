@@ -1,6 +1,6 @@
 #pragma once
 
-#include "iguana/algorithms/Algorithm.h"
+#include "iguana/algorithms/clas12/DetectorLinker/Algorithm.h"
 
 namespace iguana::clas12 {
 
@@ -10,15 +10,15 @@ namespace iguana::clas12 {
   /// This algorithm reads `REC::Calorimeter` and produces a new bank, `REC::Particle::Calorimeter`,
   /// to make it easier to access commonly used `REC::Calorimeter` information for each particle.
   ///
+  /// The link is done by `clas12::DetectorLinker`, configured to link the PCAL and the inner and outer EC.
+  ///
   /// If this algorithm does not provide information you need, ask the maintainers or open a pull request.
-  class CalorimeterLinker : public Algorithm
+  ///
+  /// @doc_config{clas12/CalorimeterLinker}
+  class CalorimeterLinker : public DetectorLinker
   {
 
-      DEFINE_IGUANA_ALGORITHM(CalorimeterLinker, clas12::CalorimeterLinker)
-
-    private: // hooks
-      void StartHook(hipo::banklist& banks) override;
-      bool RunHook(hipo::banklist& banks) const override;
+      DEFINE_IGUANA_SUBALGORITHM(CalorimeterLinker, clas12::CalorimeterLinker, DetectorLinker)
 
     public:
 
@@ -31,34 +31,6 @@ namespace iguana::clas12 {
           hipo::bank const& bank_particle,
           hipo::bank const& bank_calorimeter,
           hipo::bank& bank_result) const;
-
-    private:
-
-      /// `hipo::banklist` indices
-      hipo::banklist::size_type b_particle;
-      hipo::banklist::size_type b_calorimeter;
-      hipo::banklist::size_type b_result;
-
-      // `b_result` bank item indices
-      int i_pindex;
-      int i_pcal_found;
-      int i_pcal_sector;
-      int i_pcal_lu;
-      int i_pcal_lv;
-      int i_pcal_lw;
-      int i_pcal_energy;
-      int i_ecin_found;
-      int i_ecin_sector;
-      int i_ecin_lu;
-      int i_ecin_lv;
-      int i_ecin_lw;
-      int i_ecin_energy;
-      int i_ecout_found;
-      int i_ecout_sector;
-      int i_ecout_lu;
-      int i_ecout_lv;
-      int i_ecout_lw;
-      int i_ecout_energy;
   };
 
 }
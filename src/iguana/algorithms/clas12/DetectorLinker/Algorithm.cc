@@ -0,0 +1,213 @@
+#include "Algorithm.h"
+
+namespace iguana::clas12 {
+
+  void DetectorLinker::ConfigHook()
+  {
+    o_source   = GetOptionScalar<std::string>({"source"});
+    o_detector = GetOptionScalar<int>({"detector"});
+    o_layers   = GetOptionVector<int>({"layers"});
+    o_prefixes = GetOptionVector<std::string>({"prefixes"});
+    o_columns  = GetOptionVector<std::string>({"columns"});
+    if(o_source.empty() || o_layers.empty()) {
+      m_log->Error("option 'source' and option 'layers' must be set; this algorithm should be configured by a subclass, such as `clas12::TrajLinker`");
+      throw std::runtime_error("bad configuration");
+    }
+    if(o_prefixes.size() != o_layers.size()) {
+      m_log->Error("option 'prefixes' must have one element per element of option 'layers'");
+      throw std::runtime_error("bad configuration");
+    }
+    // map each layer number to its index in `o_layers`
+    m_layer_index.clear();
+    for(decltype(o_layers.size()) l = 0; l < o_layers.size(); l++) {
+      if(o_layers[l] < 0) {
+        m_log->Error("option 'layers' has negative layer number {}", o_layers[l]);
+        throw std::runtime_error("bad configuration");
+      }
+      if(static_cast<decltype(m_layer_index.size())>(o_layers[l]) >= m_layer_index.size())
+        m_layer_index.resize(o_layers[l] + 1, -1);
+      m_layer_index[o_layers[l]] = static_cast<int>(l);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void DetectorLinker::StartHook(hipo::banklist& banks)
+  {
+    bool const have_banks = !banks.empty(); // false if this algorithm was started without a `hipo::banklist`
+    b_particle            = GetBankIndex(banks, "REC::Particle", BankAccess::read);
+    b_source              = GetBankIndex(banks, o_source, BankAccess::read);
+    m_result_bank_name    = GetCreatedBankName();
+    auto result_schema    = CreateBank(banks, b_result, m_result_bank_name);
+
+    // resolve the created bank's columns
+    auto get_entry_order = [this, &result_schema](std::string const& name) {
+      if(!result_schema.exists(name)) {
+        m_log->Error("created bank {:?} has no column {:?}; check the definition of the bank and the configuration of this algorithm", result_schema.getName(), name);
+        throw std::runtime_error("cannot link columns");
+      }
+      return result_schema.getEntryOrder(name.c_str());
+    };
+    i_pindex = get_entry_order("pindex");
+    i_found.clear();
+    for(auto const& prefix : o_prefixes)
+      i_found.push_back(get_entry_order(prefix + "_found"));
+    m_column_links.clear();
+    for(auto const& column : o_columns) {
+      column_link_t column_link;
+      for(auto const& prefix : o_prefixes)
+        column_link.dst_items.push_back(get_entry_order(prefix + "_" + column));
+      column_link.dst_type = result_schema.getEntryType(column_link.dst_items.front());
+      m_column_links.push_back(column_link);
+    }
+    m_result_columns.clear();
+    for(int item = 0; item < result_schema.getEntries(); item++) {
+      if(item != i_pindex)
+        m_result_columns.push_back({item, result_schema.getEntryType(item)});
+    }
+
+    // resolve the detector bank's columns, if the bank is available
+    m_source_resolved = false;
+    if(have_banks)
+      ResolveSourceColumns(GetBank(banks, b_source, o_source));
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool DetectorLinker::RunHook(hipo::banklist& banks) const
+  {
+    return Run(
+        GetBank(banks, b_particle, "REC::Particle"),
+        GetBank(banks, b_source, o_source),
+        GetBank(banks, b_result, m_result_bank_name));
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool DetectorLinker::Run(
+      hipo::bank const& bank_particle,
+      hipo::bank const& bank_source,
+      hipo::bank& bank_result) const
+  {
+    Link(bank_particle, bank_source, bank_result);
+    ShowBankWithHeader(bank_result, "CREATED BANK");
+    return true;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void DetectorLinker::Link(
+      hipo::bank const& bank_particle,
+      hipo::bank const& bank_source,
+      hipo::bank& bank_result) const
+  {
+    bank_result.reset(); // IMPORTANT: always first `reset` the created bank(s)
+    ResolveSourceColumns(bank_source);
+    ShowBankWithHeader(bank_particle, "INPUT PARTICLE BANK");
+    ShowBankWithHeader(bank_source, "INPUT DETECTOR BANK");
+
+    // sync new bank with particle bank, and fill it with zeroes
+    auto const num_particles = bank_particle.getRows();
+    bank_result.setRows(num_particles);
+    bank_result.getMutableRowList().setList(bank_particle.getRowList());
+    FillBankRows(bank_result, m_result_columns, 0, num_particles);
+    for(int row = 0; row < num_particles; row++)
+      bank_result.putShort(i_pindex, row, static_cast<int16_t>(row));
+
+    // single pass over the detector bank: for each particle and layer, find the linked row, which is the last one
+    int const num_layers = static_cast<int>(o_layers.size());
+    thread_local std::vector<int> linked_rows;
+    linked_rows.assign(num_particles * num_layers, -1);
+    for(auto const& row_source : bank_source.getRowList()) {
+      auto const pindex = bank_source.getInt(m_src_pindex, row_source);
+      if(pindex < 0 || pindex >= num_particles)
+        continue;
+      if(o_detector >= 0 && bank_source.getInt(m_src_detector, row_source) != o_detector)
+        continue;
+      auto const layer = bank_source.getInt(m_src_layer, row_source);
+      if(layer < 0 || layer >= static_cast<int>(m_layer_index.size()) || m_layer_index[layer] < 0)
+        continue;
+      linked_rows[pindex * num_layers + m_layer_index[layer]] = row_source;
+    }
+
+    // fill the linked particles' rows
+    for(auto const& row_particle : bank_particle.getRowList()) {
+      for(int l = 0; l < num_layers; l++) {
+        auto const row_source = linked_rows[row_particle * num_layers + l];
+        if(row_source < 0)
+          continue;
+        bank_result.putByte(i_found[l], row_particle, 1);
+        for(auto const& column_link : m_column_links)
+          CopyValue(bank_source, column_link.src_item, column_link.src_type, row_source,
+              bank_result, column_link.dst_items[l], column_link.dst_type, row_particle);
+      }
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void DetectorLinker::ResolveSourceColumns(hipo::bank const& bank_source) const
+  {
+    if(m_source_resolved.load(std::memory_order_acquire))
+      return;
+    std::lock_guard<std::mutex> const lock(m_source_mutex);
+    if(m_source_resolved.load(std::memory_order_relaxed))
+      return;
+    auto& schema         = const_cast<hipo::bank&>(bank_source).getSchema();
+    auto get_entry_order = [this, &schema](std::string const& name) {
+      if(!schema.exists(name)) {
+        m_log->Error("detector bank {:?} has no column {:?}; check the configuration of this algorithm", schema.getName(), name);
+        throw std::runtime_error("cannot link columns");
+      }
+      return schema.getEntryOrder(name.c_str());
+    };
+    m_src_pindex   = get_entry_order("pindex");
+    m_src_layer    = get_entry_order("layer");
+    m_src_detector = o_detector >= 0 ? get_entry_order("detector") : -1;
+    for(decltype(o_columns.size()) c = 0; c < o_columns.size(); c++) {
+      m_column_links[c].src_item = get_entry_order(o_columns[c]);
+      m_column_links[c].src_type = schema.getEntryType(m_column_links[c].src_item);
+    }
+    m_source_resolved.store(true, std::memory_order_release);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void DetectorLinker::CopyValue(
+      hipo::bank const& bank_source,
+      int const src_item,
+      int const src_type,
+      int const src_row,
+      hipo::bank& bank_result,
+      int const dst_item,
+      int const dst_type,
+      int const dst_row)
+  {
+    // integers are copied as `int64_t`, and floating-point numbers as `double`
+    auto is_real = [](int const type) { return type == hipo::kFloat || type == hipo::kDouble; };
+    if(is_real(src_type) || is_real(dst_type)) {
+      double const val = src_type == hipo::kFloat ? bank_source.getFloat(src_item, src_row)
+                       : src_type == hipo::kDouble ? bank_source.getDouble(src_item, src_row)
+                       : src_type == hipo::kLong   ? static_cast<double>(bank_source.getLong(src_item, src_row))
+                                                   : static_cast<double>(bank_source.getInt(src_item, src_row));
+      switch(dst_type) {
+      case hipo::kFloat: bank_result.putFloat(dst_item, dst_row, static_cast<float>(val)); break;
+      case hipo::kDouble: bank_result.putDouble(dst_item, dst_row, val); break;
+      case hipo::kLong: bank_result.putLong(dst_item, dst_row, static_cast<int64_t>(val)); break;
+      case hipo::kInt: bank_result.putInt(dst_item, dst_row, static_cast<int32_t>(val)); break;
+      case hipo::kShort: bank_result.putShort(dst_item, dst_row, static_cast<int16_t>(val)); break;
+      case hipo::kByte: bank_result.putByte(dst_item, dst_row, static_cast<int8_t>(val)); break;
+      }
+    }
+    else {
+      int64_t const val = src_type == hipo::kLong ? bank_source.getLong(src_item, src_row) : bank_source.getInt(src_item, src_row);
+      switch(dst_type) {
+      case hipo::kByte: bank_result.putByte(dst_item, dst_row, static_cast<int8_t>(val)); break;
+      case hipo::kShort: bank_result.putShort(dst_item, dst_row, static_cast<int16_t>(val)); break;
+      case hipo::kInt: bank_result.putInt(dst_item, dst_row, static_cast<int32_t>(val)); break;
+      case hipo::kLong: bank_result.putLong(dst_item, dst_row, val); break;
+      }
+    }
+  }
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "iguana/algorithms/Algorithm.h"
+
+#include <atomic>
+
+namespace iguana::clas12 {
+
+  /// @algo_brief{Generic algorithm to link the particle bank to a detector bank}
+  /// @algo_type_creator
+  ///
+  /// This algorithm reads a detector bank, such as `REC::Traj` or `REC::Calorimeter`, and produces a new bank with one row
+  /// per particle, holding the detector information for each particle in a set of layers. The new bank is the one registered
+  /// by the algorithm (see `REGISTER_IGUANA_ALGORITHM`), and its layout is defined in `src/iguana/bankdefs/iguana.json`.
+  /// For each linked layer, the new bank has the following columns, where `<prefix>` is the layer's prefix:
+  ///
+  /// - `<prefix>_found`: 1 if the particle has a row in this layer, 0 otherwise
+  /// - `<prefix>_<column>`: the value of `<column>` in the detector bank, for each of the configured columns
+  ///
+  /// The new bank is zero-filled, and if a particle has more than one row in a layer, the last one is used. The detector bank
+  /// is read in a single pass, so the cost is linear in the number of its rows.
+  ///
+  /// This algorithm is a base class, and is not in the `iguana::AlgorithmFactory`; instead, to link a detector bank, define the
+  /// new bank in `iguana.json` and a subclass of this algorithm which creates it, with a configuration file which describes
+  /// the link, as is done by `clas12::TrajLinker` and `clas12::CalorimeterLinker`. The subclass' configuration must set
+  /// the following options:
+  ///
+  /// - `source`: the detector bank to link to `REC::Particle`; it must have `pindex` and `layer` columns
+  /// - `detector`: only link the rows of this detector (see `iguana::DetectorType`), or -1 to link the rows of any detector;
+  ///   if not -1, the detector bank must have a `detector` column
+  /// - `layers`: the layers to link
+  /// - `prefixes`: the prefix of the created bank's columns for each layer, in the same order as `layers`
+  /// - `columns`: the detector bank columns to copy; for each layer, `<column>` is copied to `<prefix>_<column>` in the created bank
+  class DetectorLinker : public Algorithm
+  {
+
+      DEFINE_IGUANA_ALGORITHM(DetectorLinker, clas12::DetectorLinker)
+
+    protected: // hooks
+      void ConfigHook() override;
+      void StartHook(hipo::banklist& banks) override;
+      bool RunHook(hipo::banklist& banks) const override;
+
+    public:
+
+      /// @run_function
+      /// @param [in] bank_particle `REC::Particle`
+      /// @param [in] bank_source the detector bank
+      /// @param [out] bank_result the created bank
+      /// @run_function_returns_true
+      bool Run(
+          hipo::bank const& bank_particle,
+          hipo::bank const& bank_source,
+          hipo::bank& bank_result) const;
+
+    protected: // methods
+
+      /// Fill the created bank; call this from the `Run` function of subclasses
+      /// @param [in] bank_particle `REC::Particle`
+      /// @param [in] bank_source the detector bank
+      /// @param [out] bank_result the created bank
+      void Link(
+          hipo::bank const& bank_particle,
+          hipo::bank const& bank_source,
+          hipo::bank& bank_result) const;
+
+    protected: // members
+
+      /// `hipo::banklist` indices
+      hipo::banklist::size_type b_particle;
+      hipo::banklist::size_type b_source;
+      hipo::banklist::size_type b_result;
+
+    private:
+
+      /// a column of the detector bank, copied to a column of the created bank for each layer
+      struct column_link_t
+      {
+          /// the detector bank column index
+          int src_item = -1;
+          /// the detector bank column type
+          int src_type = 0;
+          /// the created bank column index, for each layer
+          std::vector<int> dst_items;
+          /// the created bank column type
+          int dst_type = 0;
+      };
+
+      /// Resolve the column indices of the detector bank, unless they are already resolved; this is thread safe
+      /// @param bank_source the detector bank
+      void ResolveSourceColumns(hipo::bank const& bank_source) const noexcept(false);
+
+      /// Copy a value from the detector bank to the created bank, converting its type if needed
+      static void CopyValue(
+          hipo::bank const& bank_source,
+          int const src_item,
+          int const src_type,
+          int const src_row,
+          hipo::bank& bank_result,
+          int const dst_item,
+          int const dst_type,
+          int const dst_row);
+
+      /// Configuration options
+      std::string o_source;
+      int o_detector;
+      std::vector<int> o_layers;
+      std::vector<std::string> o_prefixes;
+      std::vector<std::string> o_columns;
+
+      /// for each layer number, the index of `o_layers`, or -1 if it is not linked
+      std::vector<int> m_layer_index;
+
+      /// the created bank name
+      std::string m_result_bank_name;
+
+      // `b_result` bank item indices
+      int i_pindex;
+      std::vector<int> i_found;
+      /// every column of the created bank except `pindex`, with its type, for zero-filling with `FillBankRows`
+      std::vector<std::pair<int, int>> m_result_columns;
+
+      /// detector bank column indices, which are resolved from the first detector bank; they are set in `StartHook`, or
+      /// by the first `Run` call if the algorithm was started without a `hipo::banklist`
+      mutable std::atomic<bool> m_source_resolved{false};
+      mutable std::mutex m_source_mutex;
+      mutable int m_src_pindex   = -1;
+      mutable int m_src_detector = -1;
+      mutable int m_src_layer    = -1;
+      mutable std::vector<column_link_t> m_column_links;
+  };
+
+}
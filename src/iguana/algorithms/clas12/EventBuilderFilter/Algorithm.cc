@@ -14,6 +14,7 @@ namespace iguana::clas12 {
   {
     // get expected bank indices
     b_particle = GetBankIndex(banks, o_particle_bank);
+    ResolveBankColumns(banks, b_particle, c_pid);
   }
 
 
@@ -22,27 +23,54 @@ namespace iguana::clas12 {
     return Run(GetBank(banks, b_particle, o_particle_bank));
   }
 
+  std::optional<hipo::banklist::size_type> EventBuilderFilter::GetRowFilterBank() const
+  {
+    return b_particle;
+  }
+
+  row_kernel_t EventBuilderFilter::MakeRowKernel(hipo::banklist& banks) const
+  {
+    ResolveBankColumns(GetBank(banks, b_particle, o_particle_bank), c_pid);
+    return ScratchArena::Get().Make([this](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      FilterRows(bank, rows, accept, false);
+    });
+  }
+
   bool EventBuilderFilter::Run(hipo::bank& particleBank) const
   {
+    ResolveBankColumns(particleBank, c_pid);
+
     // dump the bank
-    ShowBank(particleBank, Logger::Header("INPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "INPUT PARTICLES");
 
     // filter the input bank for requested PDG code(s)
-    particleBank.getMutableRowList().filter([this](auto bank, auto row) {
-      auto pid    = bank.getInt("pid", row);
-      auto accept = Filter(pid);
-      m_log->Debug("input PID {} -- accept = {}", pid, accept);
-      return accept ? 1 : 0;
+    auto const log_rows = m_log->IsEnabled(Logger::debug); // check once, rather than for each row
+    FilterRowList(particleBank, [this, log_rows](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      FilterRows(bank, rows, accept, log_rows);
     });
 
     // dump the modified bank
-    ShowBank(particleBank, Logger::Header("OUTPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
 
     // return false if everything is filtered out
     return !particleBank.getRowList().empty();
   }
 
 
+  void EventBuilderFilter::FilterRows(hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept, bool const log_rows) const
+  {
+    thread_local std::vector<int32_t> pids; // reused, to avoid reallocation for each event
+    c_pid.Gather(bank, rows, pids);
+    for(decltype(rows.size()) i = 0; i < rows.size(); i++) {
+      if(accept[i] == 0)
+        continue;
+      auto const pass = Filter(pids[i]);
+      if(log_rows)
+        m_log->Debug("input PID {} -- accept = {}", pids[i], pass);
+      accept[i] = pass ? 1 : 0;
+    }
+  }
+
   bool EventBuilderFilter::Filter(int const pid) const
   {
     return o_pids.find(pid) != o_pids.end();
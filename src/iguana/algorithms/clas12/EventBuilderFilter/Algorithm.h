@@ -17,6 +17,8 @@ namespace iguana::clas12 {
       void ConfigHook() override;
       void StartHook(hipo::banklist& banks) override;
       bool RunHook(hipo::banklist& banks) const override;
+      std::optional<hipo::banklist::size_type> GetRowFilterBank() const override;
+      row_kernel_t MakeRowKernel(hipo::banklist& banks) const override;
 
     public:
 
@@ -38,9 +40,19 @@ namespace iguana::clas12 {
 
     private:
 
+      /// Row filter kernel: clear the accept flags of the rows whose PDG is not one the user wants
+      /// @param bank the particle bank
+      /// @param rows the bank's row list
+      /// @param accept the rows' accept flags
+      /// @param log_rows if `true`, print the decision for each row
+      void FilterRows(hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept, bool const log_rows) const;
+
       /// `hipo::banklist` index for the particle bank
       hipo::banklist::size_type b_particle;
 
+      /// particle bank column handles
+      BankColumn<int32_t> c_pid{"pid"};
+
       // Configuration options
       std::string o_particle_bank;
       std::set<int> o_pids;
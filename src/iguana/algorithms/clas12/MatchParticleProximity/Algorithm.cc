@@ -1,6 +1,10 @@
 #include "Algorithm.h"
 #include "iguana/algorithms/physics/Tools.h"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 namespace iguana::clas12 {
 
   REGISTER_IGUANA_ALGORITHM(MatchParticleProximity, "clas12::MatchParticleProximity");
@@ -9,8 +13,9 @@ namespace iguana::clas12 {
 
   void MatchParticleProximity::ConfigHook()
   {
-    o_bank_a = GetOptionScalar<std::string>({"bank_a"});
-    o_bank_b = GetOptionScalar<std::string>({"bank_b"});
+    o_bank_a        = GetOptionScalar<std::string>({"bank_a"});
+    o_bank_b        = GetOptionScalar<std::string>({"bank_b"});
+    o_max_proximity = GetOptionScalar<double>({"max_proximity"});
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -18,8 +23,8 @@ namespace iguana::clas12 {
   void MatchParticleProximity::StartHook(hipo::banklist& banks)
   {
     // banklist indices
-    b_bank_a = GetBankIndex(banks, o_bank_a);
-    b_bank_b = GetBankIndex(banks, o_bank_b);
+    b_bank_a = GetBankIndex(banks, o_bank_a, BankAccess::read);
+    b_bank_b = GetBankIndex(banks, o_bank_b, BankAccess::read);
 
     // create the output bank
     auto result_schema = CreateBank(banks, b_result, "clas12::MatchParticleProximity");
@@ -44,12 +49,61 @@ namespace iguana::clas12 {
       hipo::bank& result_bank) const
   {
     result_bank.reset(); // IMPORTANT: always first `reset` the created bank(s)
+    ScratchArena::Scope const scratch_scope;
 
-    ShowBank(bank_a, Logger::Header("INPUT BANK A"));
-    ShowBank(bank_b, Logger::Header("INPUT BANK B"));
+    ShowBankWithHeader(bank_a, "INPUT BANK A");
+    ShowBankWithHeader(bank_b, "INPUT BANK B");
 
     // output rows
-    std::vector<MatchParticleProximityVars> result_rows;
+    std::pmr::vector<MatchParticleProximityVars> result_rows(&ScratchArena::Get());
+
+    // get the angles of ALL bank-B particles, grouped by PID; the particles of each group are ordered by row
+    thread_local std::vector<particle_t> particles_b; // reused, to avoid reallocation for each event
+    particles_b.clear();
+    for(int row_b = 0; row_b < bank_b.getRows(); row_b++) {
+      ROOT::Math::XYZVector p_b(
+          bank_b.getFloat("px", row_b),
+          bank_b.getFloat("py", row_b),
+          bank_b.getFloat("pz", row_b));
+      particles_b.push_back({row_b, bank_b.getInt("pid", row_b), -1, p_b.theta(), p_b.phi()});
+    }
+    std::stable_sort(particles_b.begin(), particles_b.end(), [](auto const& a, auto const& b) { return a.pid < b.pid; });
+
+    // bin each group's particles in (theta,phi), unless the group is small; for each binned group, `cell_offsets` has
+    // the range of its particles in `cell_particles` for each bin, in which they are ordered by bin, then by row
+    int const num_cells = NUM_THETA_BINS * NUM_PHI_BINS;
+    thread_local std::vector<group_t> groups_b;
+    thread_local std::vector<std::size_t> cell_offsets;
+    thread_local std::vector<std::size_t> cell_particles;
+    groups_b.clear();
+    cell_offsets.clear();
+    cell_particles.resize(particles_b.size());
+    for(std::size_t first = 0; first < particles_b.size();) {
+      group_t group{particles_b[first].pid, first, first, false, 0};
+      bool finite = true;
+      for(; group.last < particles_b.size() && particles_b[group.last].pid == group.pid; group.last++)
+        finite = finite && std::isfinite(particles_b[group.last].theta) && std::isfinite(particles_b[group.last].phi);
+      group.binned = finite && group.last - group.first >= MIN_BINNED_GROUP_SIZE;
+      if(group.binned) {
+        group.cell_offsets = cell_offsets.size();
+        cell_offsets.resize(cell_offsets.size() + num_cells + 1, 0);
+        auto offsets = cell_offsets.begin() + group.cell_offsets;
+        for(auto i = group.first; i < group.last; i++) {
+          particles_b[i].cell = GetCell(particles_b[i].theta, particles_b[i].phi);
+          offsets[particles_b[i].cell + 1]++;
+        }
+        std::partial_sum(offsets, offsets + num_cells + 1, offsets);
+        std::pmr::vector<std::size_t> fill(offsets, offsets + num_cells, &ScratchArena::Get());
+        for(auto i = group.first; i < group.last; i++)
+          cell_particles[group.first + fill[particles_b[i].cell]++] = i;
+      }
+      groups_b.push_back(group);
+      first = group.last;
+    }
+
+    // the smallest bin width, which bounds the proximity of particles in farther bins
+    double const min_cell_width = std::min(M_PI / NUM_THETA_BINS, 2 * M_PI / NUM_PHI_BINS);
+    double const max_proximity  = o_max_proximity >= 0 ? o_max_proximity : std::numeric_limits<double>::infinity();
 
     // loop over ALL bank-A particles, to find matching bank-B particles
     for(int row_a = 0; row_a < bank_a.getRows(); row_a++) {
@@ -67,32 +121,61 @@ namespace iguana::clas12 {
       auto theta_a = p_a.theta();
       auto phi_a   = p_a.phi();
 
-      // loop over ALL bank-B particles, and find the one with the smallest proximity to
-      // the current bank-A particle
-      for(int row_b = 0; row_b < bank_b.getRows(); row_b++) {
-        // PID must match
-        if(pid_a == bank_b.getInt("pid", row_b)) {
-          // particle info
-          ROOT::Math::XYZVector p_b(
-              bank_b.getFloat("px", row_b),
-              bank_b.getFloat("py", row_b),
-              bank_b.getFloat("pz", row_b));
-          auto theta_b = p_b.theta();
-          auto phi_b   = p_b.phi();
-          // calculate Euclidean distance in (theta,phi) space
-          auto prox = std::hypot(
-              physics::tools::AdjustAnglePi(theta_b - theta_a),
-              physics::tools::AdjustAnglePi(phi_b - phi_a));
-          // if smallest proximity, this is the best one
-          if(min_prox < 0 || prox < min_prox) {
-            min_prox = prox;
-            pindex_b = row_b;
+      // find the bank-B particles with the same PID
+      auto group = std::lower_bound(groups_b.begin(), groups_b.end(), pid_a, [](group_t const& g, int const pid) { return g.pid < pid; });
+      if(group == groups_b.end() || group->pid != pid_a)
+        continue;
+
+      // compare to a bank-B particle; if it has the smallest proximity, it is the best one, and ties are
+      // resolved by the smallest row, so the result does not depend on the order in which particles are compared
+      auto compare = [&](particle_t const& particle_b) {
+        auto prox = GetProximity(theta_a, phi_a, particle_b.theta, particle_b.phi);
+        if(pindex_b < 0 || prox < min_prox || (prox == min_prox && particle_b.row < pindex_b)) {
+          min_prox = prox;
+          pindex_b = particle_b.row;
+        }
+      };
+
+      if(!group->binned || !std::isfinite(theta_a) || !std::isfinite(phi_a)) {
+        // compare to ALL of them
+        for(auto i = group->first; i < group->last; i++)
+          compare(particles_b[i]);
+      }
+      else {
+        // search bins in rings of increasing distance from this particle's bin; a particle in ring `r` is at least
+        // `(r-1) * min_cell_width` away, so stop once that exceeds the best proximity; one more ring than needed is
+        // searched, as a margin for rounding at the bin edges
+        auto offsets           = cell_offsets.begin() + group->cell_offsets;
+        auto const cell_a      = GetCell(theta_a, phi_a);
+        auto const theta_bin_a = cell_a / NUM_PHI_BINS;
+        auto const phi_bin_a   = cell_a % NUM_PHI_BINS;
+        int const max_ring     = std::max(NUM_THETA_BINS - 1, NUM_PHI_BINS / 2); // the farthest ring, which includes every bin
+        auto search_cell       = [&](int const theta_bin, int const phi_bin) {
+          if(theta_bin < 0 || theta_bin >= NUM_THETA_BINS)
+            return;
+          auto const cell = theta_bin * NUM_PHI_BINS + (phi_bin % NUM_PHI_BINS + NUM_PHI_BINS) % NUM_PHI_BINS; // phi wraps around
+          for(auto i = offsets[cell]; i < offsets[cell + 1]; i++)
+            compare(particles_b[cell_particles[group->first + i]]);
+        };
+        for(int ring = 0; ring <= max_ring; ring++) {
+          auto const bound = (ring - 2) * min_cell_width;
+          if(bound > max_proximity || (pindex_b >= 0 && bound > min_prox))
+            break;
+          for(int dt = -ring; dt <= ring; dt++) {
+            if(dt == -ring || dt == ring) { // top and bottom of the ring
+              for(int dp = -ring; dp <= ring; dp++)
+                search_cell(theta_bin_a + dt, phi_bin_a + dp);
+            }
+            else { // sides of the ring
+              search_cell(theta_bin_a + dt, phi_bin_a - ring);
+              search_cell(theta_bin_a + dt, phi_bin_a + ring);
+            }
           }
         }
       }
 
       // if a match was found, populate the output bank
-      if(pindex_b >= 0)
+      if(pindex_b >= 0 && (o_max_proximity < 0 || min_prox <= o_max_proximity))
         result_rows.push_back({
             .pindex_a  = row_a,
             .pindex_b  = pindex_b,
@@ -109,10 +192,29 @@ namespace iguana::clas12 {
       result_bank.putDouble(i_proximity, row, result_row.proximity);
     }
 
-    ShowBank(result_bank, Logger::Header("CREATED BANK"));
+    ShowBankWithHeader(result_bank, "CREATED BANK");
     return result_bank.getRows() > 0;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
 
+  int MatchParticleProximity::GetCell(double const theta, double const phi)
+  {
+    auto const theta_bin = std::clamp(static_cast<int>(theta / M_PI * NUM_THETA_BINS), 0, NUM_THETA_BINS - 1);
+    auto const phi_bin   = std::clamp(static_cast<int>((phi + M_PI) / (2 * M_PI) * NUM_PHI_BINS), 0, NUM_PHI_BINS - 1);
+    return theta_bin * NUM_PHI_BINS + phi_bin;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  double MatchParticleProximity::GetProximity(double const theta_a, double const phi_a, double const theta_b, double const phi_b)
+  {
+    // calculate Euclidean distance in (theta,phi) space
+    return std::hypot(
+        physics::tools::AdjustAnglePi(theta_b - theta_a),
+        physics::tools::AdjustAnglePi(phi_b - phi_a));
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
 }
@@ -17,6 +17,11 @@ namespace iguana::clas12 {
   ///
   /// You may also use this algorithm to match `MC::Lund` to `MC::Particle`; in this case, expect match proximity
   /// values to be very close to zero.
+  ///
+  /// Only particles with the same PID are matched. To avoid comparing every pair of particles, the bank-B particles
+  /// are grouped by PID and binned in (theta,phi), and each bank-A particle searches the nearest bins first, stopping once
+  /// no farther bin can have a closer particle. Use the `max_proximity` option to only accept matches within a maximum
+  /// proximity, which also limits this search.
   class MatchParticleProximity : public Algorithm
   {
 
@@ -41,9 +46,51 @@ namespace iguana::clas12 {
 
     private:
 
+      /// a bank-B particle
+      struct particle_t {
+          /// the bank row
+          int row;
+          /// the PID
+          int pid;
+          /// the (theta,phi) bin
+          int cell;
+          /// the polar angle
+          double theta;
+          /// the azimuthal angle
+          double phi;
+      };
+
+      /// bank-B particles with the same PID
+      struct group_t {
+          /// the PID
+          int pid;
+          /// the range of this group's particles in the list of particles, which is ordered by PID, then by row
+          std::size_t first;
+          std::size_t last;
+          /// if true, the particles are binned in (theta,phi); otherwise, there are too few, or some of their angles are not finite
+          bool binned;
+          /// if binned, the offset of this group's bin offsets in the list of bin offsets
+          std::size_t cell_offsets;
+      };
+
+      /// @returns the (theta,phi) bin of a direction
+      /// @param theta the polar angle, in @latex{[0,\pi]}
+      /// @param phi the azimuthal angle, in @latex{(-\pi,\pi]}
+      static int GetCell(double const theta, double const phi);
+
+      /// @returns the proximity between two directions
+      static double GetProximity(double const theta_a, double const phi_a, double const theta_b, double const phi_b);
+
+      /// number of bins in theta and phi
+      static int const NUM_THETA_BINS = 32;
+      static int const NUM_PHI_BINS   = 64;
+      /// groups with fewer particles than this are not binned, since comparing all of them is faster
+      static std::size_t const MIN_BINNED_GROUP_SIZE = 16;
+
       // config options
       std::string o_bank_a;
       std::string o_bank_b;
+      double o_max_proximity;
 
       // banklist indices
       hipo::banklist::size_type b_bank_a;
@@ -1,46 +1,91 @@
 #include "Algorithm.h"
 #include "iguana/algorithms/TypeDefs.h"
-#include "models/RGA_inbending_pass1.cpp"
-#include "models/RGA_inbending_pass2.cpp"
-#include "models/RGA_outbending_pass1.cpp"
-#include "models/RGA_outbending_pass2.cpp"
-#include "models/RGC_Summer2022_pass1.cpp"
 
 namespace iguana::clas12 {
 
   REGISTER_IGUANA_ALGORITHM(PhotonGBTFilter);
 
   // Map for the GBT Models to use depending on pass and run number
-  std::map<std::tuple<int, int, int>, std::function<double(std::vector<float> const&)>> const PhotonGBTFilter::modelMap = {
-      {{5032, 5332, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass1(data); }}, // Fall2018 RGA Inbending
-      {{5032, 5332, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass2(data); }}, // Fall2018 RGA Inbending
-      {{5333, 5666, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_outbending_pass1(data); }}, // Fall2018 RGA Outbending
-      {{5333, 5666, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_outbending_pass2(data); }}, // Fall2018 RGA Outbending
-      {{6616, 6783, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass1(data); }}, // Spring2019 RGA Inbending
-      {{6616, 6783, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass2(data); }}, // Spring2019 RGA Inbending
-      {{6156, 6603, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass1(data); }}, // Spring2019 RGB Inbending
-      {{6156, 6603, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass2(data); }}, // Spring2019 RGB Inbending
-      {{11093, 11283, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_outbending_pass1(data); }}, // Fall2019 RGB Outbending
-      {{11093, 11283, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_outbending_pass2(data); }}, // Fall2019 RGB Outbending
-      {{11284, 11300, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass1(data); }}, // Fall2019 RGB BAND Inbending
-      {{11284, 11300, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass2(data); }}, // Fall2019 RGB BAND Inbending
-      {{11323, 11571, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass1(data); }}, // Spring2020 RGB Inbending
-      {{11323, 11571, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass2(data); }}, // Spring2020 RGB Inbending
-      {{16042, 16772, 1}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGC_Summer2022_pass1(data); }}, // Summer2022 RGC Inbending
-      {{16042, 16772, 2}, [](std::vector<float> const& data) { return ApplyCatboostModel_RGC_Summer2022_pass1(data); }} // Summer2022 RGC Inbending (no pass2 currently)
+  std::map<std::tuple<int, int, int>, std::string> const PhotonGBTFilter::modelMap = {
+      {{5032, 5332, 1}, "RGA_inbending_pass1"}, // Fall2018 RGA Inbending
+      {{5032, 5332, 2}, "RGA_inbending_pass2"}, // Fall2018 RGA Inbending
+      {{5333, 5666, 1}, "RGA_outbending_pass1"}, // Fall2018 RGA Outbending
+      {{5333, 5666, 2}, "RGA_outbending_pass2"}, // Fall2018 RGA Outbending
+      {{6616, 6783, 1}, "RGA_inbending_pass1"}, // Spring2019 RGA Inbending
+      {{6616, 6783, 2}, "RGA_inbending_pass2"}, // Spring2019 RGA Inbending
+      {{6156, 6603, 1}, "RGA_inbending_pass1"}, // Spring2019 RGB Inbending
+      {{6156, 6603, 2}, "RGA_inbending_pass2"}, // Spring2019 RGB Inbending
+      {{11093, 11283, 1}, "RGA_outbending_pass1"}, // Fall2019 RGB Outbending
+      {{11093, 11283, 2}, "RGA_outbending_pass2"}, // Fall2019 RGB Outbending
+      {{11284, 11300, 1}, "RGA_inbending_pass1"}, // Fall2019 RGB BAND Inbending
+      {{11284, 11300, 2}, "RGA_inbending_pass2"}, // Fall2019 RGB BAND Inbending
+      {{11323, 11571, 1}, "RGA_inbending_pass1"}, // Spring2020 RGB Inbending
+      {{11323, 11571, 2}, "RGA_inbending_pass2"}, // Spring2020 RGB Inbending
+      {{16042, 16772, 1}, "RGC_Summer2022_pass1"}, // Summer2022 RGC Inbending
+      {{16042, 16772, 2}, "RGC_Summer2022_pass1"} // Summer2022 RGC Inbending (no pass2 currently)
   };
 
+  std::map<PhotonGBTFilter::loaded_model_key_t, std::weak_ptr<CatboostModel const>> PhotonGBTFilter::s_loaded_models;
+  std::mutex PhotonGBTFilter::s_loaded_models_mutex;
+
   void PhotonGBTFilter::ConfigHook()
   {
-    o_pass      = GetOptionScalar<int>({"pass"});
-    o_threshold = GetOptionScalar<double>({"threshold"});
+    o_pass       = GetOptionScalar<int>({"pass"});
+    o_threshold  = GetOptionScalar<double>({"threshold"});
+    o_model      = GetOptionScalar<std::string>({"model"});
+    o_huge_pages = GetOptionScalar<int>({"huge_pages"}) != 0;
+
+    auto leaf_precision_str = GetOptionScalar<std::string>({"leaf_precision"});
+    if(leaf_precision_str == "float64")
+      o_leaf_precision = CatboostModel::LeafPrecision::float64;
+    else if(leaf_precision_str == "float32")
+      o_leaf_precision = CatboostModel::LeafPrecision::float32;
+    else if(leaf_precision_str == "fixed16")
+      o_leaf_precision = CatboostModel::LeafPrecision::fixed16;
+    else {
+      m_log->Error("Unknown leaf precision {:?}", leaf_precision_str);
+      throw std::runtime_error("Start failed");
+    }
+
+    // with early exits, the trees of a photon's model are no longer walked once its prediction is certain to be below, or above,
+    // the threshold; the raw score bounds are those of predictions just off the threshold, so rounding cannot change a decision
+    o_early_exit = GetOptionScalar<int>({"early_exit"}) != 0;
+    double const margin = 1e-9;
+    m_score_lower       = -std::numeric_limits<double>::infinity();
+    m_score_upper       = std::numeric_limits<double>::infinity();
+    if(o_early_exit && o_threshold - margin > 0 && o_threshold + margin < 1) {
+      m_score_lower = std::log((o_threshold - margin) / (1 - (o_threshold - margin)));
+      m_score_upper = std::log((o_threshold + margin) / (1 - (o_threshold + margin)));
+    }
   }
 
   void PhotonGBTFilter::StartHook(hipo::banklist& banks)
   {
     b_particle    = GetBankIndex(banks, "REC::Particle");
-    b_calorimeter = GetBankIndex(banks, "REC::Calorimeter");
-    b_config      = GetBankIndex(banks, "RUN::config");
+    b_calorimeter = GetBankIndex(banks, "REC::Calorimeter", BankAccess::read);
+    b_config      = GetBankIndex(banks, "RUN::config", BankAccess::read);
+    ResolveBankColumns(banks, b_particle, c_px, c_py, c_pz, c_pid);
+    ResolveBankColumns(banks, b_calorimeter, c_calo_pindex, c_calo_x, c_calo_y, c_calo_z, c_calo_m2u, c_calo_m2v, c_calo_layer, c_calo_energy);
+
+    // list the models for this pass; they are loaded when they are first used
+    m_models.clear();
+    m_model_ranges.clear();
+    auto const AddModel = [this](std::string const& file_name) {
+      auto& lazy_model     = m_models[file_name];
+      lazy_model.file_name = file_name;
+      return &lazy_model;
+    };
+    auto const ModelFile = [](std::string const& model_name) { return "algorithms/clas12/PhotonGBTFilter/models/" + model_name + ".bin"; };
+    if(o_model.empty()) {
+      for(auto const& [key, model_name] : modelMap) {
+        auto const& [first_run, last_run, pass] = key;
+        if(pass == o_pass)
+          m_model_ranges.push_back({first_run, last_run, AddModel(ModelFile(model_name))});
+      }
+      m_default_model = AddModel(ModelFile("RGA_inbending_pass1"));
+    }
+    else
+      m_default_model = AddModel(o_model);
   }
 
   bool PhotonGBTFilter::RunHook(hipo::banklist& banks) const
@@ -56,27 +101,118 @@ namespace iguana::clas12 {
       hipo::bank const& caloBank,
       hipo::bank const& configBank) const
   {
+    ScratchArena::Scope const scratch_scope;
+    ResolveBankColumns(particleBank, c_px, c_py, c_pz, c_pid);
+    ResolveBankColumns(caloBank, c_calo_pindex, c_calo_x, c_calo_y, c_calo_z, c_calo_m2u, c_calo_m2v, c_calo_layer, c_calo_energy);
     int runnum = configBank.getInt("run", 0);
 
+    // dump the bank
+    ShowBankWithHeader(particleBank, "INPUT PARTICLES");
+
+    // Compute the features of each photon in the particleBank, then classify them all at once
+    std::pmr::vector<int> photons(&ScratchArena::Get());
+    std::pmr::vector<float> input_data(&ScratchArena::Get());
+    CollectPhotons(particleBank, caloBank, photons, input_data);
+    std::pmr::vector<uint8_t> signal(photons.size(), &ScratchArena::Get());
+    if(!photons.empty()) // the model is only needed, and so loaded, for events with photons
+      ClassifyPhotons(GetModel(runnum), input_data.data(), photons.size(), signal.data());
+    ApplyDecisions(particleBank, photons, signal.data());
+
+    // dump the modified bank
+    ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
+    return !particleBank.getRowList().empty();
+  }
+
+  void PhotonGBTFilter::RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const
+  {
+    // the photons of the whole batch are classified together, so that each model's trees are walked once per batch,
+    // rather than once per event; since events may be from different runs, the photons are grouped by model
+    struct model_photons_t {
+        std::pmr::vector<float> input_data{&ScratchArena::Get()};
+        std::pmr::vector<uint8_t> signal{&ScratchArena::Get()};
+        std::size_t num_photons = 0;
+    };
+    struct event_photons_t {
+        decltype(batch.size()) event;
+        model_photons_t* model_photons = nullptr;
+        std::size_t first              = 0;
+        std::pmr::vector<int> photons{&ScratchArena::Get()};
+    };
+    std::pmr::map<CatboostModel const*, model_photons_t> model_photons_map(&ScratchArena::Get());
+    std::pmr::vector<event_photons_t> event_photons_list(&ScratchArena::Get());
+    event_photons_list.reserve(batch.size());
+    std::pmr::vector<float> event_input_data(&ScratchArena::Get());
+
+    // compute the features of each event's photons
+    for(decltype(batch.size()) i = 0; i < batch.size(); i++) {
+      if(!accepted[i])
+        continue;
+      auto const& particleBank = GetBank(batch[i], b_particle, "REC::Particle");
+      auto const& caloBank     = GetBank(batch[i], b_calorimeter, "REC::Calorimeter");
+      auto const& configBank   = GetBank(batch[i], b_config, "RUN::config");
+      ResolveBankColumns(particleBank, c_px, c_py, c_pz, c_pid);
+      ResolveBankColumns(caloBank, c_calo_pindex, c_calo_x, c_calo_y, c_calo_z, c_calo_m2u, c_calo_m2v, c_calo_layer, c_calo_energy);
+      ShowBankWithHeader(particleBank, "INPUT PARTICLES");
+      auto& event_photons = event_photons_list.emplace_back();
+      event_photons.event = i;
+      event_input_data.clear();
+      CollectPhotons(particleBank, caloBank, event_photons.photons, event_input_data);
+      // the model is only needed, and so loaded, for events with photons
+      if(event_photons.photons.empty())
+        continue;
+      auto& model_photons = model_photons_map[&GetModel(configBank.getInt("run", 0))];
+      event_photons.model_photons = &model_photons;
+      event_photons.first         = model_photons.num_photons;
+      model_photons.input_data.insert(model_photons.input_data.end(), event_input_data.begin(), event_input_data.end());
+      model_photons.num_photons += event_photons.photons.size();
+    }
+
+    // classify the photons of each model
+    for(auto& [model, model_photons] : model_photons_map) {
+      model_photons.signal.resize(model_photons.num_photons);
+      ClassifyPhotons(*model, model_photons.input_data.data(), model_photons.num_photons, model_photons.signal.data());
+    }
+
+    // filter each event
+    for(auto const& event_photons : event_photons_list) {
+      auto& particleBank = GetBank(batch[event_photons.event], b_particle, "REC::Particle");
+      auto const signal  = event_photons.model_photons != nullptr ? event_photons.model_photons->signal.data() + event_photons.first : nullptr;
+      ApplyDecisions(particleBank, event_photons.photons, signal);
+      ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
+      accepted[event_photons.event] = !particleBank.getRowList().empty();
+    }
+  }
+
+  void PhotonGBTFilter::CollectPhotons(hipo::bank const& particleBank, hipo::bank const& caloBank, std::pmr::vector<int>& photons, std::pmr::vector<float>& input_data) const
+  {
     // Get CaloMap for the event
     auto calo_map = GetCaloMap(caloBank);
 
-    // dump the bank
-    ShowBank(particleBank, Logger::Header("INPUT PARTICLES"));
-
-    // Loop over each photon in the particleBank to classify it
+    // Loop over each photon in the particleBank to compute its features
     // Here we loop over the particleBank RowList
     // This ensures we are only concerned with filtering photons that passed upstream filters
-    particleBank.getMutableRowList().filter([this, &caloBank, &calo_map, runnum](auto bank, auto row) {
-      auto pid = bank.getInt("pid", row);
-      if(pid != 22)
-        return true;
-      return Filter(bank, caloBank, calo_map, row, runnum);
-    });
+    auto const& rows = particleBank.getRowList();
+    thread_local std::vector<int32_t> pids; // reused, to avoid reallocation for each event
+    c_pid.Gather(particleBank, rows, pids);
+    for(decltype(rows.size()) i = 0; i < rows.size(); i++) {
+      if(pids[i] == 22 && ComputeFeatures(particleBank, calo_map, rows[i], input_data))
+        photons.push_back(static_cast<int>(i));
+    }
+  }
 
-    // dump the modified bank
-    ShowBank(particleBank, Logger::Header("OUTPUT PARTICLES"));
-    return !particleBank.getRowList().empty();
+  void PhotonGBTFilter::ApplyDecisions(hipo::bank& particleBank, std::pmr::vector<int> const& photons, uint8_t const* signal) const
+  {
+    FilterRowList(particleBank, [this, &photons, signal](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      // reject every photon, except those which passed the PID purity cuts and are signal
+      thread_local std::vector<int32_t> pids; // reused, to avoid reallocation for each event
+      c_pid.Gather(bank, rows, pids);
+      for(decltype(rows.size()) i = 0; i < rows.size(); i++) {
+        if(pids[i] == 22)
+          accept[i] = 0;
+      }
+      for(decltype(photons.size()) k = 0; k < photons.size(); k++)
+        accept[photons[k]] = signal[k];
+    });
   }
 
   bool PhotonGBTFilter::PidPurityPhotonFilter(float const E, float const Epcal, float const theta) const
@@ -98,20 +234,22 @@ namespace iguana::clas12 {
     return true;
   }
 
-  bool PhotonGBTFilter::Filter(hipo::bank const& particleBank, hipo::bank const& caloBank, std::map<int, PhotonGBTFilter::calo_row_data> calo_map, int const row, int const runnum) const
+  bool PhotonGBTFilter::ComputeFeatures(hipo::bank const& particleBank, calo_map_t const& calo_map, int const row, std::pmr::vector<float>& input_data) const
   {
 
     // Set variables native to the photon we are classifying
-    double gPx = particleBank.getFloat("px", row);
-    double gPy = particleBank.getFloat("py", row);
-    double gPz = particleBank.getFloat("pz", row);
+    double gPx = c_px.Get(particleBank, row);
+    double gPy = c_py.Get(particleBank, row);
+    double gPz = c_pz.Get(particleBank, row);
 
     // Set ML features intrinsic to the photon of interest
     double gE     = sqrt(gPx * gPx + gPy * gPy + gPz * gPz);
     double gTheta = acos(gPz / gE);
-    double gEpcal = calo_map[row].pcal_e;
-    double gm2u   = calo_map[row].pcal_m2u;
-    double gm2v   = calo_map[row].pcal_m2v;
+    auto calo_it  = calo_map.find(row);
+    auto calo_POI = calo_it != calo_map.end() ? calo_it->second : calo_row_data{};
+    double gEpcal = calo_POI.pcal_e;
+    double gm2u   = calo_POI.pcal_m2u;
+    double gm2v   = calo_POI.pcal_m2v;
 
     // Apply PID purity cuts on the photon
     // If they do not pass, then these photons are incompatible with the trained GBT model
@@ -177,7 +315,6 @@ namespace iguana::clas12 {
 
 
     // Get 3-vector that points to the photon of interest's location in the calorimeter
-    auto calo_POI              = calo_map.at(row);
     ROOT::Math::XYZVector vPOI = GetParticleCaloVector(calo_POI);
 
 
@@ -197,15 +334,15 @@ namespace iguana::clas12 {
         continue;
       auto calo_PART = calo_map.at(inner_row);
 
-      auto pid  = particleBank.getInt("pid", inner_row);
+      auto pid  = c_pid.Get(particleBank, inner_row);
       auto mass = particle::get(particle::mass, pid);
 
       // Skip over particle if its mass was undefined
       if(!mass.has_value())
         continue;
-      auto px = particleBank.getFloat("px", inner_row);
-      auto py = particleBank.getFloat("py", inner_row);
-      auto pz = particleBank.getFloat("pz", inner_row);
+      auto px = c_px.Get(particleBank, inner_row);
+      auto py = c_py.Get(particleBank, inner_row);
+      auto pz = c_pz.Get(particleBank, inner_row);
       auto p  = sqrt(px * px + py * py + pz * pz);
       auto E  = sqrt(p * p + mass.value() * mass.value());
       auto th = acos(pz / p);
@@ -306,11 +443,11 @@ namespace iguana::clas12 {
       }
     }
 
-    // Create and populate input_data vector for the ML model
-    std::vector<float> input_data = {
+    // Append this photon's features to the input_data for the ML model
+    input_data.insert(input_data.end(), {
         static_cast<float>(gE), static_cast<float>(gEpcal), static_cast<float>(gTheta),
         static_cast<float>(gm2u), static_cast<float>(gm2v), static_cast<float>(R_e),
-        static_cast<float>(dE_e)};
+        static_cast<float>(dE_e)});
 
 
     for(int i = 0; i < m_g; ++i)
@@ -353,31 +490,36 @@ namespace iguana::clas12 {
     input_data.push_back(static_cast<float>(num_photons_0_2));
     input_data.push_back(static_cast<float>(num_photons_0_35));
 
-    return ClassifyPhoton(input_data, runnum);
+    return true;
   }
 
-  bool PhotonGBTFilter::ClassifyPhoton(std::vector<float> const& input_data, int const runnum) const
+  void PhotonGBTFilter::ClassifyPhotons(CatboostModel const& model, float const* input_data, std::size_t const num_photons, uint8_t* signal) const
   {
-    auto modelFunction = getModelFunction(runnum);
-    double sigmoid_x   = modelFunction(input_data);
-    double prediction  = 1 / (1 + exp(-sigmoid_x));
-    return (prediction > o_threshold);
+    if(num_photons == 0)
+      return;
+    std::pmr::vector<double> sigmoid_x(num_photons, &ScratchArena::Get());
+    // scores of photons which exit early are infinite, so their predictions are 0 or 1
+    model.EvaluateBounded(input_data, num_photons, m_score_lower, m_score_upper, sigmoid_x.data());
+    for(std::size_t k = 0; k < num_photons; k++) {
+      double prediction = 1 / (1 + exp(-sigmoid_x[k]));
+      signal[k]         = (prediction > o_threshold) ? 1 : 0;
+    }
   }
 
-  std::map<int, PhotonGBTFilter::calo_row_data> PhotonGBTFilter::GetCaloMap(hipo::bank const& bank) const
+  PhotonGBTFilter::calo_map_t PhotonGBTFilter::GetCaloMap(hipo::bank const& bank) const
   {
-    std::map<int, PhotonGBTFilter::calo_row_data> calo_map;
+    calo_map_t calo_map(&ScratchArena::Get());
     // Loop over REC::Calorimeter rows
     // Here we use bank.getRows() to purposefully ignore upstream filters
     for(int row = 0; row < bank.getRows(); row++) {
-      auto pindex = bank.getShort("pindex", row);
-      auto x      = bank.getFloat("x", row);
-      auto y      = bank.getFloat("y", row);
-      auto z      = bank.getFloat("z", row);
-      auto m2u    = bank.getFloat("m2u", row);
-      auto m2v    = bank.getFloat("m2v", row);
-      auto layer  = bank.getInt("layer", row);
-      auto e      = bank.getFloat("energy", row);
+      auto pindex = c_calo_pindex.Get(bank, row);
+      auto x      = c_calo_x.Get(bank, row);
+      auto y      = c_calo_y.Get(bank, row);
+      auto z      = c_calo_z.Get(bank, row);
+      auto m2u    = c_calo_m2u.Get(bank, row);
+      auto m2v    = c_calo_m2v.Get(bank, row);
+      auto layer  = c_calo_layer.Get(bank, row);
+      auto e      = c_calo_energy.Get(bank, row);
 
       // Ensure an entry exists in the map for the given pindex
       if(calo_map.find(pindex) == calo_map.end()) {
@@ -427,18 +569,33 @@ namespace iguana::clas12 {
     return v;
   }
 
-  std::function<double(std::vector<float> const&)> PhotonGBTFilter::getModelFunction(int runnum) const
+  CatboostModel const& PhotonGBTFilter::GetModel(int runnum) const
   {
-
-    for(auto const& entry : modelMap) {
-      if(runnum >= std::get<0>(entry.first) && runnum <= std::get<1>(entry.first) && o_pass == std::get<2>(entry.first)) {
-        return entry.second;
-      }
+    for(auto const& model_range : m_model_ranges) {
+      if(runnum >= model_range.first_run && runnum <= model_range.last_run)
+        return LoadModel(*model_range.model);
     }
 
-    // Default to RGA inbending pass1 if no match found
-    m_log->Warn("Run Number {} with pass {} has no matching PhotonGBT model...Defaulting to RGA inbending pass1...", runnum, o_pass);
-    return [](std::vector<float> const& data) { return ApplyCatboostModel_RGA_inbending_pass1(data); };
+    // Default to RGA inbending pass1 if no match found, unless a model file was chosen for all runs
+    if(o_model.empty())
+      m_log->Warn("Run Number {} with pass {} has no matching PhotonGBT model...Defaulting to RGA inbending pass1...", runnum, o_pass);
+    return LoadModel(*m_default_model);
+  }
+
+  CatboostModel const& PhotonGBTFilter::LoadModel(lazy_model_t& lazy_model) const
+  {
+    std::call_once(lazy_model.loaded, [this, &lazy_model]() {
+      auto const file_path = GetConfig()->FindFile(lazy_model.file_name);
+      std::lock_guard<std::mutex> const lock(s_loaded_models_mutex);
+      auto& loaded_model = s_loaded_models[{file_path, o_leaf_precision, o_huge_pages}];
+      lazy_model.model   = loaded_model.lock();
+      if(!lazy_model.model) {
+        m_log->Debug("loading model {:?}", file_path);
+        lazy_model.model = std::make_shared<CatboostModel const>(CatboostModel::Load(file_path, o_huge_pages).Quantize(o_leaf_precision));
+        loaded_model     = lazy_model.model;
+      }
+    });
+    return *lazy_model.model;
   }
 
 }
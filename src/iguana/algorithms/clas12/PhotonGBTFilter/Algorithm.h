@@ -1,9 +1,14 @@
 #pragma once
 
+#include "CatboostModel.h"
 #include "iguana/algorithms/Algorithm.h"
 
 #include <Math/Vector3D.h>
 #include <Math/VectorUtil.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 namespace iguana::clas12 {
 
@@ -13,6 +18,8 @@ namespace iguana::clas12 {
   ///
   /// For each photon (labeled the photon of interest or POI), we obtain its intrinsic features (energy, angle, pcal edep, etc.) and features corresponding to its nearest neighbors (angle of proximity, energy difference, etc.). This requires the reading of both the REC::Particle and REC::Calorimeter banks. An input std::vector<float> is produced and passed to the pretrained GBT models, which yield a classification score between 0 and 1. An option variable `threshold` then determines the minimum photon `p-value` to survive the cut.
   ///
+  /// The models are installed with the configuration files, in `algorithms/clas12/PhotonGBTFilter/models`, and a model is memory-mapped when it is first used; the instances of this algorithm, such as its replicas for other threads, share each loaded model. Other models may be used without rebuilding Iguana: convert them with `convert_catboost_model.py`, then either choose one for all runs with the option `model`, or replace an installed model with one of the same name in your configuration directory.
+  ///
   /// @doc_config{clas12/PhotonGBTFilter}
   class PhotonGBTFilter : public Algorithm
   {
@@ -23,6 +30,7 @@ namespace iguana::clas12 {
       void ConfigHook() override;
       void StartHook(hipo::banklist& banks) override;
       bool RunHook(hipo::banklist& banks) const override;
+      void RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const override;
 
     public:
 
@@ -64,6 +72,9 @@ namespace iguana::clas12 {
           double ecout_m2v = 0;
       };
 
+      /// calorimeter data for each particle of an event, indexed by pindex; it uses the `ScratchArena`
+      using calo_map_t = std::pmr::map<int, calo_row_data>;
+
       /// Applies pid purity cuts to photons, compatible to how the GBT models are trained
       /// @param E energy of the photon
       /// @param Epcal energy the photon has deposited in the pre-shower calorimeter
@@ -71,27 +82,39 @@ namespace iguana::clas12 {
       /// @returns `true` if the photon passes the pid purity cuts, `false` otherwise
       bool PidPurityPhotonFilter(float const E, float const Epcal, float const theta) const;
 
-      /// Classifies the photon for a given event as signal or background
+      /// Computes the model features of the photons in the particle bank's row list which pass the PID purity cuts
       /// @param particleBank the REC::Particle hipo bank
       /// @param caloBank the REC::Calorimeter hipo bank
-      /// @param calo_map the std::map<> of calorimeter data for the event, indexed by pindex
-      /// @param row the row corresponding to the photon being classified
-      /// @param runnum the current run number
-      /// @returns `true` if the photon is to be considered signal, otherwise `false`
-      bool Filter(hipo::bank const& particleBank, hipo::bank const& caloBank, std::map<int, PhotonGBTFilter::calo_row_data> calo_map, int const row, int const runnum) const;
+      /// @param [out] photons the photons' indices in the particle bank's row list are appended here
+      /// @param [out] input_data the photons' features are appended here, one photon after another
+      void CollectPhotons(hipo::bank const& particleBank, hipo::bank const& caloBank, std::pmr::vector<int>& photons, std::pmr::vector<float>& input_data) const;
 
-
-      /// Calls the appropriate CatBoost model for the given run group, classifying the photon of interest
-      /// @param input_data the input features of the model
-      /// @param runnum the run number associated to the event
-      /// @returns `true` if the
-      bool ClassifyPhoton(std::vector<float> const& input_data, int const runnum) const;
+      /// Computes the model features of a photon, if it passes the PID purity cuts
+      /// @param particleBank the REC::Particle hipo bank
+      /// @param calo_map the map of calorimeter data for the event, indexed by pindex
+      /// @param row the row corresponding to the photon being classified
+      /// @param [out] input_data the photon's features are appended here
+      /// @returns `false` if the photon does not pass the PID purity cuts, in which case no features are appended
+      bool ComputeFeatures(hipo::bank const& particleBank, calo_map_t const& calo_map, int const row, std::pmr::vector<float>& input_data) const;
+
+      /// Classifies photons as signal or background, walking the model's trees once for all of them
+      /// @param model the CatBoost model for the photons' run
+      /// @param input_data the photons' features, one photon after another
+      /// @param num_photons the number of photons
+      /// @param [out] signal set to 1 for each photon which is signal, otherwise 0; it must have room for `num_photons` values
+      void ClassifyPhotons(CatboostModel const& model, float const* input_data, std::size_t const num_photons, uint8_t* signal) const;
+
+      /// Filters the particle bank's row list, removing the photons which are not signal
+      /// @param particleBank the REC::Particle hipo bank
+      /// @param photons the indices in the particle bank's row list of the photons which passed the PID purity cuts, from `CollectPhotons`
+      /// @param signal whether each of these photons is signal, from `ClassifyPhotons`
+      void ApplyDecisions(hipo::bank& particleBank, std::pmr::vector<int> const& photons, uint8_t const* signal) const;
 
 
       /// Gets calorimeter data for particles in the event
       /// @param bank the bank to get data from
       /// @returns a map with keys as particle indices (pindex) and values as calo_row_data structs
-      std::map<int, PhotonGBTFilter::calo_row_data> GetCaloMap(hipo::bank const& bank) const;
+      calo_map_t GetCaloMap(hipo::bank const& bank) const;
 
 
       /// Gets the calorimeter vector for a particle in the event
@@ -99,24 +122,96 @@ namespace iguana::clas12 {
       /// @returns a ROOT::Math::XYZVector with the coordinates of the particle in the calorimeter
       ROOT::Math::XYZVector GetParticleCaloVector(PhotonGBTFilter::calo_row_data calo_row) const;
 
-      /// Gets the model function for the run number
+      /// a model file, which is memory-mapped when the model is first used
+      struct lazy_model_t {
+          /// the model file name, which is found in the configuration file search path
+          std::string file_name;
+          std::once_flag loaded;
+          std::shared_ptr<CatboostModel const> model;
+      };
+
+      /// the key of a loaded model in `s_loaded_models`: the model file path, the leaf precision and whether huge pages were advised
+      using loaded_model_key_t = std::tuple<std::string, CatboostModel::LeafPrecision, bool>;
+
+      /// a run range and the model for it
+      struct model_range_t {
+          int first_run;
+          int last_run;
+          lazy_model_t* model;
+      };
+
+      /// Gets the model for the run number
       /// @param runnum the run of the associated event
-      /// @returns GBT function for the run period
-      std::function<double(std::vector<float> const&)> getModelFunction(int runnum) const;
+      /// @returns GBT model for the run period
+      CatboostModel const& GetModel(int runnum) const;
+
+      /// Gets a model, loading it if this is its first use; a model which is already loaded by another instance, such as
+      /// a replica for another thread, is shared rather than loaded again; this is thread safe
+      /// @param lazy_model the model
+      /// @returns the model
+      CatboostModel const& LoadModel(lazy_model_t& lazy_model) const noexcept(false);
 
       /// `hipo::banklist`
       hipo::banklist::size_type b_particle;
       hipo::banklist::size_type b_calorimeter;
       hipo::banklist::size_type b_config; // RUN::config
 
+      /// `REC::Particle` column handles
+      BankColumn<float> c_px{"px"};
+      BankColumn<float> c_py{"py"};
+      BankColumn<float> c_pz{"pz"};
+      BankColumn<int32_t> c_pid{"pid"};
+
+      /// `REC::Calorimeter` column handles
+      BankColumn<int16_t> c_calo_pindex{"pindex"};
+      BankColumn<float> c_calo_x{"x"};
+      BankColumn<float> c_calo_y{"y"};
+      BankColumn<float> c_calo_z{"z"};
+      BankColumn<float> c_calo_m2u{"m2u"};
+      BankColumn<float> c_calo_m2v{"m2v"};
+      BankColumn<int8_t> c_calo_layer{"layer"};
+      BankColumn<float> c_calo_energy{"energy"};
+
       /// Threshold value for model predictions
       double o_threshold = 0.78;
 
       /// Integer for the event reconstruction pass
       int o_pass = 1;
 
-      /// Map for the GBT Models to use depending on pass and run number
-      static std::map<std::tuple<int, int, int>, std::function<double(std::vector<float> const&)>> const modelMap;
+      /// If not empty, the model file to use for all runs, rather than the models chosen by `modelMap`
+      std::string o_model;
+
+      /// Whether to advise the kernel to back the models with huge pages
+      bool o_huge_pages = false;
+
+      /// Precision of the models' leaf values; the models' features are always quantized, which does not change the scores
+      CatboostModel::LeafPrecision o_leaf_precision = CatboostModel::LeafPrecision::float64;
+
+      /// Whether to stop walking a photon's trees once its decision is certain
+      bool o_early_exit = false;
+
+      /// With early exits, the raw scores below and above which a photon's decision is certain; otherwise, infinite
+      double m_score_lower = -std::numeric_limits<double>::infinity();
+      double m_score_upper = std::numeric_limits<double>::infinity();
+
+      /// Map for the GBT Models to use depending on pass and run number; the values are the names of the model files,
+      /// `models/<name>.bin`, in this algorithm's configuration directory
+      static std::map<std::tuple<int, int, int>, std::string> const modelMap;
+
+      /// the models which may be used, by file name; this is filled by `StartHook`, and models are loaded when they are first used,
+      /// so that only the models for the runs which are processed are read
+      std::map<std::string, lazy_model_t> m_models;
+
+      /// the run ranges of the models for this pass, from `modelMap`
+      std::vector<model_range_t> m_model_ranges;
+
+      /// the model for runs which are not in `m_model_ranges`
+      lazy_model_t* m_default_model = nullptr;
+
+      /// the models loaded by all instances of this algorithm, so that its replicas share one copy of each model's quantized tables;
+      /// a model is unloaded once no instance uses it
+      static std::map<loaded_model_key_t, std::weak_ptr<CatboostModel const>> s_loaded_models;
+      static std::mutex s_loaded_models_mutex;
   };
 
 }
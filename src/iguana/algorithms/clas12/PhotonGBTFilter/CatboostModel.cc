@@ -0,0 +1,990 @@
+#include "CatboostModel.h"
+#include "iguana/algorithms/ScratchArena.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// the vector kernels are compiled for their instruction sets with function attributes, and are only called if the CPU has them
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define IGUANA_CATBOOST_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace iguana::clas12 {
+
+  namespace {
+
+    /// the number of samples which the kernels handle together; the block size must be a multiple of it
+    constexpr std::size_t lane_group_size = 32;
+
+    /// the deepest tree for which the vector kernels compute leaf indices, one byte per sample
+    constexpr unsigned int max_vector_tree_depth = 8;
+
+    /// @brief tree splits which test binarized features
+    ///
+    /// The binarized features are ordered by binary feature, then by sample, with `stride` samples per binary feature;
+    /// every value must be 0 or 1, even for samples beyond the end of the input, whose scores are discarded.
+    struct binary_splits_t
+    {
+        /// the binary feature of each tree level
+        unsigned int const* tree_splits;
+        /// the binarized features of the block
+        unsigned char const* binary_features;
+        /// the number of samples in the block, a multiple of `lane_group_size`
+        std::size_t stride;
+
+        /// @returns the result of a tree split for a sample
+        unsigned int Test(std::size_t const split, std::size_t const sample) const
+        {
+          return binary_features[tree_splits[split] * stride + sample];
+        }
+    };
+
+    /// @brief tree splits which compare quantized features with border indices
+    ///
+    /// The quantized features are ordered by feature, then by sample, with `stride` samples per feature; a sample's
+    /// quantized feature is the number of the feature's borders which are less than the feature's value, so the feature's
+    /// value is greater than its `j`-th border if and only if its quantized feature is greater than `j`.
+    struct quantized_splits_t
+    {
+        /// the feature of each tree level
+        uint16_t const* split_features;
+        /// the index of the border, among its feature's borders, of each tree level
+        int16_t const* split_borders;
+        /// the quantized features of the block
+        int16_t const* quantized_features;
+        /// the number of samples in the block, a multiple of `lane_group_size`
+        std::size_t stride;
+
+        /// @returns the result of a tree split for a sample
+        unsigned int Test(std::size_t const split, std::size_t const sample) const
+        {
+          return quantized_features[split_features[split] * stride + sample] > split_borders[split];
+        }
+
+        /// @returns the splits which follow the first `num_splits` tree levels
+        quantized_splits_t Skip(std::size_t const num_splits) const
+        {
+          return {split_features + num_splits, split_borders + num_splits, quantized_features, stride};
+        }
+    };
+
+    /// the type of the sum of a sample's leaf values: fixed-point leaf values are summed exactly, as integers
+    template <typename LEAF>
+    using leaf_sum_t = std::conditional_t<std::is_integral_v<LEAF>, int32_t, double>;
+
+    /// @brief kernel which walks all of the trees for a block of samples
+    /// @param tree_count the number of trees
+    /// @param tree_depth the depth of each tree
+    /// @param splits the tree splits and the block's features
+    /// @param leaf_values the leaf values of each tree
+    /// @param num_samples the number of samples for which to walk the trees, a multiple of `lane_group_size`
+    /// @param [in,out] result the sum of each sample's leaf values, to which the leaf values of these trees are added, in order
+    template <typename SPLITS, typename LEAF>
+    using walk_trees_t = void (*)(
+        unsigned int tree_count,
+        unsigned int const* tree_depth,
+        SPLITS const& splits,
+        LEAF const* leaf_values,
+        std::size_t num_samples,
+        double* result);
+
+    /// compute the leaf indices of one tree for a group of samples, without vector instructions
+    template <typename SPLITS>
+    inline void GetLeafIndices(
+        unsigned int const tree_depth,
+        std::size_t const first_split,
+        SPLITS const& splits,
+        std::size_t const first_sample,
+        uint32_t* leaf_index)
+    {
+      std::fill_n(leaf_index, lane_group_size, 0u);
+      for(unsigned int depth = 0; depth < tree_depth; ++depth) {
+        for(std::size_t s = 0; s < lane_group_size; ++s)
+          leaf_index[s] |= splits.Test(first_split + depth, first_sample + s) << depth;
+      }
+    }
+
+    template <typename SPLITS, typename LEAF>
+    void WalkTreesScalar(
+        unsigned int const tree_count,
+        unsigned int const* tree_depth,
+        SPLITS const& splits,
+        LEAF const* leaf_values,
+        std::size_t const num_samples,
+        double* result)
+    {
+      std::array<uint32_t, lane_group_size> leaf_index;
+      std::array<leaf_sum_t<LEAF>, lane_group_size> sum;
+      for(std::size_t first = 0; first < num_samples; first += lane_group_size) {
+        for(std::size_t s = 0; s < lane_group_size; ++s)
+          sum[s] = static_cast<leaf_sum_t<LEAF>>(result[first + s]);
+        std::size_t split  = 0;
+        auto const* leaves = leaf_values;
+        for(unsigned int tree_id = 0; tree_id < tree_count; ++tree_id) {
+          GetLeafIndices(tree_depth[tree_id], split, splits, first, leaf_index.data());
+          for(std::size_t s = 0; s < lane_group_size; ++s)
+            sum[s] += leaves[leaf_index[s]];
+          split += tree_depth[tree_id];
+          leaves += (1 << tree_depth[tree_id]);
+        }
+        for(std::size_t s = 0; s < lane_group_size; ++s)
+          result[first + s] = static_cast<double>(sum[s]);
+      }
+    }
+
+    /// @brief walk all of the trees for one sample after another, without vector instructions
+    ///
+    /// Unlike the kernels, this takes any number of samples, so for fewer samples than a group, it does not walk the trees
+    /// for the empty slots; it sums each sample's leaf values in the same order as the kernels, so the sums are identical.
+    /// However, it reads all of the leaf values for each sample, so it is only faster than the kernels for a few samples.
+    template <typename SPLITS, typename LEAF>
+    void WalkTreesEach(
+        unsigned int const tree_count,
+        unsigned int const* tree_depth,
+        SPLITS const& splits,
+        LEAF const* leaf_values,
+        std::size_t const num_samples,
+        double* result)
+    {
+      for(std::size_t s = 0; s < num_samples; ++s) {
+        auto sum           = static_cast<leaf_sum_t<LEAF>>(result[s]);
+        std::size_t split  = 0;
+        auto const* leaves = leaf_values;
+        for(unsigned int tree_id = 0; tree_id < tree_count; ++tree_id) {
+          uint32_t leaf_index = 0;
+          for(unsigned int depth = 0; depth < tree_depth[tree_id]; ++depth)
+            leaf_index |= splits.Test(split + depth, s) << depth;
+          sum += leaves[leaf_index];
+          split += tree_depth[tree_id];
+          leaves += (1 << tree_depth[tree_id]);
+        }
+        result[s] = static_cast<double>(sum);
+      }
+    }
+
+#ifdef IGUANA_CATBOOST_X86_KERNELS
+
+    /// @returns the results, 0 or 1, of a tree split for a group of samples, one byte per sample
+    __attribute__((target("avx2"))) inline __m256i TestSplitAVX2(binary_splits_t const& splits, std::size_t const split, std::size_t const first_sample)
+    {
+      return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(&splits.binary_features[splits.tree_splits[split] * splits.stride + first_sample]));
+    }
+
+    /// @returns the results, 0 or 1, of a tree split for a group of samples, one byte per sample
+    __attribute__((target("avx2"))) inline __m256i TestSplitAVX2(quantized_splits_t const& splits, std::size_t const split, std::size_t const first_sample)
+    {
+      auto const* quantized_row = &splits.quantized_features[splits.split_features[split] * splits.stride + first_sample];
+      auto const border         = _mm256_set1_epi16(splits.split_borders[split]);
+      auto const test_lo        = _mm256_cmpgt_epi16(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(quantized_row)), border);
+      auto const test_hi        = _mm256_cmpgt_epi16(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(quantized_row + 16)), border);
+      // packing interleaves the 128-bit lanes of the two inputs, so reorder them
+      auto const test = _mm256_permute4x64_epi64(_mm256_packs_epi16(test_lo, test_hi), 0xD8);
+      return _mm256_and_si256(test, _mm256_set1_epi8(1));
+    }
+
+    /// compute the leaf indices of a tree for a group of samples, one byte per sample; each level's split results are
+    /// shifted in 16-bit lanes, which is exact since the shifts are less than 8, so no bit moves into the next byte
+    template <typename SPLITS>
+    __attribute__((target("avx2"))) inline __m256i GetLeafIndicesAVX2(
+        unsigned int const tree_depth,
+        std::size_t const first_split,
+        SPLITS const& splits,
+        std::size_t const first_sample)
+    {
+      auto leaf_index = _mm256_setzero_si256();
+      for(unsigned int depth = 0; depth < tree_depth; ++depth)
+        leaf_index = _mm256_or_si256(leaf_index, _mm256_sll_epi16(TestSplitAVX2(splits, first_split + depth, first_sample), _mm_cvtsi32_si128(static_cast<int>(depth))));
+      return leaf_index;
+    }
+
+    /// @brief sums of the leaf values of a group of samples, with AVX2 gathers
+    template <typename LEAF>
+    class LeafSumAVX2;
+
+    template <>
+    class LeafSumAVX2<double>
+    {
+      public:
+
+        __attribute__((target("avx2"))) explicit LeafSumAVX2(double const* result)
+        {
+          for(int i = 0; i < 8; ++i)
+            m_sum[i] = _mm256_loadu_pd(result + 4 * i);
+        }
+
+        /// add the leaf values of the `group`-th 8 samples, whose leaf indices are 32-bit integers
+        __attribute__((target("avx2"))) void Add(double const* leaf_values, __m256i const leaf_index, int const group)
+        {
+          auto const all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+          m_sum[2 * group]     = _mm256_add_pd(m_sum[2 * group], _mm256_mask_i32gather_pd(_mm256_setzero_pd(), leaf_values, _mm256_castsi256_si128(leaf_index), all_lanes, 8));
+          m_sum[2 * group + 1] = _mm256_add_pd(m_sum[2 * group + 1], _mm256_mask_i32gather_pd(_mm256_setzero_pd(), leaf_values, _mm256_extracti128_si256(leaf_index, 1), all_lanes, 8));
+        }
+
+        __attribute__((target("avx2"))) void Store(double* result) const
+        {
+          for(int i = 0; i < 8; ++i)
+            _mm256_storeu_pd(result + 4 * i, m_sum[i]);
+        }
+
+      private:
+
+        __m256d m_sum[8];
+    };
+
+    template <>
+    class LeafSumAVX2<float>
+    {
+      public:
+
+        __attribute__((target("avx2"))) explicit LeafSumAVX2(double const* result)
+        {
+          for(int i = 0; i < 8; ++i)
+            m_sum[i] = _mm256_loadu_pd(result + 4 * i);
+        }
+
+        /// add the leaf values of the `group`-th 8 samples, whose leaf indices are 32-bit integers
+        __attribute__((target("avx2"))) void Add(float const* leaf_values, __m256i const leaf_index, int const group)
+        {
+          auto const values    = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), leaf_values, leaf_index, _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+          m_sum[2 * group]     = _mm256_add_pd(m_sum[2 * group], _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+          m_sum[2 * group + 1] = _mm256_add_pd(m_sum[2 * group + 1], _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+        }
+
+        __attribute__((target("avx2"))) void Store(double* result) const
+        {
+          for(int i = 0; i < 8; ++i)
+            _mm256_storeu_pd(result + 4 * i, m_sum[i]);
+        }
+
+      private:
+
+        __m256d m_sum[8];
+    };
+
+    template <>
+    class LeafSumAVX2<int16_t>
+    {
+      public:
+
+        /// the sums of fixed-point leaf values are integers, so they are converted exactly
+        __attribute__((target("avx2"))) explicit LeafSumAVX2(double const* result)
+        {
+          for(int i = 0; i < 4; ++i)
+            m_sum[i] = _mm256_set_m128i(_mm256_cvtpd_epi32(_mm256_loadu_pd(result + 8 * i + 4)), _mm256_cvtpd_epi32(_mm256_loadu_pd(result + 8 * i)));
+        }
+
+        /// add the leaf values of the `group`-th 8 samples, whose leaf indices are 32-bit integers; each value is gathered
+        /// as 32 bits, then sign-extended from its low 16 bits, so the leaf values must be followed by one padding value
+        __attribute__((target("avx2"))) void Add(int16_t const* leaf_values, __m256i const leaf_index, int const group)
+        {
+          auto const values = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<int const*>(leaf_values), leaf_index, _mm256_set1_epi32(-1), 2);
+          m_sum[group]      = _mm256_add_epi32(m_sum[group], _mm256_srai_epi32(_mm256_slli_epi32(values, 16), 16));
+        }
+
+        __attribute__((target("avx2"))) void Store(double* result) const
+        {
+          for(int i = 0; i < 4; ++i) {
+            _mm256_storeu_pd(result + 8 * i, _mm256_cvtepi32_pd(_mm256_castsi256_si128(m_sum[i])));
+            _mm256_storeu_pd(result + 8 * i + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(m_sum[i], 1)));
+          }
+        }
+
+      private:
+
+        __m256i m_sum[4];
+    };
+
+    template <typename SPLITS, typename LEAF>
+    __attribute__((target("avx2"))) void WalkTreesAVX2(
+        unsigned int const tree_count,
+        unsigned int const* tree_depth,
+        SPLITS const& splits,
+        LEAF const* leaf_values,
+        std::size_t const num_samples,
+        double* result)
+    {
+      alignas(32) std::array<uint32_t, lane_group_size> leaf_index;
+      for(std::size_t first = 0; first < num_samples; first += lane_group_size) {
+        LeafSumAVX2<LEAF> sum(result + first);
+        std::size_t split  = 0;
+        auto const* leaves = leaf_values;
+        for(unsigned int tree_id = 0; tree_id < tree_count; ++tree_id) {
+          if(tree_depth[tree_id] <= max_vector_tree_depth) {
+            auto const index_bytes = GetLeafIndicesAVX2(tree_depth[tree_id], split, splits, first);
+            auto const index_lo    = _mm256_castsi256_si128(index_bytes);
+            auto const index_hi    = _mm256_extracti128_si256(index_bytes, 1);
+            sum.Add(leaves, _mm256_cvtepu8_epi32(index_lo), 0);
+            sum.Add(leaves, _mm256_cvtepu8_epi32(_mm_srli_si128(index_lo, 8)), 1);
+            sum.Add(leaves, _mm256_cvtepu8_epi32(index_hi), 2);
+            sum.Add(leaves, _mm256_cvtepu8_epi32(_mm_srli_si128(index_hi, 8)), 3);
+          }
+          else {
+            GetLeafIndices(tree_depth[tree_id], split, splits, first, leaf_index.data());
+            for(int group = 0; group < 4; ++group)
+              sum.Add(leaves, _mm256_load_si256(reinterpret_cast<__m256i const*>(&leaf_index[8 * group])), group);
+          }
+          split += tree_depth[tree_id];
+          leaves += (1 << tree_depth[tree_id]);
+        }
+        sum.Store(result + first);
+      }
+    }
+
+    // with GCC 12, the AVX-512 intrinsics which start from an `_mm512_undefined_*` value, such as the conversions and extractions
+    // below, give false -Wmaybe-uninitialized warnings (GCC bug 105593); the gathers avoid them by starting from zero instead
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    /// @brief sums of the leaf values of a group of samples, with AVX-512 gathers
+    template <typename LEAF>
+    class LeafSumAVX512;
+
+    template <>
+    class LeafSumAVX512<double>
+    {
+      public:
+
+        __attribute__((target("avx512f"))) explicit LeafSumAVX512(double const* result)
+        {
+          for(int i = 0; i < 4; ++i)
+            m_sum[i] = _mm512_loadu_pd(result + 8 * i);
+        }
+
+        /// add the leaf values of the `group`-th 16 samples, whose leaf indices are 32-bit integers
+        __attribute__((target("avx512f"))) void Add(double const* leaf_values, __m512i const leaf_index, int const group)
+        {
+          m_sum[2 * group]     = _mm512_add_pd(m_sum[2 * group], _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm512_castsi512_si256(leaf_index), leaf_values, 8));
+          m_sum[2 * group + 1] = _mm512_add_pd(m_sum[2 * group + 1], _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm512_extracti64x4_epi64(leaf_index, 1), leaf_values, 8));
+        }
+
+        __attribute__((target("avx512f"))) void Store(double* result) const
+        {
+          for(int i = 0; i < 4; ++i)
+            _mm512_storeu_pd(result + 8 * i, m_sum[i]);
+        }
+
+      private:
+
+        __m512d m_sum[4];
+    };
+
+    template <>
+    class LeafSumAVX512<float>
+    {
+      public:
+
+        __attribute__((target("avx512f"))) explicit LeafSumAVX512(double const* result)
+        {
+          for(int i = 0; i < 4; ++i)
+            m_sum[i] = _mm512_loadu_pd(result + 8 * i);
+        }
+
+        /// add the leaf values of the `group`-th 16 samples, whose leaf indices are 32-bit integers
+        __attribute__((target("avx512f"))) void Add(float const* leaf_values, __m512i const leaf_index, int const group)
+        {
+          auto const values    = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, leaf_index, leaf_values, 4);
+          auto const values_hi = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(values), 1));
+          m_sum[2 * group]     = _mm512_add_pd(m_sum[2 * group], _mm512_cvtps_pd(_mm512_castps512_ps256(values)));
+          m_sum[2 * group + 1] = _mm512_add_pd(m_sum[2 * group + 1], _mm512_cvtps_pd(values_hi));
+        }
+
+        __attribute__((target("avx512f"))) void Store(double* result) const
+        {
+          for(int i = 0; i < 4; ++i)
+            _mm512_storeu_pd(result + 8 * i, m_sum[i]);
+        }
+
+      private:
+
+        __m512d m_sum[4];
+    };
+
+    template <>
+    class LeafSumAVX512<int16_t>
+    {
+      public:
+
+        /// the sums of fixed-point leaf values are integers, so they are converted exactly
+        __attribute__((target("avx512f"))) explicit LeafSumAVX512(double const* result)
+        {
+          for(int i = 0; i < 2; ++i)
+            m_sum[i] = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtpd_epi32(_mm512_loadu_pd(result + 16 * i))), _mm512_cvtpd_epi32(_mm512_loadu_pd(result + 16 * i + 8)), 1);
+        }
+
+        /// add the leaf values of the `group`-th 16 samples, whose leaf indices are 32-bit integers; each value is gathered
+        /// as 32 bits, then sign-extended from its low 16 bits, so the leaf values must be followed by one padding value
+        __attribute__((target("avx512f"))) void Add(int16_t const* leaf_values, __m512i const leaf_index, int const group)
+        {
+          auto const values = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, leaf_index, leaf_values, 2);
+          m_sum[group]      = _mm512_add_epi32(m_sum[group], _mm512_srai_epi32(_mm512_slli_epi32(values, 16), 16));
+        }
+
+        __attribute__((target("avx512f"))) void Store(double* result) const
+        {
+          for(int i = 0; i < 2; ++i) {
+            _mm512_storeu_pd(result + 16 * i, _mm512_cvtepi32_pd(_mm512_castsi512_si256(m_sum[i])));
+            _mm512_storeu_pd(result + 16 * i + 8, _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(m_sum[i], 1)));
+          }
+        }
+
+      private:
+
+        __m512i m_sum[2];
+    };
+
+    template <typename SPLITS, typename LEAF>
+    __attribute__((target("avx512f"))) void WalkTreesAVX512(
+        unsigned int const tree_count,
+        unsigned int const* tree_depth,
+        SPLITS const& splits,
+        LEAF const* leaf_values,
+        std::size_t const num_samples,
+        double* result)
+    {
+      alignas(64) std::array<uint32_t, lane_group_size> leaf_index;
+      for(std::size_t first = 0; first < num_samples; first += lane_group_size) {
+        LeafSumAVX512<LEAF> sum(result + first);
+        std::size_t split  = 0;
+        auto const* leaves = leaf_values;
+        for(unsigned int tree_id = 0; tree_id < tree_count; ++tree_id) {
+          if(tree_depth[tree_id] <= max_vector_tree_depth) {
+            auto const index_bytes = GetLeafIndicesAVX2(tree_depth[tree_id], split, splits, first);
+            sum.Add(leaves, _mm512_cvtepu8_epi32(_mm256_castsi256_si128(index_bytes)), 0);
+            sum.Add(leaves, _mm512_cvtepu8_epi32(_mm256_extracti128_si256(index_bytes, 1)), 1);
+          }
+          else {
+            GetLeafIndices(tree_depth[tree_id], split, splits, first, leaf_index.data());
+            for(int group = 0; group < 2; ++group)
+              sum.Add(leaves, _mm512_load_si512(&leaf_index[16 * group]), group);
+          }
+          split += tree_depth[tree_id];
+          leaves += (1 << tree_depth[tree_id]);
+        }
+        sum.Store(result + first);
+      }
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+    /// @brief header of the binary model format; see `convert_catboost_model.py`
+    struct model_file_header_t
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t float_feature_count;
+        uint32_t binary_feature_count;
+        uint32_t tree_count;
+        uint32_t tree_split_count;
+        uint32_t leaf_value_count;
+        double scale;
+        double bias;
+        uint64_t border_counts_offset;
+        uint64_t borders_offset;
+        uint64_t tree_depth_offset;
+        uint64_t tree_splits_offset;
+        uint64_t leaf_values_offset;
+        uint64_t file_size;
+    };
+    static_assert(sizeof(model_file_header_t) == 96, "unexpected binary model header layout");
+
+    /// the magic string at the start of binary model files
+    constexpr char model_file_magic[8] = {'I', 'G', 'U', 'A', 'N', 'A', 'C', 'B'};
+
+    /// the version of the binary model format
+    constexpr uint32_t model_file_version = 1;
+
+    /// the deepest tree of a binary model file, as for CatBoost
+    constexpr uint32_t max_tree_depth = 16;
+
+    /// @returns the start of a section of a binary model file, or `nullptr` if it is misaligned or not within the file
+    template <typename T>
+    T const* GetModelFileSection(char const* bytes, std::size_t const file_size, uint64_t const offset, uint64_t const count)
+    {
+      if(offset % alignof(T) != 0 || offset > file_size || count > (file_size - offset) / sizeof(T))
+        return nullptr;
+      return reinterpret_cast<T const*>(bytes + offset);
+    }
+
+    /// @returns true if walking the trees for one sample after another, with `WalkTreesEach`, is faster than with a kernel, which
+    /// walks them for a whole group of samples, however few there are; the largest such numbers of samples were measured with the
+    /// largest model, of about 5000 trees, on a 2 GHz x86-64 CPU with AVX-512
+    inline bool IsWalkEachFaster(CatboostModel::Kernel const kernel, std::size_t const num_samples)
+    {
+      return num_samples <= (kernel == CatboostModel::Kernel::scalar ? 6 : 2);
+    }
+
+    /// @returns the kernel which walks the trees, or `WalkTreesEach` if the trees are walked for one sample after another
+    template <typename SPLITS, typename LEAF>
+    walk_trees_t<SPLITS, LEAF> GetWalkTrees(CatboostModel::Kernel const kernel, bool const walk_each)
+    {
+      if(walk_each)
+        return WalkTreesEach<SPLITS, LEAF>;
+      switch(kernel) {
+#ifdef IGUANA_CATBOOST_X86_KERNELS
+      case CatboostModel::Kernel::avx2: return WalkTreesAVX2<SPLITS, LEAF>;
+      case CatboostModel::Kernel::avx512: return WalkTreesAVX512<SPLITS, LEAF>;
+#endif
+      default: return WalkTreesScalar<SPLITS, LEAF>;
+      }
+    }
+
+    /// the largest magnitude of a fixed-point leaf value
+    constexpr int fixed_leaf_max = 32767;
+
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /// @brief the quantized tables of a model; see `CatboostModel::Quantize`
+  struct CatboostModel::quantized_t
+  {
+      /// the precision of the leaf values
+      LeafPrecision leaf_precision;
+      /// the index of each feature's first border
+      std::vector<unsigned int> first_border;
+      /// the feature of each tree level
+      std::vector<uint16_t> split_features;
+      /// the index of the border, among its feature's borders, of each tree level
+      std::vector<int16_t> split_borders;
+      /// the leaf values, if their precision is `LeafPrecision::float32`
+      std::vector<float> float_leaf_values;
+      /// the leaf values in units of `leaf_scale`, if their precision is `LeafPrecision::fixed16`,
+      /// followed by one padding value, since the vector kernels gather them 32 bits at a time
+      std::vector<int16_t> fixed_leaf_values;
+      /// the unit of the fixed-point leaf values
+      double leaf_scale = 1;
+      /// the largest difference between the quantized and original sums of leaf values
+      double leaf_error_bound = 0;
+      /// the smallest and largest sums of the quantized leaf values of the trees from each tree to the last, in units
+      /// of `leaf_scale`; there is one more value than there are trees, for no remaining trees
+      std::vector<double> remaining_min;
+      std::vector<double> remaining_max;
+      /// the sum of the largest magnitude of each tree's quantized leaf values, in units of `leaf_scale`
+      double leaf_magnitude_sum = 0;
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  CatboostModel CatboostModel::Load(std::string const& file_name, bool const huge_pages)
+  {
+    auto const Fail = [&file_name](std::string const& reason) {
+      return std::runtime_error(fmt::format("cannot load CatBoost model {:?}: {}", file_name, reason));
+    };
+
+    // map the file
+    auto const fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+      throw Fail(std::strerror(errno));
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0) {
+      close(fd);
+      throw Fail(std::strerror(errno));
+    }
+    auto const file_size = static_cast<std::size_t>(file_stat.st_size);
+    if(file_size < sizeof(model_file_header_t)) {
+      close(fd);
+      throw Fail("file is too small");
+    }
+    auto* data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+      throw Fail(std::strerror(errno));
+    CatboostModel model;
+    model.m_mapping = std::shared_ptr<void const>(data, [file_size](void const* ptr) { munmap(const_cast<void*>(ptr), file_size); });
+    auto const* bytes = static_cast<char const*>(data);
+
+    // check the header
+    model_file_header_t header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if(std::memcmp(header.magic, model_file_magic, sizeof(model_file_magic)) != 0)
+      throw Fail("not a binary model file");
+    if(header.version != model_file_version)
+      throw Fail(fmt::format("unsupported format version {}", header.version));
+    if(header.file_size != file_size)
+      throw Fail("file is truncated");
+
+    // find the sections
+    model.m_float_feature_count  = header.float_feature_count;
+    model.m_binary_feature_count = header.binary_feature_count;
+    model.m_tree_count           = header.tree_count;
+    model.m_border_counts        = GetModelFileSection<unsigned int>(bytes, file_size, header.border_counts_offset, header.float_feature_count);
+    model.m_borders              = GetModelFileSection<float>(bytes, file_size, header.borders_offset, header.binary_feature_count);
+    model.m_tree_depth           = GetModelFileSection<unsigned int>(bytes, file_size, header.tree_depth_offset, header.tree_count);
+    model.m_tree_splits          = GetModelFileSection<unsigned int>(bytes, file_size, header.tree_splits_offset, header.tree_split_count);
+    model.m_leaf_values          = GetModelFileSection<double>(bytes, file_size, header.leaf_values_offset, header.leaf_value_count);
+    if(!model.m_border_counts || !model.m_borders || !model.m_tree_depth || !model.m_tree_splits || !model.m_leaf_values)
+      throw Fail("a section is misaligned or outside of the file");
+    model.m_scale                = header.scale;
+    model.m_bias                 = header.bias;
+
+    // check that the trees' splits and leaves are within the tables
+    uint64_t binary_feature_count = 0;
+    for(uint32_t i = 0; i < header.float_feature_count; i++)
+      binary_feature_count += model.m_border_counts[i];
+    uint64_t tree_split_count = 0;
+    uint64_t leaf_value_count = 0;
+    for(uint32_t tree_id = 0; tree_id < header.tree_count; tree_id++) {
+      if(model.m_tree_depth[tree_id] > max_tree_depth)
+        throw Fail(fmt::format("tree {} is deeper than {} levels", tree_id, max_tree_depth));
+      tree_split_count += model.m_tree_depth[tree_id];
+      leaf_value_count += uint64_t{1} << model.m_tree_depth[tree_id];
+    }
+    if(binary_feature_count != header.binary_feature_count || tree_split_count != header.tree_split_count || leaf_value_count != header.leaf_value_count)
+      throw Fail("inconsistent table sizes");
+    for(uint32_t i = 0; i < header.tree_split_count; i++) {
+      if(model.m_tree_splits[i] >= header.binary_feature_count)
+        throw Fail("a tree split refers to a nonexistent binary feature");
+    }
+
+#ifdef MADV_HUGEPAGE
+    // the leaf values section is page aligned, and is most of the file
+    if(huge_pages)
+      madvise(const_cast<char*>(bytes) + header.leaf_values_offset, header.leaf_value_count * sizeof(double), MADV_HUGEPAGE);
+#endif
+
+    return model;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  CatboostModel CatboostModel::Quantize(LeafPrecision const leaf_precision) const
+  {
+    auto const Fail = [](std::string const& reason) {
+      return std::runtime_error(fmt::format("cannot quantize CatBoost model: {}", reason));
+    };
+    quantized_t quantized;
+    quantized.leaf_precision = leaf_precision;
+
+    // bucket indices and border indices are 16-bit integers, and features are indexed by 16-bit integers
+    if(m_float_feature_count > std::numeric_limits<uint16_t>::max())
+      throw Fail(fmt::format("more than {} features", std::numeric_limits<uint16_t>::max()));
+    unsigned int first_border = 0;
+    for(unsigned int i = 0; i < m_float_feature_count; ++i) {
+      if(m_border_counts[i] > static_cast<unsigned int>(std::numeric_limits<int16_t>::max()))
+        throw Fail(fmt::format("feature {} has more than {} borders", i, std::numeric_limits<int16_t>::max()));
+      // a feature's bucket index is only equivalent to its binarized features if its borders are sorted
+      if(!std::is_sorted(m_borders + first_border, m_borders + first_border + m_border_counts[i]))
+        throw Fail(fmt::format("the borders of feature {} are not sorted", i));
+      quantized.first_border.push_back(first_border);
+      first_border += m_border_counts[i];
+    }
+
+    // replace each binary feature of the splits by its feature and border index
+    std::size_t tree_split_count = 0;
+    std::size_t leaf_value_count = 0;
+    for(unsigned int tree_id = 0; tree_id < m_tree_count; ++tree_id) {
+      tree_split_count += m_tree_depth[tree_id];
+      leaf_value_count += std::size_t{1} << m_tree_depth[tree_id];
+    }
+    for(std::size_t split = 0; split < tree_split_count; ++split) {
+      // the last feature whose first border is not after the binary feature; features without borders are skipped
+      auto const feature = std::upper_bound(quantized.first_border.begin(), quantized.first_border.end(), m_tree_splits[split]) - quantized.first_border.begin() - 1;
+      quantized.split_features.push_back(static_cast<uint16_t>(feature));
+      quantized.split_borders.push_back(static_cast<int16_t>(m_tree_splits[split] - quantized.first_border[feature]));
+    }
+
+    // convert the leaf values, and sum each tree's largest conversion error
+    auto const ConvertLeafValues = [this, &quantized](auto const& convert) {
+      double const* leaves = m_leaf_values;
+      for(unsigned int tree_id = 0; tree_id < m_tree_count; ++tree_id) {
+        double tree_error = 0;
+        for(std::size_t leaf = 0; leaf < (std::size_t{1} << m_tree_depth[tree_id]); ++leaf)
+          tree_error = std::max(tree_error, std::abs(leaves[leaf] - convert(leaves[leaf])));
+        quantized.leaf_error_bound += tree_error;
+        leaves += std::size_t{1} << m_tree_depth[tree_id];
+      }
+    };
+    switch(leaf_precision) {
+    case LeafPrecision::float64:
+      break;
+    case LeafPrecision::float32:
+      quantized.float_leaf_values.assign(m_leaf_values, m_leaf_values + leaf_value_count);
+      ConvertLeafValues([](double const value) { return static_cast<double>(static_cast<float>(value)); });
+      break;
+    case LeafPrecision::fixed16: {
+      // the sums of the fixed-point leaf values must fit in 32-bit integers
+      if(m_tree_count > static_cast<unsigned int>(std::numeric_limits<int32_t>::max() / fixed_leaf_max))
+        throw Fail(fmt::format("more than {} trees", std::numeric_limits<int32_t>::max() / fixed_leaf_max));
+      double max_leaf_value = 0;
+      for(std::size_t leaf = 0; leaf < leaf_value_count; ++leaf)
+        max_leaf_value = std::max(max_leaf_value, std::abs(m_leaf_values[leaf]));
+      if(max_leaf_value > 0)
+        quantized.leaf_scale = max_leaf_value / fixed_leaf_max;
+      auto const ToFixed = [leaf_scale = quantized.leaf_scale](double const value) {
+        return static_cast<int16_t>(std::clamp(std::lround(value / leaf_scale), -long{fixed_leaf_max}, long{fixed_leaf_max}));
+      };
+      for(std::size_t leaf = 0; leaf < leaf_value_count; ++leaf)
+        quantized.fixed_leaf_values.push_back(ToFixed(m_leaf_values[leaf]));
+      quantized.fixed_leaf_values.push_back(0);
+      ConvertLeafValues([&ToFixed, leaf_scale = quantized.leaf_scale](double const value) { return leaf_scale * ToFixed(value); });
+      break;
+    }
+    default:
+      throw Fail("unknown leaf precision");
+    }
+
+    // bound the sums of the remaining trees' leaf values, after each tree, for early exits
+    auto const BoundLeafValues = [this, &quantized](auto const* leaves) {
+      quantized.remaining_min.assign(m_tree_count + 1, 0.0);
+      quantized.remaining_max.assign(m_tree_count + 1, 0.0);
+      std::vector<std::size_t> first_leaf(m_tree_count + 1, 0);
+      for(unsigned int tree_id = 0; tree_id < m_tree_count; ++tree_id)
+        first_leaf[tree_id + 1] = first_leaf[tree_id] + (std::size_t{1} << m_tree_depth[tree_id]);
+      for(unsigned int tree_id = m_tree_count; tree_id-- > 0;) {
+        auto const [min_leaf, max_leaf] = std::minmax_element(leaves + first_leaf[tree_id], leaves + first_leaf[tree_id + 1]);
+        quantized.remaining_min[tree_id] = quantized.remaining_min[tree_id + 1] + *min_leaf;
+        quantized.remaining_max[tree_id] = quantized.remaining_max[tree_id + 1] + *max_leaf;
+        quantized.leaf_magnitude_sum += std::max(std::abs(static_cast<double>(*min_leaf)), std::abs(static_cast<double>(*max_leaf)));
+      }
+    };
+    switch(leaf_precision) {
+    case LeafPrecision::float64: BoundLeafValues(m_leaf_values); break;
+    case LeafPrecision::float32: BoundLeafValues(quantized.float_leaf_values.data()); break;
+    case LeafPrecision::fixed16: BoundLeafValues(quantized.fixed_leaf_values.data()); break;
+    }
+
+    CatboostModel model = *this;
+    model.m_quantized   = std::make_shared<quantized_t const>(std::move(quantized));
+    return model;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  double CatboostModel::GetScoreErrorBound() const
+  {
+    return m_quantized ? std::abs(m_scale) * m_quantized->leaf_error_bound : 0.0;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void CatboostModel::Evaluate(float const* features, std::size_t const num_samples, double* scores, Kernel const kernel) const
+  {
+    EvaluateBounded(features, num_samples, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), scores, kernel);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void CatboostModel::EvaluateBounded(float const* features, std::size_t const num_samples, double const lower, double const upper, double* scores, Kernel const kernel) const
+  {
+    static_assert(s_block_size % lane_group_size == 0, "the block size must be a multiple of the kernels' sample group size");
+    static_assert(s_quantized_block_size % lane_group_size == 0, "the block size must be a multiple of the kernels' sample group size");
+    if(!IsKernelAvailable(kernel))
+      throw std::runtime_error(fmt::format("CatBoost model kernel '{}' is not available on this CPU", GetKernelName(kernel)));
+    if(m_quantized)
+      EvaluateQuantized(features, num_samples, lower, upper, scores, kernel);
+    else
+      EvaluateBinarized(features, num_samples, scores, kernel);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void CatboostModel::EvaluateBinarized(float const* features, std::size_t const num_samples, double* scores, Kernel const kernel) const
+  {
+    auto const walk_each  = IsWalkEachFaster(kernel, num_samples);
+    auto const walk_trees = GetWalkTrees<binary_splits_t, double>(kernel, walk_each);
+
+    ScratchArena::Scope const scratch_scope;
+
+    // features of a block of samples, ordered by feature, then by sample, so that each feature's values are contiguous;
+    // the slots of samples past the end of the input keep the previous block's values, or zero, so all slots are binarized
+    std::pmr::vector<float> block_features(static_cast<std::size_t>(m_float_feature_count) * s_block_size, &ScratchArena::Get());
+    // binarized features of a block of samples, ordered by binary feature, then by sample, so that
+    // the samples' values of a tree split are contiguous
+    std::pmr::vector<unsigned char> binary_features(static_cast<std::size_t>(m_binary_feature_count) * s_block_size, &ScratchArena::Get());
+    binary_splits_t const splits{m_tree_splits, binary_features.data(), s_block_size};
+    std::array<double, s_block_size> result;
+
+    for(std::size_t first = 0; first < num_samples; first += s_block_size) {
+      auto const block_size = std::min(s_block_size, num_samples - first);
+      auto const* block     = features + first * m_float_feature_count;
+
+      // the slots for which the trees are walked: all of them, unless they are walked for one sample after another
+      auto const num_slots = walk_each ? block_size : s_block_size;
+
+      // transpose and binarize the block's features
+      for(std::size_t s = 0; s < block_size; ++s) {
+        for(unsigned int i = 0; i < m_float_feature_count; ++i)
+          block_features[i * s_block_size + s] = block[s * m_float_feature_count + i];
+      }
+      unsigned int bin_feature_index = 0;
+      for(unsigned int i = 0; i < m_float_feature_count; ++i) {
+        auto const* feature_row = &block_features[i * s_block_size];
+        for(unsigned int j = 0; j < m_border_counts[i]; ++j) {
+          auto const border = m_borders[bin_feature_index];
+          auto* binary_row  = &binary_features[bin_feature_index * s_block_size];
+          for(std::size_t s = 0; s < num_slots; ++s)
+            binary_row[s] = static_cast<unsigned char>(feature_row[s] > border);
+          ++bin_feature_index;
+        }
+      }
+
+      // walk each tree once for the block, and sum the values of the samples' leaves
+      std::fill_n(result.begin(), num_slots, 0.0);
+      walk_trees(m_tree_count, m_tree_depth, splits, m_leaf_values, num_slots, result.data());
+
+      for(std::size_t s = 0; s < block_size; ++s)
+        scores[first + s] = m_scale * result[s] + m_bias;
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void CatboostModel::EvaluateQuantized(float const* features, std::size_t const num_samples, double const lower, double const upper, double* scores, Kernel const kernel) const
+  {
+    auto const& quantized = *m_quantized;
+    auto const infinity   = std::numeric_limits<double>::infinity();
+
+    ScratchArena::Scope const scratch_scope;
+
+    // bucket indices of a block of samples, ordered by feature, then by sample, so that the samples' values of a tree split
+    // are contiguous; the slots past those of the block's remaining samples keep stale values, or zero
+    std::pmr::vector<int16_t> quantized_features(static_cast<std::size_t>(m_float_feature_count) * s_quantized_block_size, &ScratchArena::Get());
+    quantized_splits_t const splits{quantized.split_features.data(), quantized.split_borders.data(), quantized_features.data(), s_quantized_block_size};
+    std::array<double, s_quantized_block_size> result;
+    // the sample of each slot, within the block
+    std::array<std::size_t, s_quantized_block_size> slot_sample;
+
+    // a sample's score is `m_scale * (leaf_scale * sum) + m_bias`, for the sum of its leaf values; once some trees are walked, its score
+    // is bounded by those of the smallest and largest sums of the remaining trees' leaf values, but the sums and scores are rounded,
+    // by at most one unit roundoff of the largest sum for each addition, and by a few for the score and for the remaining sums' bounds
+    bool const early_exit  = lower > -infinity || upper < infinity;
+    auto const sum_factor  = m_scale * quantized.leaf_scale;
+    auto const score_slack = std::numeric_limits<double>::epsilon() *
+                             (std::abs(sum_factor) * quantized.leaf_magnitude_sum * (2.0 * m_tree_count + 8) + 8 * std::abs(m_bias));
+
+    // the number of slots for which the trees are walked, for a number of samples: whole groups of samples for the kernels,
+    // unless the trees are walked for one sample after another
+    auto const walk_each    = IsWalkEachFaster(kernel, num_samples);
+    auto const GetSlotCount = [walk_each](std::size_t const num) {
+      return walk_each ? num : (num + lane_group_size - 1) / lane_group_size * lane_group_size;
+    };
+
+    auto const EvaluateBlocks = [&](auto const* leaf_values) {
+      auto const walk_trees = GetWalkTrees<quantized_splits_t, std::remove_cv_t<std::remove_pointer_t<decltype(leaf_values)>>>(kernel, walk_each);
+      for(std::size_t first = 0; first < num_samples; first += s_quantized_block_size) {
+        auto const block_size = std::min(s_quantized_block_size, num_samples - first);
+        auto const* block     = features + first * m_float_feature_count;
+
+        // transpose the block's features, replacing each by the number of its feature's borders which are less than it
+        for(std::size_t s = 0; s < block_size; ++s) {
+          for(unsigned int i = 0; i < m_float_feature_count; ++i) {
+            auto const* borders                               = m_borders + quantized.first_border[i];
+            quantized_features[i * s_quantized_block_size + s] = static_cast<int16_t>(
+                std::lower_bound(borders, borders + m_border_counts[i], block[s * m_float_feature_count + i]) - borders);
+          }
+          slot_sample[s] = s;
+        }
+
+        // walk the trees for the block, in stages if early exits are allowed, and sum the values of the samples' leaves
+        std::fill_n(result.begin(), GetSlotCount(block_size), 0.0);
+        std::size_t num_remaining = block_size;
+        std::size_t split         = 0;
+        auto const* leaves        = leaf_values;
+        for(unsigned int first_tree = 0; first_tree < m_tree_count;) {
+          auto const last_tree = early_exit ? std::min(first_tree + s_stage_tree_count, m_tree_count) : m_tree_count;
+          auto const num_slots = GetSlotCount(num_remaining);
+          walk_trees(last_tree - first_tree, m_tree_depth + first_tree, splits.Skip(split), leaves, num_slots, result.data());
+          for(; first_tree < last_tree; ++first_tree) {
+            split += m_tree_depth[first_tree];
+            leaves += (1 << m_tree_depth[first_tree]);
+          }
+          if(first_tree == m_tree_count)
+            break;
+
+          // stop walking the trees for the samples whose scores are certain, and move the others to the first slots
+          std::size_t num_kept = 0;
+          for(std::size_t k = 0; k < num_remaining; ++k) {
+            auto const score_a = sum_factor * (result[k] + quantized.remaining_min[first_tree]) + m_bias;
+            auto const score_b = sum_factor * (result[k] + quantized.remaining_max[first_tree]) + m_bias;
+            if(std::max(score_a, score_b) + score_slack < lower)
+              scores[first + slot_sample[k]] = -infinity;
+            else if(std::min(score_a, score_b) - score_slack > upper)
+              scores[first + slot_sample[k]] = infinity;
+            else {
+              if(num_kept != k) {
+                for(unsigned int i = 0; i < m_float_feature_count; ++i)
+                  quantized_features[i * s_quantized_block_size + num_kept] = quantized_features[i * s_quantized_block_size + k];
+                result[num_kept]      = result[k];
+                slot_sample[num_kept] = slot_sample[k];
+              }
+              ++num_kept;
+            }
+          }
+          num_remaining = num_kept;
+          if(num_remaining == 0)
+            break;
+        }
+
+        for(std::size_t k = 0; k < num_remaining; ++k)
+          scores[first + slot_sample[k]] = m_scale * (quantized.leaf_scale * result[k]) + m_bias;
+      }
+    };
+    switch(quantized.leaf_precision) {
+    case LeafPrecision::float64: EvaluateBlocks(m_leaf_values); break;
+    case LeafPrecision::float32: EvaluateBlocks(quantized.float_leaf_values.data()); break;
+    case LeafPrecision::fixed16: EvaluateBlocks(quantized.fixed_leaf_values.data()); break;
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  CatboostModel::Kernel CatboostModel::GetBestKernel()
+  {
+    static Kernel const best_kernel = []() {
+      for(auto kernel : {Kernel::avx512, Kernel::avx2}) {
+        if(IsKernelAvailable(kernel))
+          return kernel;
+      }
+      return Kernel::scalar;
+    }();
+    return best_kernel;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool CatboostModel::IsKernelAvailable(Kernel const kernel)
+  {
+    switch(kernel) {
+    case Kernel::scalar: return true;
+#ifdef IGUANA_CATBOOST_X86_KERNELS
+    case Kernel::avx2: return __builtin_cpu_supports("avx2");
+    case Kernel::avx512: return __builtin_cpu_supports("avx512f");
+#endif
+    default: return false;
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  char const* CatboostModel::GetKernelName(Kernel const kernel)
+  {
+    switch(kernel) {
+    case Kernel::scalar: return "scalar";
+    case Kernel::avx2: return "avx2";
+    case Kernel::avx512: return "avx512";
+    default: return "unknown";
+    }
+  }
+
+}
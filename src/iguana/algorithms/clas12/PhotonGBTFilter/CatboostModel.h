@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace iguana::clas12 {
+
+  /// @brief View of a CatBoost model of oblivious trees, which evaluates many samples at once
+  ///
+  /// The CatBoost C++ model export, _e.g._, `models/RGA_inbending_pass1.cpp`, defines a static struct with the model's tables,
+  /// and a function which evaluates one sample: it binarizes the sample's features, then walks every tree. The tables are
+  /// megabytes in size, so they are streamed through the cache once per sample. Instead, this class binarizes the features of a
+  /// block of samples, then walks each tree once for the whole block, accumulating every sample's score together. The scores
+  /// are the same as those of the exported function, since each sample's leaf values are summed in the same order.
+  ///
+  /// The trees are walked by a kernel which is chosen at run time for the CPU: on x86-64, the AVX-512 and AVX2 kernels
+  /// compute the leaf indices of the block's samples with vector instructions and gather their leaf values, and otherwise
+  /// a scalar kernel is used. All kernels give scores which are bit-for-bit identical to those of the exported function.
+  ///
+  /// Models are usually loaded from files in a binary format, with `CatboostModel::Load`, which memory-maps the file, so only
+  /// the pages which are used are read, and the pages are shared by all processes which use the model. The format is described in,
+  /// and files are made by, the converter `convert_catboost_model.py`, from a CatBoost JSON model or C++ model export.
+  class CatboostModel
+  {
+
+    public:
+
+      /// kernels which walk the trees for a block of samples
+      enum class Kernel {
+        scalar, ///< portable kernel
+        avx2, ///< x86-64 AVX2 kernel
+        avx512 ///< x86-64 AVX-512 kernel
+      };
+
+      /// precisions of the leaf values of a quantized model
+      enum class LeafPrecision {
+        float64, ///< double precision, as for the original model, so the scores are unchanged
+        float32, ///< single precision
+        fixed16 ///< 16-bit fixed point, with one scale for all leaf values, which are summed exactly
+      };
+
+      /// @param model the model's static struct, from the CatBoost C++ model export
+      template <typename MODEL>
+      CatboostModel(MODEL const& model)
+          : m_float_feature_count(model.FloatFeatureCount)
+          , m_binary_feature_count(model.BinaryFeatureCount)
+          , m_tree_count(model.TreeCount)
+          , m_tree_depth(model.TreeDepth)
+          , m_tree_splits(model.TreeSplits)
+          , m_border_counts(model.BorderCounts)
+          , m_borders(model.Borders)
+          , m_leaf_values(model.LeafValues)
+          , m_scale(model.Scale)
+          , m_bias(model.Bias)
+      {}
+
+      /// Load a model from a file in the binary model format, which is memory-mapped for the lifetime of the model and its copies
+      /// @param file_name the model file
+      /// @param huge_pages if true, advise the kernel to back the model's leaf values with huge pages, if it supports them
+      /// @returns the model
+      static CatboostModel Load(std::string const& file_name, bool const huge_pages = false) noexcept(false);
+
+      /// Quantize the model: its features are replaced by bucket indices, and its leaf values are stored with the given precision;
+      /// the model's tables are shared with the quantized model
+      /// @param leaf_precision the precision of the leaf values
+      /// @returns the quantized model
+      CatboostModel Quantize(LeafPrecision const leaf_precision) const noexcept(false);
+
+      /// @returns the largest difference between a raw score of this model and that of the original, unquantized model,
+      /// apart from floating-point rounding in the sum of the leaf values, which is zero unless the leaf values are quantized
+      double GetScoreErrorBound() const;
+
+      /// @returns the number of features of each sample
+      unsigned int GetFeatureCount() const { return m_float_feature_count; }
+
+      /// Evaluate the model for many samples; this uses the `ScratchArena`
+      /// @param features the features of each sample, `GetFeatureCount()` per sample, one sample after another
+      /// @param num_samples the number of samples
+      /// @param [out] scores the raw score of each sample, which must have room for `num_samples` values
+      void Evaluate(float const* features, std::size_t const num_samples, double* scores) const
+      {
+        Evaluate(features, num_samples, scores, GetBestKernel());
+      }
+
+      /// Evaluate the model for many samples with a specific kernel, _e.g._, to test it; see the other overload. The kernels walk the
+      /// trees for groups of 32 samples, however few there are, so the trees are walked for one sample after another if that is faster,
+      /// _e.g._, for the one or two photons of an event, whatever the kernel.
+      /// @param features the features of each sample, `GetFeatureCount()` per sample, one sample after another
+      /// @param num_samples the number of samples
+      /// @param [out] scores the raw score of each sample, which must have room for `num_samples` values
+      /// @param kernel the kernel, which must be available on this CPU
+      void Evaluate(float const* features, std::size_t const num_samples, double* scores, Kernel const kernel) const noexcept(false);
+
+      /// Evaluate the model for many samples, but stop walking the trees for a sample once its score is certain to be less than `lower`,
+      /// or certain to be greater than `upper`, whatever the values of its remaining trees' leaves: such a sample's score is `-infinity`,
+      /// or `+infinity`, respectively; the scores of the other samples are identical to those of `Evaluate`. This is only done for
+      /// quantized models, whose trees are walked in stages, between which the remaining samples are regrouped; otherwise, this is
+      /// the same as `Evaluate`. This uses the `ScratchArena`.
+      /// @param features the features of each sample, `GetFeatureCount()` per sample, one sample after another
+      /// @param num_samples the number of samples
+      /// @param lower the score below which the trees need not all be walked
+      /// @param upper the score above which the trees need not all be walked
+      /// @param [out] scores the raw score of each sample, which must have room for `num_samples` values
+      void EvaluateBounded(float const* features, std::size_t const num_samples, double const lower, double const upper, double* scores) const
+      {
+        EvaluateBounded(features, num_samples, lower, upper, scores, GetBestKernel());
+      }
+
+      /// Evaluate the model for many samples with early exit, with a specific kernel; see the other overload
+      /// @param features the features of each sample, `GetFeatureCount()` per sample, one sample after another
+      /// @param num_samples the number of samples
+      /// @param lower the score below which the trees need not all be walked
+      /// @param upper the score above which the trees need not all be walked
+      /// @param [out] scores the raw score of each sample, which must have room for `num_samples` values
+      /// @param kernel the kernel, which must be available on this CPU
+      void EvaluateBounded(float const* features, std::size_t const num_samples, double const lower, double const upper, double* scores, Kernel const kernel) const noexcept(false);
+
+      /// @returns the fastest kernel which is available on this CPU
+      static Kernel GetBestKernel();
+
+      /// @param kernel the kernel
+      /// @returns true if the kernel is available on this CPU
+      static bool IsKernelAvailable(Kernel const kernel);
+
+      /// @param kernel the kernel
+      /// @returns the name of the kernel
+      static char const* GetKernelName(Kernel const kernel);
+
+    private:
+
+      CatboostModel() = default;
+
+      struct quantized_t;
+
+      /// evaluate the original model for many samples; see `Evaluate`
+      void EvaluateBinarized(float const* features, std::size_t const num_samples, double* scores, Kernel const kernel) const;
+
+      /// evaluate the quantized model for many samples; see `EvaluateBounded`
+      void EvaluateQuantized(float const* features, std::size_t const num_samples, double const lower, double const upper, double* scores, Kernel const kernel) const;
+
+      /// the maximum number of samples for which the trees are walked together; their binarized features should fit in the cache,
+      /// and it must be a multiple of the number of samples that the vector kernels handle at once
+      static constexpr std::size_t s_block_size = 32;
+
+      /// the maximum number of samples of a quantized model for which the trees are walked together; their quantized features are
+      /// much smaller than binarized features, and the samples which remain after each stage of an early exit are regrouped within it
+      static constexpr std::size_t s_quantized_block_size = 256;
+
+      /// the number of trees of each stage of an early exit, after which the samples whose scores are certain stop walking the trees
+      static constexpr unsigned int s_stage_tree_count = 64;
+
+      /// the model's tables; see the CatBoost C++ model export
+      unsigned int m_float_feature_count;
+      unsigned int m_binary_feature_count;
+      unsigned int m_tree_count;
+      unsigned int const* m_tree_depth;
+      unsigned int const* m_tree_splits;
+      unsigned int const* m_border_counts;
+      float const* m_borders;
+      double const* m_leaf_values;
+      double m_scale;
+      double m_bias;
+
+      /// the memory-mapped model file, if the model was loaded from a file
+      std::shared_ptr<void const> m_mapping;
+
+      /// the quantized tables, if the model is quantized
+      std::shared_ptr<quantized_t const> m_quantized;
+  };
+
+}
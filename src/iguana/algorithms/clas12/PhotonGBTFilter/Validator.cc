@@ -61,7 +61,7 @@ namespace iguana::clas12 {
       filtered_photons.push_back(phot);
     }
 
-    // fill the plots
+    // fill this thread's shards of the plots
     FillHistograms(photons, 0);
     FillHistograms(filtered_photons, 1);
 
@@ -99,22 +99,28 @@ namespace iguana::clas12 {
 
   void PhotonGBTFilterValidator::FillHistograms(std::vector<ROOT::Math::PxPyPzEVector> const& photons, int idx) const
   {
+    auto hist_P   = GetHistShard(h_P.at(idx));
+    auto hist_Th  = GetHistShard(h_Th.at(idx));
+    auto hist_Phi = GetHistShard(h_Phi.at(idx));
+    auto hist_Mgg = GetHistShard(h_Mgg.at(idx));
+
     for(auto const& photon : photons) {
-      h_P.at(idx)->Fill(photon.P());
-      h_Th.at(idx)->Fill(photon.Theta() * 180.0 / M_PI);
-      h_Phi.at(idx)->Fill(photon.Phi() * 180.0 / M_PI);
+      hist_P->Fill(photon.P());
+      hist_Th->Fill(photon.Theta() * 180.0 / M_PI);
+      hist_Phi->Fill(photon.Phi() * 180.0 / M_PI);
     }
 
     for(size_t i = 0; i < photons.size(); ++i) {
       for(size_t j = i + 1; j < photons.size(); ++j) {
         auto diphoton = photons[i] + photons[j];
-        h_Mgg.at(idx)->Fill(diphoton.M());
+        hist_Mgg->Fill(diphoton.M());
       }
     }
   }
 
   void PhotonGBTFilterValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
       int n_rows = 2;
       int n_cols = 2;
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+
+"""
+Converts a CatBoost model of oblivious trees to the binary model format which
+`iguana::clas12::CatboostModel::Load` memory-maps; the input may be either:
+- a CatBoost JSON model, from `model.save_model('model.json', format='json')`
+- a CatBoost C++ model export, from `model.save_model('model.cpp', format='cpp')`
+
+The binary format is little-endian; it starts with this header:
+
+  offset  type        field
+  0       char[8]     magic, "IGUANACB"
+  8       uint32      format version
+  12      uint32      number of float features
+  16      uint32      number of binary features
+  20      uint32      number of trees
+  24      uint32      number of tree splits, the sum of the tree depths
+  28      uint32      number of leaf values
+  32      float64     scale
+  40      float64     bias
+  48      uint64[5]   byte offsets of the sections, in this order:
+                      border counts (uint32), borders (float32), tree depths (uint32),
+                      tree splits (uint32), leaf values (float64)
+  88      uint64      file size
+
+Each section starts on a page boundary, so the sections may be mapped and paged
+in independently, and the leaf values may be backed by huge pages.
+
+If a reference file name is given, the converter also writes the features of some
+samples and the model's raw scores for them, for testing; its scores are computed
+as the CatBoost C++ model export computes them, so they must be reproduced exactly.
+The samples' features are on, just above, or just below the model's borders, or far
+from them, so that every binarized feature is exercised with both values. The
+reference file is little-endian:
+
+  type                      field
+  uint32                    number of samples
+  uint32                    number of float features
+  float32[samples*features] the features, one sample after another
+  float64[samples]          the raw scores
+"""
+
+import sys, re, json, struct, random
+
+MAGIC     = b'IGUANACB'
+VERSION   = 1
+PAGE_SIZE = 4096
+HEADER    = struct.Struct('<8s6I2d6Q')
+
+# parse arguments
+if(len(sys.argv) < 3):
+    print(f'USAGE {__file__} [INPUT_MODEL(.json|.cpp)] [OUTPUT_FILE] [REFERENCE_FILE (optional)]')
+    exit(2)
+input_file_name = sys.argv[1]
+output_file_name = sys.argv[2]
+reference_file_name = sys.argv[3] if len(sys.argv) > 3 else None
+
+# the number of reference samples; more than a block of samples, and not a multiple of the block sizes, so that the last block is partial
+REFERENCE_SAMPLES = 301
+
+# read a CatBoost C++ model export, which defines a struct with the model's tables
+def read_cpp_model(text):
+    def array(name, convert):
+        match = re.search(r'\b' + name + r'\[\d*\]\s*=\s*\{(.*?)\}', text, re.S)
+        if match is None:
+            raise ValueError(f'C++ model export has no array "{name}"')
+        return [ convert(val.rstrip('f')) for val in re.split(r'[,\s]+', match.group(1).strip()) if val != '' ]
+    def scalar(name, convert):
+        match = re.search(r'\b' + name + r'\s*=\s*([^;]+);', text)
+        if match is None:
+            raise ValueError(f'C++ model export has no value "{name}"')
+        return convert(match.group(1).strip())
+    return {
+        'float_feature_count': scalar('FloatFeatureCount', int),
+        'border_counts':       array('BorderCounts', int),
+        'borders':             array('Borders', float),
+        'tree_depth':          array('TreeDepth', int),
+        'tree_splits':         array('TreeSplits', int),
+        'leaf_values':         array('LeafValues', float),
+        'scale':               scalar('Scale', float),
+        'bias':                scalar('Bias', float),
+    }
+
+# read a CatBoost JSON model; binary features are numbered by float feature, then by border,
+# as in the C++ model export, and each tree's splits are listed from its first level to its last
+def read_json_model(model):
+    float_features = sorted(model['features_info']['float_features'], key=lambda feature: feature['flat_feature_index'])
+    if model['features_info'].get('categorical_features'):
+        raise ValueError('models with categorical features are not supported')
+    border_counts = []
+    borders = []
+    binary_feature_index = {}
+    for feature in float_features:
+        for border in feature.get('borders') or []:
+            binary_feature_index[(feature['flat_feature_index'], border)] = len(borders)
+            borders.append(border)
+        border_counts.append(len(feature.get('borders') or []))
+    tree_depth = []
+    tree_splits = []
+    leaf_values = []
+    for tree in model['oblivious_trees']:
+        for split in tree['splits']:
+            if split.get('split_type', 'FloatFeature') != 'FloatFeature':
+                raise ValueError(f'unsupported split type "{split["split_type"]}"')
+            tree_splits.append(binary_feature_index[(split['float_feature_index'], split['border'])])
+        tree_depth.append(len(tree['splits']))
+        if len(tree['leaf_values']) != 1 << len(tree['splits']):
+            raise ValueError('only models with one output dimension are supported')
+        leaf_values += tree['leaf_values']
+    scale, bias = model.get('scale_and_bias', [1, [0]])
+    if isinstance(bias, list):
+        if len(bias) != 1:
+            raise ValueError('only models with one output dimension are supported')
+        bias = bias[0]
+    return {
+        'float_feature_count': len(float_features),
+        'border_counts':       border_counts,
+        'borders':             borders,
+        'tree_depth':          tree_depth,
+        'tree_splits':         tree_splits,
+        'leaf_values':         leaf_values,
+        'scale':               float(scale),
+        'bias':                float(bias),
+    }
+
+# check the consistency of the model's tables
+def check_model(model):
+    binary_feature_count = sum(model['border_counts'])
+    if len(model['border_counts']) != model['float_feature_count'] or len(model['borders']) != binary_feature_count:
+        raise ValueError('the numbers of features and borders are inconsistent')
+    if sum(model['tree_depth']) != len(model['tree_splits']):
+        raise ValueError('the tree depths and the number of tree splits are inconsistent')
+    if sum(1 << depth for depth in model['tree_depth']) != len(model['leaf_values']):
+        raise ValueError('the tree depths and the number of leaf values are inconsistent')
+    if any(split >= binary_feature_count for split in model['tree_splits']):
+        raise ValueError('a tree split refers to a nonexistent binary feature')
+
+# write the binary model
+def write_model(model, output_file):
+    sections = [
+        ('I', model['border_counts']),
+        ('f', model['borders']),
+        ('I', model['tree_depth']),
+        ('I', model['tree_splits']),
+        ('d', model['leaf_values']),
+    ]
+    offsets = []
+    offset = HEADER.size
+    for fmt, values in sections:
+        offset = -(-offset // PAGE_SIZE) * PAGE_SIZE
+        offsets.append(offset)
+        offset += struct.calcsize(fmt) * len(values)
+    file_size = offset
+    output_file.write(HEADER.pack(
+        MAGIC,
+        VERSION,
+        model['float_feature_count'],
+        len(model['borders']),
+        len(model['tree_depth']),
+        len(model['tree_splits']),
+        len(model['leaf_values']),
+        model['scale'],
+        model['bias'],
+        *offsets,
+        file_size,
+    ))
+    for (fmt, values), offset in zip(sections, offsets):
+        output_file.write(b'\0' * (offset - output_file.tell()))
+        output_file.write(struct.pack(f'<{len(values)}{fmt}', *values))
+
+# round a number to single precision
+def to_float32(value):
+    return struct.unpack('<f', struct.pack('<f', value))[0]
+
+# the next single-precision number after `value`, upward or downward
+def next_float32(value, upward):
+    if value == 0:
+        return struct.unpack('<f', struct.pack('<I', 1))[0] * (1 if upward else -1)
+    bits = struct.unpack('<I', struct.pack('<f', value))[0]
+    bits += 1 if (value > 0) == upward else -1
+    return struct.unpack('<f', struct.pack('<I', bits))[0]
+
+# generate the features of the reference samples
+def generate_features(model, rng):
+    borders = [ to_float32(border) for border in model['borders'] ]
+    features = []
+    for _ in range(REFERENCE_SAMPLES):
+        first_border = 0
+        for num_borders in model['border_counts']:
+            value = 0.0
+            if num_borders > 0:
+                border = borders[first_border + rng.randrange(num_borders)]
+                value = [
+                    border,
+                    next_float32(border, True),
+                    next_float32(border, False),
+                    to_float32(borders[first_border] - 1),
+                    to_float32(borders[first_border + num_borders - 1] + 1),
+                ][rng.randrange(5)]
+            features.append(value)
+            first_border += num_borders
+    return features
+
+# evaluate the model for one sample, as the CatBoost C++ model export does, summing the leaf values in the same order
+def evaluate(model, split_features, split_borders, sample):
+    result = 0.0
+    split = 0
+    leaf = 0
+    for depth in model['tree_depth']:
+        index = 0
+        for level in range(depth):
+            if sample[split_features[split + level]] > split_borders[split + level]:
+                index |= 1 << level
+        result += model['leaf_values'][leaf + index]
+        split += depth
+        leaf += 1 << depth
+    return model['scale'] * result + model['bias']
+
+# write the reference samples and their scores
+def write_reference(model, reference_file):
+    num_features = model['float_feature_count']
+    binary_feature_float_feature = [ i for i, num_borders in enumerate(model['border_counts']) for _ in range(num_borders) ]
+    split_features = [ binary_feature_float_feature[split] for split in model['tree_splits'] ]
+    split_borders = [ to_float32(model['borders'][split]) for split in model['tree_splits'] ]
+    features = generate_features(model, random.Random(1))
+    scores = [ evaluate(model, split_features, split_borders, features[s * num_features : (s + 1) * num_features]) for s in range(REFERENCE_SAMPLES) ]
+    reference_file.write(struct.pack('<2I', REFERENCE_SAMPLES, num_features))
+    reference_file.write(struct.pack(f'<{len(features)}f', *features))
+    reference_file.write(struct.pack(f'<{len(scores)}d', *scores))
+
+try:
+    if input_file_name.endswith('.json'):
+        with open(input_file_name) as input_file:
+            model = read_json_model(json.load(input_file))
+    else:
+        with open(input_file_name) as input_file:
+            model = read_cpp_model(input_file.read())
+    check_model(model)
+    with open(output_file_name, 'wb') as output_file:
+        write_model(model, output_file)
+    if reference_file_name is not None:
+        with open(reference_file_name, 'wb') as reference_file:
+            write_reference(model, reference_file)
+except (ValueError, KeyError) as ex:
+    print(f'ERROR: cannot convert model "{input_file_name}": {ex}', file=sys.stderr)
+    exit(1)
@@ -1,5 +1,7 @@
 #include "Algorithm.h"
 
+#include <array>
+
 namespace iguana::clas12 {
 
   REGISTER_IGUANA_ALGORITHM(SectorFinder, "REC::Particle::Sector");
@@ -21,29 +23,29 @@ namespace iguana::clas12 {
   {
     bool setDefaultBanks = false;
     // get expected bank indices
-    b_particle = GetBankIndex(banks, "REC::Particle");
+    b_particle = GetBankIndex(banks, "REC::Particle", BankAccess::read);
     if(o_bankname_charged != "default") {
-      b_user_charged            = GetBankIndex(banks, o_bankname_charged);
+      b_user_charged            = GetBankIndex(banks, o_bankname_charged, BankAccess::read);
       userSpecifiedBank_charged = true;
     }
     else {
-      b_track                   = GetBankIndex(banks, "REC::Track");
-      b_calorimeter             = GetBankIndex(banks, "REC::Calorimeter");
-      b_scint                   = GetBankIndex(banks, "REC::Scintillator");
+      b_track                   = GetBankIndex(banks, "REC::Track", BankAccess::read);
+      b_calorimeter             = GetBankIndex(banks, "REC::Calorimeter", BankAccess::read);
+      b_scint                   = GetBankIndex(banks, "REC::Scintillator", BankAccess::read);
       setDefaultBanks           = true;
       userSpecifiedBank_charged = false;
     }
 
     if(o_bankname_neutral != "default") {
-      b_user_neutral            = GetBankIndex(banks, o_bankname_neutral);
+      b_user_neutral            = GetBankIndex(banks, o_bankname_neutral, BankAccess::read);
       userSpecifiedBank_neutral = true;
     }
     else {
       // avoid setting default banks twice
       if(!setDefaultBanks) {
-        b_track         = GetBankIndex(banks, "REC::Track");
-        b_calorimeter   = GetBankIndex(banks, "REC::Calorimeter");
-        b_scint         = GetBankIndex(banks, "REC::Scintillator");
+        b_track         = GetBankIndex(banks, "REC::Track", BankAccess::read);
+        b_calorimeter   = GetBankIndex(banks, "REC::Calorimeter", BankAccess::read);
+        b_scint         = GetBankIndex(banks, "REC::Scintillator", BankAccess::read);
         setDefaultBanks = true;
       }
       userSpecifiedBank_neutral = false;
@@ -79,107 +81,119 @@ namespace iguana::clas12 {
   {
     resultBank->reset(); // IMPORTANT: always first `reset` the created bank(s)
 
-    std::vector<int> sectors_track;
-    std::vector<int> pindices_track;
-    std::vector<int> sectors_cal;
-    std::vector<int> pindices_cal;
-    std::vector<int> sectors_scint;
-    std::vector<int> pindices_scint;
-    std::vector<int> sectors_user_neutral;
-    std::vector<int> pindices_user_neutral;
-    std::vector<int> sectors_user_charged;
-    std::vector<int> pindices_user_charged;
-
     if(!userSpecifiedBank_charged || !userSpecifiedBank_neutral) {
-      if(trackBank != nullptr && calBank != nullptr && scintBank != nullptr) {
-        GetListsSectorPindex(*trackBank, sectors_track, pindices_track);
-        GetListsSectorPindex(*scintBank, sectors_scint, pindices_scint);
-        GetListsSectorPindex(*calBank, sectors_cal, pindices_cal);
-      }
-      else
+      if(trackBank == nullptr || calBank == nullptr || scintBank == nullptr)
         throw std::runtime_error("SectorFinder::RunImpl called with unexpected null pointer to either the track, calorimeter, or scintillator bank(s); please contact the maintainers");
     }
+    if((userSpecifiedBank_neutral && userNeutralBank == nullptr) || (userSpecifiedBank_charged && userChargedBank == nullptr))
+      throw std::runtime_error("SectorFinder::RunImpl called with unexpected null pointer to a user-specified bank; please contact the maintainers");
 
-    if(userSpecifiedBank_neutral) {
-      if(userNeutralBank != nullptr)
-        GetListsSectorPindex(*userNeutralBank, sectors_user_neutral, pindices_user_neutral);
-      else
-        throw std::runtime_error("SectorFinder::RunImpl called with unexpected null pointer to a user-specified bank; please contact the maintainers");
-    }
-
-    if(userSpecifiedBank_charged) {
-      if(userChargedBank != nullptr)
-        GetListsSectorPindex(*userChargedBank, sectors_user_charged, pindices_user_charged);
-      else
-        throw std::runtime_error("SectorFinder::RunImpl called with unexpected null pointer to a user-specified bank; please contact the maintainers");
+    // trace logging
+    if(m_log->IsEnabled(Logger::trace)) {
+      auto trace_lists = [this](std::string_view name, hipo::bank const* bank) {
+        if(bank == nullptr)
+          return;
+        std::vector<int> sectors;
+        std::vector<int> pindices;
+        GetListsSectorPindex(*bank, sectors, pindices);
+        m_log->Trace("pindices_{} = {}", name, fmt::join(pindices, ","));
+        m_log->Trace("sectors_{}  = {}", name, fmt::join(sectors, ","));
+      };
+      trace_lists("track", trackBank);
+      trace_lists("scint", scintBank);
+      trace_lists("cal", calBank);
+      trace_lists("user_neutral", userSpecifiedBank_neutral ? userNeutralBank : nullptr);
+      trace_lists("user_charged", userSpecifiedBank_charged ? userChargedBank : nullptr);
     }
 
-    // trace logging
-    if(m_log->GetLevel() <= Logger::Level::trace) {
-      m_log->Trace("pindices_track = {}", fmt::join(pindices_track, ","));
-      m_log->Trace("sectors_track  = {}", fmt::join(sectors_track, ","));
-      m_log->Trace("pindices_scint = {}", fmt::join(pindices_scint, ","));
-      m_log->Trace("sectors_scint  = {}", fmt::join(sectors_scint, ","));
-      m_log->Trace("pindices_cal   = {}", fmt::join(pindices_cal, ","));
-      m_log->Trace("sectors_cal    = {}", fmt::join(sectors_cal, ","));
-      m_log->Trace("pindices_user_neutral = {}", fmt::join(pindices_user_neutral, ","));
-      m_log->Trace("sectors_user_neutral  = {}", fmt::join(sectors_user_neutral, ","));
-      m_log->Trace("pindices_user_charged = {}", fmt::join(pindices_user_charged, ","));
-      m_log->Trace("sectors_user_charged  = {}", fmt::join(sectors_user_charged, ","));
+    // tables of sectors, indexed by `pindex`, for each detector bank; the standard method tries the first three, in this order
+    enum sector_table { kTrack,
+                        kScint,
+                        kCal,
+                        kUserNeutral,
+                        kUserCharged,
+                        nTables };
+    std::array<char const*, nTables> const table_names{"track", "scint", "cal", "user_neutral", "user_charged"};
+    std::array<hipo::bank const*, nTables> const table_banks{
+        trackBank,
+        scintBank,
+        calBank,
+        userSpecifiedBank_neutral ? userNeutralBank : nullptr,
+        userSpecifiedBank_charged ? userChargedBank : nullptr};
+    thread_local std::array<std::vector<int>, nTables> tables; // reused, to avoid reallocation for each event
+    int const num_particles = particleBank->getRows();
+    for(int t = 0; t < nTables; t++) {
+      if(table_banks[t] != nullptr)
+        FillSectorTable(*table_banks[t], num_particles, tables[t]);
     }
 
     // sync new bank with particle bank
-    resultBank->setRows(particleBank->getRows());
+    resultBank->setRows(num_particles);
     resultBank->getMutableRowList().setList(particleBank->getRowList());
 
     // some downstream algorithms may still need sector info, so obtain sector for _all_ particles,
     // not just the ones that were filtered out (use `.getRows()` rather than `.getRowList()`)
-    for(int row = 0; row < particleBank->getRows(); row++) {
+    for(int row = 0; row < num_particles; row++) {
 
       auto charge = particleBank->getInt("charge", row);
       int sect    = UNKNOWN_SECTOR;
 
       // if user-specified bank
       if(charge == 0 ? userSpecifiedBank_neutral : userSpecifiedBank_charged)
-        sect = GetSector(
-            charge == 0 ? sectors_user_neutral : sectors_user_charged,
-            charge == 0 ? pindices_user_neutral : pindices_user_charged,
-            row);
-      else // if not user-specified bank, use the standard method
-        sect = GetStandardSector(
-            sectors_track,
-            pindices_track,
-            sectors_cal,
-            pindices_cal,
-            sectors_scint,
-            pindices_scint,
-            row);
+        sect = tables[charge == 0 ? kUserNeutral : kUserCharged][row];
+      else { // if not user-specified bank, use the standard method
+        for(int t : {kTrack, kScint, kCal}) {
+          sect = tables[t][row];
+          m_log->Trace("{} pindex {} sect {}", table_names[t], row, sect);
+          if(IsValidSector(sect)) // use this sector number; if not valid, continue to next detector
+            break;
+        }
+      }
 
       resultBank->putInt(i_sector, row, sect);
       resultBank->putShort(i_pindex, row, static_cast<int16_t>(row));
     }
 
-    ShowBank(*resultBank, Logger::Header("CREATED BANK"));
+    ShowBankWithHeader(*resultBank, "CREATED BANK");
     return true;
   }
 
   void SectorFinder::GetListsSectorPindex(hipo::bank const& bank, std::vector<int>& sectors, std::vector<int>& pindices) const
   {
-    if(m_log->GetLevel() <= Logger::Level::trace) {
+    if(m_log->IsEnabled(Logger::trace)) {
       m_log->Trace("called `GetListsSectorPindex` for the following bank:");
       bank.show();
     }
     for(auto const& row : bank.getRowList()) {
       // check that we're only using FD detectors
       // eg have "sectors" in CND which we don't want to add here
-      auto det = bank.getByte("detector", row);
-      if(listFDDets.find(det) != listFDDets.end()) {
+      if(IsFDDetector(bank.getByte("detector", row))) {
         sectors.push_back(bank.getInt("sector", row));
         pindices.push_back(bank.getShort("pindex", row));
       }
     }
   }
 
+  void SectorFinder::FillSectorTable(hipo::bank const& bank, int const num_particles, std::vector<int>& sectors) const
+  {
+    auto& schema           = const_cast<hipo::bank&>(bank).getSchema();
+    auto const item_det    = schema.getEntryOrder("detector");
+    auto const item_sector = schema.getEntryOrder("sector");
+    auto const item_pindex = schema.getEntryOrder("pindex");
+    sectors.assign(num_particles, UNKNOWN_SECTOR);
+    // the first FD detector row is used, as in `GetSector`, so loop in reverse and let earlier rows overwrite later ones
+    auto const& rows = bank.getRowList();
+    for(auto it = rows.rbegin(); it != rows.rend(); ++it) {
+      if(!IsFDDetector(bank.getByte(item_det, *it)))
+        continue;
+      auto const pindex = bank.getShort(item_pindex, *it);
+      if(pindex < 0 || pindex >= num_particles)
+        continue;
+      auto const sect = bank.getInt(item_sector, *it);
+      sectors[pindex] = IsValidSector(sect) ? sect : UNKNOWN_SECTOR;
+    }
+  }
+
   int SectorFinder::GetSector(std::vector<int> const& sectors, std::vector<int> const& pindices, int const& pindex_particle) const
   {
     for(std::size_t i = 0; i < sectors.size(); i++) {
@@ -206,7 +220,7 @@ namespace iguana::clas12 {
                     nDet }; // try to get sector from these detectors, in this order
     for(int d = 0; d < nDet; d++) {
       int sect = UNKNOWN_SECTOR;
-      std::string det_name;
+      char const* det_name = "";
       switch(d) {
       case kTrack:
         sect     = GetSector(sectors_track, pindices_track, pindex_particle);
@@ -36,7 +36,7 @@ namespace iguana::clas12 {
     public:
 
       /// if this algorithm cannot determine the sector, this value will be used
-      static int const UNKNOWN_SECTOR = -1;
+      static constexpr int UNKNOWN_SECTOR = -1;
 
       /// @run_function
       /// uses track, calorimeter, and scintillator banks for both charged and neutral particles
@@ -243,6 +243,20 @@ namespace iguana::clas12 {
           hipo::bank const* userNeutralBank,
           hipo::bank* resultBank) const;
 
+      /// fill a table of sectors, indexed by `pindex`, from a detector bank, in one pass over its rows; for each particle, the
+      /// sector is the same as that from ::GetSector with the lists from ::GetListsSectorPindex, without searching the lists
+      /// @param [in] bank the detector bank
+      /// @param [in] num_particles the number of rows in `REC::Particle`
+      /// @param [out] sectors the table to fill; particles with no FD detector rows in `bank` have `UNKNOWN_SECTOR`
+      void FillSectorTable(hipo::bank const& bank, int const num_particles, std::vector<int>& sectors) const;
+
+      /// @param det the detector ID
+      /// @returns true if `det` is an FD detector
+      static bool IsFDDetector(int const det)
+      {
+        return det >= 0 && det < 64 && ((s_fd_dets >> det) & 1) != 0;
+      }
+
       /// `hipo::banklist` index for the particle bank
       hipo::banklist::size_type b_particle;
       hipo::banklist::size_type b_track;
@@ -262,14 +276,14 @@ namespace iguana::clas12 {
       std::string o_bankname_charged;
       std::string o_bankname_neutral;
 
-      // only want sectors from FD detectors
-      std::set<int> const listFDDets{
-          DetectorType::DC,
-          DetectorType::ECAL,
-          DetectorType::FTOF,
-          DetectorType::HTCC,
-          DetectorType::LTCC,
-          DetectorType::RICH};
+      // only want sectors from FD detectors; this is a bitmask of their IDs
+      static constexpr uint64_t s_fd_dets =
+          (uint64_t{1} << DetectorType::DC) |
+          (uint64_t{1} << DetectorType::ECAL) |
+          (uint64_t{1} << DetectorType::FTOF) |
+          (uint64_t{1} << DetectorType::HTCC) |
+          (uint64_t{1} << DetectorType::LTCC) |
+          (uint64_t{1} << DetectorType::RICH);
   };
 
 }
@@ -61,9 +61,7 @@ namespace iguana::clas12 {
 
     m_algo_seq->Run(banks);
 
-    // lock the mutex, so we can mutate plots
-    std::scoped_lock<std::mutex> lock(m_mutex);
-    // fill the plots
+    // fill this thread's shards of the plots
     for(auto const& row : particle_bank.getRowList()) {
 
       auto pdg    = particle_bank.getInt("pid", row);
@@ -86,7 +84,7 @@ namespace iguana::clas12 {
         // electrons are in FT or FD
         // sector should always be 1 if theta is larger than 5.5 degrees
         if(Theta > 6.5) {
-          u_IsInFD->Fill(sector);
+          GetHistShard(u_IsInFD)->Fill(sector);
           if(sector == 0) {
             m_log->Trace("e' with theta={} and sector==0, this should not happen", Theta);
           }
@@ -97,7 +95,7 @@ namespace iguana::clas12 {
       if(!IsValidSector(sector))
         continue;
       m_log->Trace("Filling SectorFinder Validator, pdg {} sector {} pindex {}", pdg, sector, row);
-      u_YvsX.at(pdg).at(sector - 1)->Fill(x, y);
+      GetHistShard(u_YvsX.at(pdg).at(sector - 1))->Fill(x, y);
     }
 
     return true;
@@ -106,6 +104,7 @@ namespace iguana::clas12 {
 
   void SectorFinderValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
       for(auto const& [pdg, plots] : u_YvsX) {
         int n_cols        = 3;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "iguana/algorithms/Algorithm.h"
+#include "iguana/algorithms/clas12/DetectorLinker/Algorithm.h"
 
 namespace iguana::clas12 {
 
@@ -10,11 +10,16 @@ namespace iguana::clas12 {
   /// This algorithm reads `REC::Traj` and produces a new bank, `REC::Particle::Traj`,
   /// to make it easier to access commonly used `REC::Traj` information for each particle.
   ///
+  /// The link is done by `clas12::DetectorLinker`, configured to link the DC regions; this algorithm
+  /// additionally sets the DC sector from the region 2 position.
+  ///
   /// If this algorithm does not provide information you need, ask the maintainers or open a pull request.
-  class TrajLinker : public Algorithm
+  ///
+  /// @doc_config{clas12/TrajLinker}
+  class TrajLinker : public DetectorLinker
   {
 
-      DEFINE_IGUANA_ALGORITHM(TrajLinker, clas12::TrajLinker)
+      DEFINE_IGUANA_SUBALGORITHM(TrajLinker, clas12::TrajLinker, DetectorLinker)
 
     private: // hooks
       void StartHook(hipo::banklist& banks) override;
@@ -40,26 +45,12 @@ namespace iguana::clas12 {
 
     private:
 
-      /// `hipo::banklist` indices
-      hipo::banklist::size_type b_particle;
-      hipo::banklist::size_type b_traj;
-      hipo::banklist::size_type b_result;
-
       // `b_result` bank item indices
-      int i_pindex;
       int i_sector;
-      int i_r1_found;
-      int i_r1_x;
-      int i_r1_y;
-      int i_r1_z;
       int i_r2_found;
       int i_r2_x;
       int i_r2_y;
       int i_r2_z;
-      int i_r3_found;
-      int i_r3_x;
-      int i_r3_y;
-      int i_r3_z;
   };
 
 }
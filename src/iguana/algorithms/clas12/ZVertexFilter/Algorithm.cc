@@ -17,7 +17,8 @@ namespace iguana::clas12 {
   {
     // get expected bank indices
     b_particle = GetBankIndex(banks, o_particle_bank);
-    b_config   = GetBankIndex(banks, "RUN::config");
+    b_config   = GetBankIndex(banks, "RUN::config", BankAccess::read);
+    ResolveBankColumns(banks, b_particle, c_vz, c_pid, c_status);
   }
 
   bool ZVertexFilter::RunHook(hipo::banklist& banks) const
@@ -27,29 +28,83 @@ namespace iguana::clas12 {
         GetBank(banks, b_config, "RUN::config"));
   }
 
-  bool ZVertexFilter::Run(hipo::bank& particleBank, hipo::bank const& configBank) const
+  void ZVertexFilter::RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const
   {
-    // dump the bank
-    ShowBank(particleBank, Logger::Header("INPUT PARTICLES"));
+    // consecutive events almost always have the same run number, so only prepare the event when it changes
+    std::optional<int> prev_runnum;
+    concurrent_key_t key = 0;
+    for(decltype(batch.size()) i = 0; i < batch.size(); i++) {
+      if(!accepted[i])
+        continue;
+      auto& particleBank     = GetBank(batch[i], b_particle, o_particle_bank);
+      auto const& configBank = GetBank(batch[i], b_config, "RUN::config");
+      auto runnum            = configBank.getInt("run", 0);
+      if(!prev_runnum.has_value() || prev_runnum.value() != runnum) {
+        key         = PrepareEvent(runnum);
+        prev_runnum = runnum;
+      }
+      accepted[i] = FilterParticleBank(particleBank, key);
+    }
+  }
+
+  std::optional<hipo::banklist::size_type> ZVertexFilter::GetRowFilterBank() const
+  {
+    return b_particle;
+  }
+
+  row_kernel_t ZVertexFilter::MakeRowKernel(hipo::banklist& banks) const
+  {
+    ResolveBankColumns(GetBank(banks, b_particle, o_particle_bank), c_vz, c_pid, c_status);
+    auto key = PrepareEvent(GetBank(banks, b_config, "RUN::config").getInt("run", 0));
+    return ScratchArena::Get().Make([this, key](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      FilterRows(bank, rows, accept, key, false);
+    });
+  }
 
+  bool ZVertexFilter::Run(hipo::bank& particleBank, hipo::bank const& configBank) const
+  {
     // prepare the event, reloading configuration parameters, if necessary
     auto key = PrepareEvent(configBank.getInt("run", 0));
+    return FilterParticleBank(particleBank, key);
+  }
+
+  bool ZVertexFilter::FilterParticleBank(hipo::bank& particleBank, concurrent_key_t const key) const
+  {
+    ResolveBankColumns(particleBank, c_vz, c_pid, c_status);
+
+    // dump the bank
+    ShowBankWithHeader(particleBank, "INPUT PARTICLES");
 
     // filter the input bank for requested PDG code(s)
-    particleBank.getMutableRowList().filter([this, key](auto bank, auto row) {
-      auto zvertex = bank.getFloat("vz", row);
-      auto pid     = bank.getInt("pid", row);
-      auto status  = bank.getShort("status", row);
-      auto accept  = Filter(zvertex, pid, status, key);
-      m_log->Debug("input vz {} pid {} status {} -- accept = {}", zvertex, pid, status, accept);
-      return accept ? 1 : 0;
+    auto const log_rows = m_log->IsEnabled(Logger::debug); // check once, rather than for each row
+    FilterRowList(particleBank, [this, key, log_rows](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      FilterRows(bank, rows, accept, key, log_rows);
     });
 
     // dump the modified bank
-    ShowBank(particleBank, Logger::Header("OUTPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
     return !particleBank.getRowList().empty();
   }
 
+  void ZVertexFilter::FilterRows(hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept, concurrent_key_t const key, bool const log_rows) const
+  {
+    // reused, to avoid reallocation for each event
+    thread_local std::vector<float> zvertices;
+    thread_local std::vector<int32_t> pids;
+    thread_local std::vector<int16_t> statuses;
+    c_vz.Gather(bank, rows, zvertices);
+    c_pid.Gather(bank, rows, pids);
+    c_status.Gather(bank, rows, statuses);
+    for(decltype(rows.size()) i = 0; i < rows.size(); i++) {
+      if(accept[i] == 0)
+        continue;
+      auto const pass = Filter(zvertices[i], pids[i], statuses[i], key);
+      if(log_rows)
+        m_log->Debug("input vz {} pid {} status {} -- accept = {}", zvertices[i], pids[i], statuses[i], pass);
+      accept[i] = pass ? 1 : 0;
+    }
+  }
+
   concurrent_key_t ZVertexFilter::PrepareEvent(int const runnum) const
   {
     m_log->Trace("calling PrepareEvent({})", runnum);
@@ -69,7 +124,9 @@ namespace iguana::clas12 {
 
   void ZVertexFilter::Reload(int const runnum, concurrent_key_t key) const
   {
+    Tracer::Span span(m_name, "Reload"); // includes the time waiting for the lock
     std::lock_guard<std::mutex> const lock(m_mutex); // NOTE: be sure to lock successive `ConcurrentParam::Save` calls !!!
+    Tracer::Span locked_span(m_name, "Reload(locked)");
     m_log->Trace("-> calling Reload({}, {})", runnum, key);
     o_runnum->Save(runnum, key);
     o_electron_vz_cuts->Save(GetOptionVector<double>({"electron", GetConfig()->InRange("runs", runnum), "vz"}), key);
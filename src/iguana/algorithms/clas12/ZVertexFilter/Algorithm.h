@@ -18,6 +18,9 @@ namespace iguana::clas12 {
       void ConfigHook() override;
       void StartHook(hipo::banklist& banks) override;
       bool RunHook(hipo::banklist& banks) const override;
+      std::optional<hipo::banklist::size_type> GetRowFilterBank() const override;
+      row_kernel_t MakeRowKernel(hipo::banklist& banks) const override;
+      void RunBatchHook(std::vector<hipo::banklist>& batch, std::vector<bool>& accepted) const override;
 
     public:
 
@@ -62,9 +65,20 @@ namespace iguana::clas12 {
     private:
       hipo::banklist::size_type b_particle, b_config;
 
+      /// particle bank column handles
+      BankColumn<float> c_vz{"vz"};
+      BankColumn<int32_t> c_pid{"pid"};
+      BankColumn<int16_t> c_status{"status"};
+
       // Reload function
       void Reload(int const runnum, concurrent_key_t key) const;
 
+      // filter the particle bank, for an event which has been prepared with `PrepareEvent`
+      bool FilterParticleBank(hipo::bank& particleBank, concurrent_key_t const key) const;
+
+      // row filter kernel, for an event which has been prepared with `PrepareEvent`: clear the accept flags of the rows which fail `Filter`
+      void FilterRows(hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept, concurrent_key_t const key, bool const log_rows) const;
+
       /// Particle bank name
       std::string o_particle_bank;
 
@@ -51,10 +51,7 @@ namespace iguana::clas12 {
   {
     auto& particle_bank = GetBank(banks, b_particle, "REC::Particle");
 
-    // lock the mutex, so we can mutate plots
-    std::scoped_lock<std::mutex> lock(m_mutex);
-
-    // fill the plots before
+    // fill this thread's shards of the plots before
     for(auto const& row : particle_bank.getRowList()) {
       double vz  = particle_bank.getFloat("vz", row);
       int pdg    = particle_bank.getInt("pid", row);
@@ -62,14 +59,14 @@ namespace iguana::clas12 {
       auto it    = u_zvertexplots.find(pdg);
       // check if pdg is amongs those that we want to plot
       if(it != u_zvertexplots.end() && abs(status) >= 2000) {
-        u_zvertexplots.at(pdg).at(0)->Fill(vz);
+        GetHistShard(u_zvertexplots.at(pdg).at(0))->Fill(vz);
       }
     }
 
     // run the momentum corrections
     m_algo_seq->Run(banks);
 
-    // fill the plots after
+    // fill this thread's shards of the plots after
     for(auto const& row : particle_bank.getRowList()) {
       double vz  = particle_bank.getFloat("vz", row);
       int pdg    = particle_bank.getInt("pid", row);
@@ -77,7 +74,7 @@ namespace iguana::clas12 {
       auto it    = u_zvertexplots.find(pdg);
       // check if pdg is amongs those that we want to plot
       if(it != u_zvertexplots.end() && abs(status) >= 2000) {
-        u_zvertexplots.at(pdg).at(1)->Fill(vz);
+        GetHistShard(u_zvertexplots.at(pdg).at(1))->Fill(vz);
       }
     }
     return true;
@@ -85,6 +82,7 @@ namespace iguana::clas12 {
 
   void ZVertexFilterValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
       for(auto const& [pdg, plots] : u_zvertexplots) {
         TString canv_name = Form("canv%d", pdg);
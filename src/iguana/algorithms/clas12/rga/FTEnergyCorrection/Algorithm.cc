@@ -16,7 +16,7 @@ namespace iguana::clas12::rga {
 
   bool FTEnergyCorrection::Run(hipo::bank& ftParticleBank) const
   {
-    ShowBank(ftParticleBank, Logger::Header("INPUT FT PARTICLES"));
+    ShowBankWithHeader(ftParticleBank, "INPUT FT PARTICLES");
     for(auto const& row : ftParticleBank.getRowList()) {
       if(ftParticleBank.getInt("pid", row) == particle::PDG::electron) {
         auto px                              = ftParticleBank.getFloat("px", row);
@@ -29,7 +29,7 @@ namespace iguana::clas12::rga {
         ftParticleBank.putFloat("pz", row, pz_new);
       }
     }
-    ShowBank(ftParticleBank, Logger::Header("OUTPUT FT PARTICLES"));
+    ShowBankWithHeader(ftParticleBank, "OUTPUT FT PARTICLES");
     return true;
   }
 
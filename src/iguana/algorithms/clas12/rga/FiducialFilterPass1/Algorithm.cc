@@ -20,9 +20,9 @@ namespace iguana::clas12::rga {
   void FiducialFilterPass1::StartHook(hipo::banklist& banks)
   {
     b_particle = GetBankIndex(banks, "REC::Particle");
-    b_config   = GetBankIndex(banks, "RUN::config");
-    b_traj     = GetBankIndex(banks, "REC::Particle::Traj");
-    b_cal      = GetBankIndex(banks, "REC::Particle::Calorimeter");
+    b_config   = GetBankIndex(banks, "RUN::config", BankAccess::read);
+    b_traj     = GetBankIndex(banks, "REC::Particle::Traj", BankAccess::read);
+    b_cal      = GetBankIndex(banks, "REC::Particle::Calorimeter", BankAccess::read);
   }
 
   //////////////////////////////////////////////////////////////////////////////////
@@ -42,7 +42,7 @@ namespace iguana::clas12::rga {
       hipo::bank const& trajBank,
       hipo::bank const& calBank) const
   {
-    ShowBank(particleBank, Logger::Header("INPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "INPUT PARTICLES");
 
     if(auto num_rows{particleBank.getRows()}; num_rows != trajBank.getRows() || num_rows != calBank.getRows()) {
       m_log->Error("number of particle bank rows differs from 'REC::Particle::Traj' and/or 'REC::Particle::Calorimeter' rows; are you sure these input banks are being filled?");
@@ -78,7 +78,7 @@ namespace iguana::clas12::rga {
         throw std::runtime_error(fmt::format("FiducialFilterPass1 filter encountered bad row number {}", row));
     });
 
-    ShowBank(particleBank, Logger::Header("OUTPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
     return !particleBank.getRowList().empty();
   }
 
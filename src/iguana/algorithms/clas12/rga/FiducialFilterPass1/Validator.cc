@@ -87,33 +87,33 @@ namespace iguana::clas12::rga {
     m_algo_traj.Run(banks);
     m_algo_cal.Run(banks);
 
-    // fill "before" histograms
+    // fill this thread's shards of the "before" histograms
     for(auto const& row : particle_bank.getRowList()) {
       auto pid = particle_bank.getInt("pid", row);
       if(pid != 11 && pid != 211 && pid != -211 && pid != 2212)
         continue;
       if(traj_bank.getByte("r1_found", row) == 1)
-        u_DC1_before.at(pid)->Fill(traj_bank.getFloat("r1_x", row), traj_bank.getFloat("r1_y", row));
+        GetHistShard(u_DC1_before.at(pid))->Fill(traj_bank.getFloat("r1_x", row), traj_bank.getFloat("r1_y", row));
       if(traj_bank.getByte("r2_found", row) == 1)
-        u_DC2_before.at(pid)->Fill(traj_bank.getFloat("r2_x", row), traj_bank.getFloat("r2_y", row));
+        GetHistShard(u_DC2_before.at(pid))->Fill(traj_bank.getFloat("r2_x", row), traj_bank.getFloat("r2_y", row));
       if(traj_bank.getByte("r3_found", row) == 1)
-        u_DC3_before.at(pid)->Fill(traj_bank.getFloat("r3_x", row), traj_bank.getFloat("r3_y", row));
+        GetHistShard(u_DC3_before.at(pid))->Fill(traj_bank.getFloat("r3_x", row), traj_bank.getFloat("r3_y", row));
     }
 
     // apply the fiducial cuts
     m_algo_fidu.Run(banks);
 
-    // fill "after" histograms (`particle_bank` is now filtered)
+    // fill this thread's shards of the "after" histograms (`particle_bank` is now filtered)
     for(auto const& row : particle_bank.getRowList()) {
       auto pid = particle_bank.getInt("pid", row);
       if(pid != 11 && pid != 211 && pid != -211 && pid != 2212)
         continue;
       if(traj_bank.getByte("r1_found", row) == 1)
-        u_DC1_after.at(pid)->Fill(traj_bank.getFloat("r1_x", row), traj_bank.getFloat("r1_y", row));
+        GetHistShard(u_DC1_after.at(pid))->Fill(traj_bank.getFloat("r1_x", row), traj_bank.getFloat("r1_y", row));
       if(traj_bank.getByte("r2_found", row) == 1)
-        u_DC2_after.at(pid)->Fill(traj_bank.getFloat("r2_x", row), traj_bank.getFloat("r2_y", row));
+        GetHistShard(u_DC2_after.at(pid))->Fill(traj_bank.getFloat("r2_x", row), traj_bank.getFloat("r2_y", row));
       if(traj_bank.getByte("r3_found", row) == 1)
-        u_DC3_after.at(pid)->Fill(traj_bank.getFloat("r3_x", row), traj_bank.getFloat("r3_y", row));
+        GetHistShard(u_DC3_after.at(pid))->Fill(traj_bank.getFloat("r3_x", row), traj_bank.getFloat("r3_y", row));
     }
     return true;
   }
@@ -121,6 +121,7 @@ namespace iguana::clas12::rga {
 
   void FiducialFilterPass1Validator::StopHook()
   {
+    MergeHistShards();
     m_algo_eb.Stop();
     m_algo_traj.Stop();
     m_algo_cal.Stop();
@@ -13,20 +13,6 @@ namespace iguana::clas12::rga {
     return false;
   }
 
-  static bool traj_has_detector(hipo::bank const* trajBank, int pindex, int detector)
-  {
-    if(!trajBank)
-      return false;
-    auto const& traj = *trajBank;
-    int const n      = traj.getRows();
-    for(int i = 0; i < n; ++i) {
-      if(traj.getInt("pindex", i) == pindex && traj.getInt("detector", i) == detector) {
-        return true;
-      }
-    }
-    return false;
-  }
-
   void FiducialFilterPass2::ConfigHook()
   {
     m_cal_strictness = GetOptionScalar<int>({"calorimeter", "strictness"});
@@ -81,6 +67,15 @@ namespace iguana::clas12::rga {
         throw std::runtime_error("[RGAFID] 'cvt.edge_layers' must be non-empty");
       }
       m_cvt.edge_min = GetOptionScalar<double>({"cvt", "edge_min"});
+      m_cvt_layer_index.clear();
+      for(std::size_t i = 0; i < m_cvt.edge_layers.size(); i++) {
+        int const layer = m_cvt.edge_layers[i];
+        if(layer < 0)
+          continue; // no such layer
+        if(static_cast<std::size_t>(layer) >= m_cvt_layer_index.size())
+          m_cvt_layer_index.resize(layer + 1, -1);
+        m_cvt_layer_index[layer] = static_cast<int>(i);
+      }
 
       m_cvt.phi_forbidden_deg.clear();
       try {
@@ -130,19 +125,26 @@ namespace iguana::clas12::rga {
   void FiducialFilterPass2::StartHook(hipo::banklist& banks)
   {
     b_particle = GetBankIndex(banks, "REC::Particle");
-    b_config   = GetBankIndex(banks, "RUN::config");
+    b_config   = GetBankIndex(banks, "RUN::config", BankAccess::read);
     if(banklist_has(banks, "REC::Calorimeter")) {
-      b_calor      = GetBankIndex(banks, "REC::Calorimeter");
+      b_calor      = GetBankIndex(banks, "REC::Calorimeter", BankAccess::read);
       m_have_calor = true;
     }
     if(banklist_has(banks, "REC::ForwardTagger")) {
-      b_ft      = GetBankIndex(banks, "REC::ForwardTagger");
+      b_ft      = GetBankIndex(banks, "REC::ForwardTagger", BankAccess::read);
       m_have_ft = true;
     }
     if(banklist_has(banks, "REC::Traj")) {
-      b_traj      = GetBankIndex(banks, "REC::Traj");
+      b_traj      = GetBankIndex(banks, "REC::Traj", BankAccess::read);
       m_have_traj = true;
     }
+    ResolveBankColumns(banks, b_particle, c_particle_pid, c_particle_px, c_particle_py, c_particle_pz);
+    if(m_have_calor)
+      ResolveBankColumns(banks, b_calor, c_calor_pindex, c_calor_layer, c_calor_sector, c_calor_lv, c_calor_lw, c_calor_lu);
+    if(m_have_ft)
+      ResolveBankColumns(banks, b_ft, c_ft_pindex, c_ft_x, c_ft_y);
+    if(m_have_traj)
+      ResolveBankColumns(banks, b_traj, c_traj_pindex, c_traj_detector, c_traj_layer, c_traj_edge, c_traj_x, c_traj_y);
   }
 
   bool FiducialFilterPass2::RunHook(hipo::banklist& banks) const
@@ -155,6 +157,29 @@ namespace iguana::clas12::rga {
         m_have_ft ? &GetBank(banks, b_ft, "REC::ForwardTagger") : nullptr);
   }
 
+  std::optional<hipo::banklist::size_type> FiducialFilterPass2::GetRowFilterBank() const
+  {
+    return b_particle;
+  }
+
+  row_kernel_t FiducialFilterPass2::MakeRowKernel(hipo::banklist& banks) const
+  {
+    auto& particle = GetBank(banks, b_particle, "REC::Particle");
+    auto& conf     = GetBank(banks, b_config, "RUN::config");
+    auto cal       = m_have_calor ? &GetBank(banks, b_calor, "REC::Calorimeter") : nullptr;
+    auto traj      = m_have_traj ? &GetBank(banks, b_traj, "REC::Traj") : nullptr;
+    auto ft        = m_have_ft ? &GetBank(banks, b_ft, "REC::ForwardTagger") : nullptr;
+    ResolveColumns(particle, cal, traj, ft);
+    // a fused stage makes all of its kernels before applying any, and it may have another instance of this algorithm, so unlike
+    // in `Run`, the summary cannot be thread-local; instead, it is allocated from the scratch arena, which the stage resets
+    auto& arena   = ScratchArena::Get();
+    auto& summary = arena.Make(EventSummary(&arena));
+    SummarizeEvent(particle, cal, traj, ft, summary);
+    return arena.Make([this, &conf, &summary](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      FilterRows(bank, rows, accept, conf, summary);
+    });
+  }
+
   bool FiducialFilterPass2::Run(
       hipo::bank& particle,
       hipo::bank const& conf,
@@ -162,132 +187,179 @@ namespace iguana::clas12::rga {
       hipo::bank const* traj,
       hipo::bank const* ft) const
   {
-    particle.getMutableRowList().filter([this, &conf, cal, traj, ft](auto bank, auto row) {
-      bool const keep = Filter(row, bank, conf, cal, traj, ft);
-      return keep ? 1 : 0;
+    ResolveColumns(particle, cal, traj, ft);
+    thread_local EventSummary summary; // reused, to avoid reallocation for each event
+    SummarizeEvent(particle, cal, traj, ft, summary);
+    FilterRowList(particle, [this, &conf](hipo::bank const& bank, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept) {
+      FilterRows(bank, rows, accept, conf, summary);
     });
     return !particle.getRowList().empty();
   }
 
-  FiducialFilterPass2::CalLayers
-  FiducialFilterPass2::CollectCalHitsForTrack(hipo::bank const& cal, int pindex)
+  void FiducialFilterPass2::FilterRows(
+      hipo::bank const& particle,
+      hipo::bank::rowlist::list_t const& rows,
+      row_mask_t& accept,
+      hipo::bank const& conf,
+      EventSummary const& summary) const
   {
-    CalLayers out;
-    int const n = cal.getRows();
-    for(int i = 0; i < n; ++i) {
-      if(cal.getInt("pindex", i) != pindex)
-        continue;
-      if(cal.getInt("layer", i) != DetectorLayer::PCAL)
-        continue; // PCal only
-      CalHit h;
-      h.sector = cal.getInt("sector", i);
-      h.lv     = cal.getFloat("lv", i);
-      h.lw     = cal.getFloat("lw", i);
-      h.lu     = cal.getFloat("lu", i);
-      out.L1.push_back(h);
-      out.has_any = true;
+    for(decltype(rows.size()) i = 0; i < rows.size(); i++) {
+      if(accept[i] != 0)
+        accept[i] = Filter(rows[i], particle, conf, summary) ? 1 : 0;
     }
-    return out;
   }
 
-  bool FiducialFilterPass2::PassCalStrictness(CalLayers const& H, int strictness)
+  void FiducialFilterPass2::ResolveColumns(
+      hipo::bank const& particle,
+      hipo::bank const* cal,
+      hipo::bank const* traj,
+      hipo::bank const* ft) const
   {
-    if(!H.has_any)
-      return true;
-
-    float min_lv = std::numeric_limits<float>::infinity();
-    float min_lw = std::numeric_limits<float>::infinity();
-    for(auto const& hit : H.L1) {
-      if(std::isfinite(hit.lv) && hit.lv < min_lv)
-        min_lv = hit.lv;
-      if(std::isfinite(hit.lw) && hit.lw < min_lw)
-        min_lw = hit.lw;
-    }
-
-    float const thr = (strictness == 1 ? 9.0f : strictness == 2 ? 13.5f
-                                                                : 18.0f);
-    return !(min_lv < thr || min_lw < thr);
+    ResolveBankColumns(particle, c_particle_pid, c_particle_px, c_particle_py, c_particle_pz);
+    if(cal)
+      ResolveBankColumns(*cal, c_calor_pindex, c_calor_layer, c_calor_sector, c_calor_lv, c_calor_lw, c_calor_lu);
+    if(ft)
+      ResolveBankColumns(*ft, c_ft_pindex, c_ft_x, c_ft_y);
+    if(traj)
+      ResolveBankColumns(*traj, c_traj_pindex, c_traj_detector, c_traj_layer, c_traj_edge, c_traj_x, c_traj_y);
   }
 
-  bool FiducialFilterPass2::PassFTFiducial(int pindex, hipo::bank const* ftBank) const
+  void FiducialFilterPass2::SummarizeEvent(
+      hipo::bank const& particle,
+      hipo::bank const* cal,
+      hipo::bank const* traj,
+      hipo::bank const* ft,
+      EventSummary& summary) const
   {
-    if(!ftBank)
-      return true;
-
-    auto const& ft = *ftBank;
-    int const n    = ft.getRows();
-    for(int i = 0; i < n; ++i) {
-      if(ft.getInt("pindex", i) != pindex)
-        continue;
+    int const num_tracks = particle.getRows();
+    int const num_layers = static_cast<int>(m_cvt.edge_layers.size());
+    summary.tracks.assign(num_tracks, TrackSummary{});
+    summary.cvt_edges.assign(num_tracks * num_layers, 0.0);
+    summary.cvt_edges_found.assign(num_tracks * num_layers, 0);
+
+    // get the summary of a row's particle, or `nullptr` if its `pindex` is not a particle row
+    auto get_track = [&summary, num_tracks](int const pindex) -> TrackSummary* {
+      return pindex >= 0 && pindex < num_tracks ? &summary.tracks[pindex] : nullptr;
+    };
 
-      double const x = ft.getFloat("x", i);
-      double const y = ft.getFloat("y", i);
-      double const r = std::hypot(x, y);
+    // the detector banks' rows are all used, rather than their row lists, to purposefully ignore upstream filters
+    if(cal) {
+      for(int i = 0; i < cal->getRows(); i++) {
+        auto track = get_track(c_calor_pindex.Get(*cal, i));
+        if(!track)
+          continue;
+        track->has_cal = true;
+        if(c_calor_layer.Get(*cal, i) != DetectorLayer::PCAL)
+          continue; // PCal only
+        track->has_pcal = true;
+        float const lv  = c_calor_lv.Get(*cal, i);
+        float const lw  = c_calor_lw.Get(*cal, i);
+        if(std::isfinite(lv) && lv < track->pcal_min_lv)
+          track->pcal_min_lv = lv;
+        if(std::isfinite(lw) && lw < track->pcal_min_lw)
+          track->pcal_min_lw = lw;
+      }
+    }
 
-      if(r < u_ft_params.rmin)
-        return false;
-      if(r > u_ft_params.rmax)
-        return false;
+    if(ft) {
+      for(int i = 0; i < ft->getRows(); i++) {
+        auto track = get_track(c_ft_pindex.Get(*ft, i));
+        if(!track || track->has_ft)
+          continue; // only the first hit is used
+        track->has_ft = true;
+        track->ft_x   = c_ft_x.Get(*ft, i);
+        track->ft_y   = c_ft_y.Get(*ft, i);
+      }
+    }
 
-      for(auto const& H : u_ft_params.holes) {
-        double const R = H[0], cx = H[1], cy = H[2];
-        double const d = std::hypot(x - cx, y - cy);
-        if(d < R)
-          return false;
+    // for each layer, the last row is used
+    if(traj) {
+      for(int i = 0; i < traj->getRows(); i++) {
+        int const pindex = c_traj_pindex.Get(*traj, i);
+        auto track       = get_track(pindex);
+        if(!track)
+          continue;
+        int const layer = c_traj_layer.Get(*traj, i);
+        switch(c_traj_detector.Get(*traj, i)) {
+        case DetectorType::CVT:
+          track->has_cvt = true;
+          if(layer >= 0 && layer < static_cast<int>(m_cvt_layer_index.size()) && m_cvt_layer_index[layer] >= 0) {
+            auto const idx               = pindex * num_layers + m_cvt_layer_index[layer];
+            summary.cvt_edges[idx]       = static_cast<double>(c_traj_edge.Get(*traj, i));
+            summary.cvt_edges_found[idx] = 1;
+          }
+          if(layer == 12) {
+            double const x = static_cast<double>(c_traj_x.Get(*traj, i));
+            double const y = static_cast<double>(c_traj_y.Get(*traj, i));
+            if(std::isfinite(x) && std::isfinite(y)) {
+              track->x12   = x;
+              track->y12   = y;
+              track->saw12 = true;
+            }
+          }
+          break;
+        case DetectorType::DC:
+          track->has_dc = true;
+          if(layer == 6)
+            track->dc_e1 = c_traj_edge.Get(*traj, i);
+          else if(layer == 18)
+            track->dc_e2 = c_traj_edge.Get(*traj, i);
+          else if(layer == 36)
+            track->dc_e3 = c_traj_edge.Get(*traj, i);
+          break;
+        }
       }
-      return true;
     }
-    return true;
   }
 
-  bool FiducialFilterPass2::PassCVTFiducial(int pindex, hipo::bank const* trajBank) const
+  bool FiducialFilterPass2::PassCalStrictness(TrackSummary const& track, int strictness)
   {
-    if(!trajBank)
+    if(!track.has_pcal)
       return true;
 
-    auto const& traj = *trajBank;
-    int const n      = traj.getRows();
-
-    std::map<int, double> edge_at_layer;
-
-    double x12 = 0.0, y12 = 0.0;
-    bool saw12 = false;
+    float const thr = (strictness == 1 ? 9.0f : strictness == 2 ? 13.5f
+                                                                : 18.0f);
+    return !(track.pcal_min_lv < thr || track.pcal_min_lw < thr);
+  }
 
-    for(int i = 0; i < n; ++i) {
-      if(traj.getInt("pindex", i) != pindex)
-        continue;
-      if(traj.getInt("detector", i) != DetectorType::CVT)
-        continue;
+  bool FiducialFilterPass2::PassFTFiducial(TrackSummary const& track) const
+  {
+    if(!track.has_ft)
+      return true;
 
-      int const layer   = traj.getInt("layer", i);
-      double const edge = static_cast<double>(traj.getFloat("edge", i));
+    double const x = track.ft_x;
+    double const y = track.ft_y;
+    double const r = std::hypot(x, y);
 
-      if(std::find(m_cvt.edge_layers.begin(), m_cvt.edge_layers.end(), layer) != m_cvt.edge_layers.end()) {
-        edge_at_layer[layer] = edge;
-      }
+    if(r < u_ft_params.rmin)
+      return false;
+    if(r > u_ft_params.rmax)
+      return false;
 
-      if(layer == 12) {
-        double const x = static_cast<double>(traj.getFloat("x", i));
-        double const y = static_cast<double>(traj.getFloat("y", i));
-        if(std::isfinite(x) && std::isfinite(y)) {
-          x12   = x;
-          y12   = y;
-          saw12 = true;
-        }
-      }
+    for(auto const& H : u_ft_params.holes) {
+      double const R = H[0], cx = H[1], cy = H[2];
+      double const d = std::hypot(x - cx, y - cy);
+      if(d < R)
+        return false;
     }
+    return true;
+  }
+
+  bool FiducialFilterPass2::PassCVTFiducial(int pindex, EventSummary const& summary) const
+  {
+    auto const& track     = summary.tracks[pindex];
+    auto const num_layers = m_cvt.edge_layers.size();
 
-    for(int L : m_cvt.edge_layers) {
-      auto it = edge_at_layer.find(L);
-      if(it == edge_at_layer.end())
+    for(std::size_t l = 0; l < num_layers; l++) {
+      if(!summary.cvt_edges_found[pindex * num_layers + l])
         continue;
-      if(!(it->second > m_cvt.edge_min)) {
+      if(!(summary.cvt_edges[pindex * num_layers + l] > m_cvt.edge_min)) {
         return false;
       }
     }
 
-    if(saw12 && !m_cvt.phi_forbidden_deg.empty()) {
-      double phi = std::atan2(y12, x12) * (180.0 / M_PI);
+    if(track.saw12 && !m_cvt.phi_forbidden_deg.empty()) {
+      double phi = std::atan2(track.y12, track.x12) * (180.0 / M_PI);
       if(phi < 0)
         phi += 360.0;
       for(std::size_t i = 0; i + 1 < m_cvt.phi_forbidden_deg.size(); i += 2) {
@@ -303,12 +375,12 @@ namespace iguana::clas12::rga {
   }
 
   bool FiducialFilterPass2::PassDCFiducial(int pindex, hipo::bank const& particleBank,
-                                           hipo::bank const& configBank, hipo::bank const* trajBank) const
+                                           hipo::bank const& configBank, TrackSummary const& track) const
   {
-    if(!trajBank)
+    if(!track.has_dc)
       return true;
 
-    int const pid    = particleBank.getInt("pid", pindex);
+    int const pid    = c_particle_pid.Get(particleBank, pindex);
     bool const isNeg = (pid == 11 || pid == -211 || pid == -321 || pid == -2212);
     bool const isPos = (pid == -11 || pid == 211 || pid == 321 || pid == 2212);
     if(!(isNeg || isPos))
@@ -319,35 +391,13 @@ namespace iguana::clas12::rga {
     bool const particle_inb = (electron_out ? isPos : isNeg);
     bool const particle_out = !particle_inb;
 
-    double const px    = particleBank.getFloat("px", pindex);
-    double const py    = particleBank.getFloat("py", pindex);
-    double const pz    = particleBank.getFloat("pz", pindex);
+    double const px    = c_particle_px.Get(particleBank, pindex);
+    double const py    = c_particle_py.Get(particleBank, pindex);
+    double const pz    = c_particle_pz.Get(particleBank, pindex);
     double const rho   = std::hypot(px, py);
     double const theta = std::atan2(rho, (pz == 0.0 ? 1e-12 : pz)) * (180.0 / M_PI);
 
-    double e1 = 0.0, e2 = 0.0, e3 = 0.0;
-    bool saw_dc = false;
-
-    auto const& traj = *trajBank;
-    int const n      = traj.getRows();
-    for(int i = 0; i < n; ++i) {
-      if(traj.getInt("pindex", i) != pindex)
-        continue;
-      if(traj.getInt("detector", i) != DetectorType::DC)
-        continue;
-      saw_dc          = true;
-      int const layer = traj.getInt("layer", i);
-      double const e  = traj.getFloat("edge", i);
-      if(layer == 6)
-        e1 = e;
-      else if(layer == 18)
-        e2 = e;
-      else if(layer == 36)
-        e3 = e;
-    }
-
-    if(!saw_dc)
-      return true;
+    double const e1 = track.dc_e1, e2 = track.dc_e2, e3 = track.dc_e3;
 
     auto pass3 = [](double a1, double a2, double a3, double t1, double t2, double t3) -> bool {
       return (a1 > t1 && a2 > t2 && a3 > t3);
@@ -366,41 +416,30 @@ namespace iguana::clas12::rga {
   }
 
   bool FiducialFilterPass2::Filter(int track_index, hipo::bank const& particleBank,
-                                   hipo::bank const& configBank, hipo::bank const* calBank,
-                                   hipo::bank const* trajBank, hipo::bank const* ftBank) const
+                                   hipo::bank const& configBank, EventSummary const& summary) const
   {
 
-    int const pid        = particleBank.getInt("pid", track_index);
+    int const pid        = c_particle_pid.Get(particleBank, track_index);
     int const strictness = m_cal_strictness;
 
-    auto has_assoc = [&track_index](hipo::bank const* b) -> bool {
-      if(!b)
-        return false;
-      int const n = b->getRows();
-      for(int i = 0; i < n; ++i)
-        if(b->getInt("pindex", i) == track_index)
-          return true;
-      return false;
-    };
-
-    bool const hasCal = has_assoc(calBank);
-    bool const hasFT  = has_assoc(ftBank);
-    bool const hasCVT = traj_has_detector(trajBank, track_index, DetectorType::CVT);
-    bool const hasDC  = traj_has_detector(trajBank, track_index, DetectorType::DC);
+    auto const& track = summary.tracks[track_index];
+    bool const hasCal = track.has_cal;
+    bool const hasFT  = track.has_ft;
+    bool const hasCVT = track.has_cvt;
+    bool const hasDC  = track.has_dc;
 
     bool pass = true;
 
     if(pid == 11 || pid == -11) {
       if(hasFT) {
-        pass = pass && PassFTFiducial(track_index, ftBank);
+        pass = pass && PassFTFiducial(track);
       }
       else {
         if(hasCal) {
-          auto calhits = CollectCalHitsForTrack(*calBank, track_index);
-          pass         = pass && PassCalStrictness(calhits, strictness);
+          pass = pass && PassCalStrictness(track, strictness);
         }
         if(hasDC) {
-          pass = pass && PassDCFiducial(track_index, particleBank, configBank, trajBank);
+          pass = pass && PassDCFiducial(track_index, particleBank, configBank, track);
         }
       }
       return pass;
@@ -408,11 +447,10 @@ namespace iguana::clas12::rga {
 
     if(pid == 22) {
       if(hasFT) {
-        pass = pass && PassFTFiducial(track_index, ftBank);
+        pass = pass && PassFTFiducial(track);
       }
       else if(hasCal) {
-        auto calhits = CollectCalHitsForTrack(*calBank, track_index);
-        pass         = pass && PassCalStrictness(calhits, strictness);
+        pass = pass && PassCalStrictness(track, strictness);
       }
       return pass;
     }
@@ -420,9 +458,9 @@ namespace iguana::clas12::rga {
     if(pid == 211 || pid == 321 || pid == 2212 ||
        pid == -211 || pid == -321 || pid == -2212) {
       if(hasCVT)
-        pass = pass && PassCVTFiducial(track_index, trajBank);
+        pass = pass && PassCVTFiducial(track_index, summary);
       if(hasDC)
-        pass = pass && PassDCFiducial(track_index, particleBank, configBank, trajBank);
+        pass = pass && PassDCFiducial(track_index, particleBank, configBank, track);
       return pass;
     }
 
@@ -2,6 +2,8 @@
 
 #include "iguana/algorithms/Algorithm.h"
 
+#include <limits>
+
 namespace iguana::clas12::rga {
 
   /// @algo_brief{Filter the `REC::Particle` bank using subsystem-specific fiducial cuts}
@@ -34,6 +36,8 @@ namespace iguana::clas12::rga {
       void ConfigHook() override;
       void StartHook(hipo::banklist& banks) override;
       bool RunHook(hipo::banklist& banks) const override;
+      std::optional<hipo::banklist::size_type> GetRowFilterBank() const override;
+      row_kernel_t MakeRowKernel(hipo::banklist& banks) const override;
 
     private:
       struct FTParams {
@@ -125,32 +129,83 @@ namespace iguana::clas12::rga {
       bool m_have_ft    = false;
       bool m_have_traj  = false;
 
+      // column handles
+      BankColumn<int32_t> c_particle_pid{"pid"};
+      BankColumn<float> c_particle_px{"px"};
+      BankColumn<float> c_particle_py{"py"};
+      BankColumn<float> c_particle_pz{"pz"};
+      BankColumn<int8_t> c_calor_layer{"layer"};
+      BankColumn<int8_t> c_calor_sector{"sector"};
+      BankColumn<float> c_calor_lv{"lv"};
+      BankColumn<float> c_calor_lw{"lw"};
+      BankColumn<float> c_calor_lu{"lu"};
+      BankColumn<float> c_ft_x{"x"};
+      BankColumn<float> c_ft_y{"y"};
+      BankColumn<int8_t> c_traj_layer{"layer"};
+      BankColumn<float> c_traj_edge{"edge"};
+      BankColumn<float> c_traj_x{"x"};
+      BankColumn<float> c_traj_y{"y"};
+
+      BankColumn<int16_t> c_calor_pindex{"pindex"};
+      BankColumn<int16_t> c_ft_pindex{"pindex"};
+      BankColumn<int16_t> c_traj_pindex{"pindex"};
+      BankColumn<int8_t> c_traj_detector{"detector"};
+
       // FT params (loaded from YAML)
       FTParams u_ft_params{};
 
-      // core filter functions
-      struct CalHit {
-          int sector = 0;
-          float lv = 0, lw = 0, lu = 0;
+      // summary of the detector banks' information for one particle, which is all the cuts need
+      struct TrackSummary {
+          // whether the particle has any row in each detector bank, or in each `REC::Traj` detector
+          bool has_cal = false;
+          bool has_ft  = false;
+          bool has_cvt = false;
+          bool has_dc  = false;
+          // PCAL: minimum finite lv and lw
+          bool has_pcal = false;
+          float pcal_min_lv = std::numeric_limits<float>::infinity();
+          float pcal_min_lw = std::numeric_limits<float>::infinity();
+          // FT: position of the first hit
+          float ft_x = 0, ft_y = 0;
+          // CVT: position at layer 12
+          bool saw12 = false;
+          double x12 = 0.0, y12 = 0.0;
+          // DC: edges at layers 6, 18, and 36
+          double dc_e1 = 0.0, dc_e2 = 0.0, dc_e3 = 0.0;
       };
-      struct CalLayers {
-          std::vector<CalHit> L1;
-          bool has_any = false;
+
+      // summary of the detector banks' information for all the particles of an event, built with one pass over each bank;
+      // its containers allocate from `resource`, which may be the `ScratchArena`
+      struct EventSummary {
+          EventSummary(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+              : tracks(resource), cvt_edges(resource), cvt_edges_found(resource) {}
+          // one per particle row
+          std::pmr::vector<TrackSummary> tracks;
+          // CVT edge for each particle row and each `m_cvt.edge_layers` element, and whether it was found
+          std::pmr::vector<double> cvt_edges;
+          std::pmr::vector<char> cvt_edges_found;
       };
 
-      static CalLayers CollectCalHitsForTrack(hipo::bank const& cal, int pindex);
-      static bool PassCalStrictness(CalLayers const& h, int strictness);
-      bool PassFTFiducial(int track_index, hipo::bank const* ftBank) const;
-      bool PassCVTFiducial(int track_index, hipo::bank const* trajBank) const;
+      // core filter functions
+      void ResolveColumns(hipo::bank const& particle, hipo::bank const* cal, hipo::bank const* traj, hipo::bank const* ft) const;
+      void SummarizeEvent(hipo::bank const& particle, hipo::bank const* cal, hipo::bank const* traj, hipo::bank const* ft,
+                          EventSummary& summary) const;
+      static bool PassCalStrictness(TrackSummary const& track, int strictness);
+      bool PassFTFiducial(TrackSummary const& track) const;
+      bool PassCVTFiducial(int track_index, EventSummary const& summary) const;
       bool PassDCFiducial(int track_index, hipo::bank const& particleBank,
-                          hipo::bank const& configBank, hipo::bank const* trajBank) const;
+                          hipo::bank const& configBank, TrackSummary const& track) const;
       bool Filter(int track_index, hipo::bank const& particleBank, hipo::bank const& configBank,
-                  hipo::bank const* calBank, hipo::bank const* trajBank, hipo::bank const* ftBank) const;
+                  EventSummary const& summary) const;
+      void FilterRows(hipo::bank const& particle, hipo::bank::rowlist::list_t const& rows, row_mask_t& accept,
+                      hipo::bank const& conf, EventSummary const& summary) const;
 
       // CVT/DC params;
       int m_cal_strictness = 1;
       CVTParams m_cvt{};
       DCParams m_dc{};
+      // for each CVT layer number, the index of `m_cvt.edge_layers`, or -1 if it is not used
+      std::vector<int> m_cvt_layer_index;
   };
 
 }
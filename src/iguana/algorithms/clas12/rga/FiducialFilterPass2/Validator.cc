@@ -198,6 +198,7 @@ namespace iguana::clas12::rga {
     // track torus polarity stats (labels for DC summary)
     {
       bool e_out = (config.getFloat("torus", 0) == 1.0f);
+      std::scoped_lock<std::mutex> lock(m_mutex);
       if(e_out)
         const_cast<FiducialFilterPass2Validator*>(this)->m_torus_out_events++;
       else
@@ -248,7 +249,7 @@ namespace iguana::clas12::rga {
         neg_after.insert(pidx);
     }
 
-    std::scoped_lock<std::mutex> lock(m_mutex);
+    // histograms are filled through this thread's shards, and the mutex is only locked to update the counters
 
     // PCal before/after (electrons, photons)
     if(m_have_calor) {
@@ -281,20 +282,21 @@ namespace iguana::clas12::rga {
         if(pid != 11 && pid != 22)
           continue;
 
-        auto& H = const_cast<FiducialFilterPass2Validator*>(this)->m_cal[pid][sector];
+        // `at`, since `operator[]` may insert, which is not thread safe; every PID here has its histograms from `StartHook`
+        auto const& H = m_cal.at(pid)[sector];
 
         if(lv >= 0.0 && lv <= 45.0)
-          H.lv_before->Fill(lv);
+          GetHistShard(H.lv_before)->Fill(lv);
         if(lw >= 0.0 && lw <= 45.0)
-          H.lw_before->Fill(lw);
+          GetHistShard(H.lw_before)->Fill(lw);
 
         bool const survived = eorg_after.count(pidx);
 
         if(survived) {
           if(lv >= 0.0 && lv <= 45.0)
-            H.lv_after->Fill(lv);
+            GetHistShard(H.lv_after)->Fill(lv);
           if(lw >= 0.0 && lw <= 45.0)
-            H.lw_after->Fill(lw);
+            GetHistShard(H.lw_after)->Fill(lw);
         }
 
         // unique pindex per sector (counts)
@@ -310,6 +312,7 @@ namespace iguana::clas12::rga {
         }
       }
 
+      std::scoped_lock<std::mutex> lock(m_mutex);
       for(int s = 1; s <= 6; ++s) {
         const_cast<FiducialFilterPass2Validator*>(this)->m_cal_counts[11][s].before += be_e[s].size();
         const_cast<FiducialFilterPass2Validator*>(this)->m_cal_counts[11][s].after += af_e[s].size();
@@ -344,26 +347,27 @@ namespace iguana::clas12::rga {
         double y = ft.getFloat("y", i);
         if(pid == 11) {
           if(!seen_b_e.count(pidx)) {
-            HH.before->Fill(x, y);
+            GetHistShard(HH.before)->Fill(x, y);
             seen_b_e.insert(pidx);
           }
           if(eorg_after.count(pidx) && !seen_a_e.count(pidx)) {
-            HH.after->Fill(x, y);
+            GetHistShard(HH.after)->Fill(x, y);
             seen_a_e.insert(pidx);
           }
         }
         else {
           if(!seen_b_g.count(pidx)) {
-            HH.before->Fill(x, y);
+            GetHistShard(HH.before)->Fill(x, y);
             seen_b_g.insert(pidx);
           }
           if(eorg_after.count(pidx) && !seen_a_g.count(pidx)) {
-            HH.after->Fill(x, y);
+            GetHistShard(HH.after)->Fill(x, y);
             seen_a_g.insert(pidx);
           }
         }
       }
 
+      std::scoped_lock<std::mutex> lock(m_mutex);
       const_cast<FiducialFilterPass2Validator*>(this)->m_ft_before_n[11] += seen_b_e.size();
       const_cast<FiducialFilterPass2Validator*>(this)->m_ft_after_n[11] += seen_a_e.size();
       const_cast<FiducialFilterPass2Validator*>(this)->m_ft_before_n[22] += seen_b_g.size();
@@ -399,15 +403,16 @@ namespace iguana::clas12::rga {
         double theta = std::atan2(rho, (z == 0.0 ? 1e-9 : z)) * (180.0 / kPI);
 
         if(!b_seen.count(pidx)) {
-          m_cvt_before->Fill(phi, theta);
+          GetHistShard(m_cvt_before)->Fill(phi, theta);
           b_seen.insert(pidx);
         }
         if(had_after.count(pidx) && !a_seen.count(pidx)) {
-          m_cvt_after->Fill(phi, theta);
+          GetHistShard(m_cvt_after)->Fill(phi, theta);
           a_seen.insert(pidx);
         }
       }
 
+      std::scoped_lock<std::mutex> lock(m_mutex);
       const_cast<FiducialFilterPass2Validator*>(this)->m_cvt_before_n += (long long)b_seen.size();
       const_cast<FiducialFilterPass2Validator*>(this)->m_cvt_after_n += (long long)a_seen.size();
     }
@@ -453,39 +458,39 @@ namespace iguana::clas12::rga {
 
       for(auto& kv : pos_r1) {
         if(m_dc_pos.r1_before)
-          m_dc_pos.r1_before->Fill(kv.second);
+          GetHistShard(m_dc_pos.r1_before)->Fill(kv.second);
         if(pos_after.count(kv.first) && m_dc_pos.r1_after)
-          m_dc_pos.r1_after->Fill(kv.second);
+          GetHistShard(m_dc_pos.r1_after)->Fill(kv.second);
       }
       for(auto& kv : pos_r2) {
         if(m_dc_pos.r2_before)
-          m_dc_pos.r2_before->Fill(kv.second);
+          GetHistShard(m_dc_pos.r2_before)->Fill(kv.second);
         if(pos_after.count(kv.first) && m_dc_pos.r2_after)
-          m_dc_pos.r2_after->Fill(kv.second);
+          GetHistShard(m_dc_pos.r2_after)->Fill(kv.second);
       }
       for(auto& kv : pos_r3) {
         if(m_dc_pos.r3_before)
-          m_dc_pos.r3_before->Fill(kv.second);
+          GetHistShard(m_dc_pos.r3_before)->Fill(kv.second);
         if(pos_after.count(kv.first) && m_dc_pos.r3_after)
-          m_dc_pos.r3_after->Fill(kv.second);
+          GetHistShard(m_dc_pos.r3_after)->Fill(kv.second);
       }
       for(auto& kv : neg_r1) {
         if(m_dc_neg.r1_before)
-          m_dc_neg.r1_before->Fill(kv.second);
+          GetHistShard(m_dc_neg.r1_before)->Fill(kv.second);
         if(neg_after.count(kv.first) && m_dc_neg.r1_after)
-          m_dc_neg.r1_after->Fill(kv.second);
+          GetHistShard(m_dc_neg.r1_after)->Fill(kv.second);
       }
       for(auto& kv : neg_r2) {
         if(m_dc_neg.r2_before)
-          m_dc_neg.r2_before->Fill(kv.second);
+          GetHistShard(m_dc_neg.r2_before)->Fill(kv.second);
         if(neg_after.count(kv.first) && m_dc_neg.r2_after)
-          m_dc_neg.r2_after->Fill(kv.second);
+          GetHistShard(m_dc_neg.r2_after)->Fill(kv.second);
       }
       for(auto& kv : neg_r3) {
         if(m_dc_neg.r3_before)
-          m_dc_neg.r3_before->Fill(kv.second);
+          GetHistShard(m_dc_neg.r3_before)->Fill(kv.second);
         if(neg_after.count(kv.first) && m_dc_neg.r3_after)
-          m_dc_neg.r3_after->Fill(kv.second);
+          GetHistShard(m_dc_neg.r3_after)->Fill(kv.second);
       }
 
       auto set_from_keys = [](std::unordered_map<int, double> const& m) {
@@ -518,6 +523,7 @@ namespace iguana::clas12::rga {
       std::set<int> neg_a2 = keep_if_survived(neg_b2, neg_after);
       std::set<int> neg_a3 = keep_if_survived(neg_b3, neg_after);
 
+      std::scoped_lock<std::mutex> lock(m_mutex);
       const_cast<FiducialFilterPass2Validator*>(this)->m_dc_pos_before_n += (long long)inter3(pos_b1, pos_b2, pos_b3);
       const_cast<FiducialFilterPass2Validator*>(this)->m_dc_pos_after_n += (long long)inter3(pos_a1, pos_a2, pos_a3);
       const_cast<FiducialFilterPass2Validator*>(this)->m_dc_neg_before_n += (long long)inter3(neg_b1, neg_b2, neg_b3);
@@ -716,6 +722,8 @@ namespace iguana::clas12::rga {
 
   void FiducialFilterPass2Validator::StopHook()
   {
+    MergeHistShards();
+
     // PCAL canvases
     DrawCalCanvas(11, "PCAL lv & lw (Electrons): before solid, after dashed");
     DrawCalCanvas(22, "PCAL lv & lw (Photons): before solid, after dashed");
@@ -8,8 +8,10 @@ namespace iguana::clas12::rga {
   void MomentumCorrection::StartHook(hipo::banklist& banks)
   {
     b_particle = GetBankIndex(banks, "REC::Particle");
-    b_sector   = GetBankIndex(banks, "REC::Particle::Sector");
-    b_config   = GetBankIndex(banks, "RUN::config");
+    b_sector   = GetBankIndex(banks, "REC::Particle::Sector", BankAccess::read);
+    b_config   = GetBankIndex(banks, "RUN::config", BankAccess::read);
+    ResolveBankColumns(banks, b_particle, c_px, c_py, c_pz, c_pid);
+    ResolveBankColumns(banks, b_sector, c_sector);
   }
 
 
@@ -27,25 +29,27 @@ namespace iguana::clas12::rga {
       hipo::bank const& sectorBank,
       hipo::bank const& configBank) const
   {
-    ShowBank(particleBank, Logger::Header("INPUT PARTICLES"));
+    ResolveBankColumns(particleBank, c_px, c_py, c_pz, c_pid);
+    ResolveBankColumns(sectorBank, c_sector);
+    ShowBankWithHeader(particleBank, "INPUT PARTICLES");
 
     auto torus = configBank.getFloat("torus", 0);
 
     for(auto const& row : particleBank.getRowList()) {
 
       auto [px, py, pz] = Transform(
-          particleBank.getFloat("px", row),
-          particleBank.getFloat("py", row),
-          particleBank.getFloat("pz", row),
-          sectorBank.getInt("sector", row),
-          particleBank.getInt("pid", row),
+          c_px.Get(particleBank, row),
+          c_py.Get(particleBank, row),
+          c_pz.Get(particleBank, row),
+          c_sector.Get(sectorBank, row),
+          c_pid.Get(particleBank, row),
           torus);
-      particleBank.putFloat("px", row, px);
-      particleBank.putFloat("py", row, py);
-      particleBank.putFloat("pz", row, pz);
+      c_px.Put(particleBank, row, px);
+      c_py.Put(particleBank, row, py);
+      c_pz.Put(particleBank, row, pz);
     }
 
-    ShowBank(particleBank, Logger::Header("OUTPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
     return true;
   }
 
@@ -79,6 +79,15 @@ namespace iguana::clas12::rga {
       hipo::banklist::size_type b_particle;
       hipo::banklist::size_type b_sector;
       hipo::banklist::size_type b_config;
+
+      /// `REC::Particle` column handles
+      BankColumn<float> c_px{"px"};
+      BankColumn<float> c_py{"py"};
+      BankColumn<float> c_pz{"pz"};
+      BankColumn<int32_t> c_pid{"pid"};
+
+      /// `REC::Particle::Sector` column handles
+      BankColumn<int32_t> c_sector{"sector"};
   };
 
 }
@@ -61,10 +61,7 @@ namespace iguana::clas12::rga {
     // run the momentum corrections
     m_algo_seq->Run(banks);
 
-    // lock the mutex, so we can mutate plots
-    std::scoped_lock<std::mutex> lock(m_mutex);
-
-    // fill the plots
+    // fill this thread's shards of the plots
     for(auto const& row : particle_bank.getRowList()) {
 
       auto pdg    = particle_bank.getInt("pid", row);
@@ -79,7 +76,7 @@ namespace iguana::clas12::rga {
           particle_bank.getFloat("py", row),
           particle_bank.getFloat("pz", row));
       auto delta_p = p_corrected - p_measured.at(row);
-      u_deltaPvsP.at(pdg).at(sector - 1)->Fill(p_corrected, delta_p);
+      GetHistShard(u_deltaPvsP.at(pdg).at(sector - 1))->Fill(p_corrected, delta_p);
     }
     return true;
   }
@@ -87,6 +84,7 @@ namespace iguana::clas12::rga {
 
   void MomentumCorrectionValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
       for(auto const& [pdg, plots] : u_deltaPvsP) {
         int n_cols        = 3;
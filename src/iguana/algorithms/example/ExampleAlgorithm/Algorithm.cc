@@ -52,6 +52,9 @@ namespace iguana::example {
     // #   required to run this algorithm
     // # - we set the bank index values into the `b_*` members, to
     // #   avoid looking them up in the `Algorithm::Run` method
+    // # - if this algorithm only reads a bank, pass `BankAccess::read` as the
+    // #   third argument, so `AlgorithmSequence` may run it concurrently with
+    // #   other algorithms which read the same bank
     // ############################################################################
     b_particle = GetBankIndex(banks, "REC::Particle");
     // ############################################################################
@@ -92,7 +95,7 @@ namespace iguana::example {
     // # - this provides a look at the bank _before_ the algorithm runs
     // # - this is optional
     // ############################################################################
-    ShowBank(particleBank, Logger::Header("INPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "INPUT PARTICLES");
 
     // ############################################################################
     // # loop over the bank rows
@@ -118,7 +121,7 @@ namespace iguana::example {
     // ############################################################################
     // # dump the modified bank (only if the log level is low enough); this is also optional
     // ############################################################################
-    ShowBank(particleBank, Logger::Header("OUTPUT PARTICLES"));
+    ShowBankWithHeader(particleBank, "OUTPUT PARTICLES");
 
     // ############################################################################
     // # return true or false, used as an event-level filter; in this case, we
@@ -8,7 +8,7 @@ namespace iguana::physics {
 
   void Depolarization::StartHook(hipo::banklist& banks)
   {
-    b_inc_kin = GetBankIndex(banks, "physics::InclusiveKinematics");
+    b_inc_kin = GetBankIndex(banks, "physics::InclusiveKinematics", BankAccess::read);
 
     // create the output bank
     auto result_schema = CreateBank(banks, b_result, GetClassName());
@@ -18,6 +18,9 @@ namespace iguana::physics {
     i_C                = result_schema.getEntryOrder("C");
     i_V                = result_schema.getEntryOrder("V");
     i_W                = result_schema.getEntryOrder("W");
+    m_result_columns.clear();
+    for(int item = 0; item < result_schema.getEntries(); item++)
+      m_result_columns.push_back({item, result_schema.getEntryType(item)});
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -34,40 +37,30 @@ namespace iguana::physics {
       hipo::bank& result_bank) const
   {
     result_bank.reset(); // IMPORTANT: always first `reset` the created bank(s)
-    ShowBank(inc_kin_bank, Logger::Header("INPUT INCLUSIVE KINEMATICS"));
+    ShowBankWithHeader(inc_kin_bank, "INPUT INCLUSIVE KINEMATICS");
 
     // set `result_bank` rows and rowlist to match those of `inc_kin_bank`
-    auto const& inc_kin_bank_rowlist = inc_kin_bank.getRowList();
     result_bank.setRows(inc_kin_bank.getRows());
-    result_bank.getMutableRowList().setList(inc_kin_bank_rowlist);
-
-    // loop over ALL `inc_kin_bank`'s rows; calculate depolarization for only the rows
-    // that are in its current rowlist, and zero the rest
-    for(int row = 0; row < inc_kin_bank.getRows(); row++) {
-      if(std::find(inc_kin_bank_rowlist.begin(), inc_kin_bank_rowlist.end(), row) != inc_kin_bank_rowlist.end()) {
-        auto result_vars = Compute(
-            inc_kin_bank.getDouble("Q2", row),
-            inc_kin_bank.getDouble("x", row),
-            inc_kin_bank.getDouble("y", row),
-            inc_kin_bank.getDouble("targetM", row));
-        result_bank.putDouble(i_epsilon, row, result_vars.epsilon);
-        result_bank.putDouble(i_A, row, result_vars.A);
-        result_bank.putDouble(i_B, row, result_vars.B);
-        result_bank.putDouble(i_C, row, result_vars.C);
-        result_bank.putDouble(i_V, row, result_vars.V);
-        result_bank.putDouble(i_W, row, result_vars.W);
-      }
-      else {
-        result_bank.putDouble(i_epsilon, row, 0);
-        result_bank.putDouble(i_A, row, 0);
-        result_bank.putDouble(i_B, row, 0);
-        result_bank.putDouble(i_C, row, 0);
-        result_bank.putDouble(i_V, row, 0);
-        result_bank.putDouble(i_W, row, 0);
-      }
+    result_bank.getMutableRowList().setList(inc_kin_bank.getRowList());
+
+    // zero ALL of `result_bank`'s rows at once, then calculate depolarization for only the rows
+    // that are in `inc_kin_bank`'s current rowlist
+    FillBankRows(result_bank, m_result_columns, 0, result_bank.getRows());
+    for(auto const& row : inc_kin_bank.getRowList()) {
+      auto result_vars = Compute(
+          inc_kin_bank.getDouble("Q2", row),
+          inc_kin_bank.getDouble("x", row),
+          inc_kin_bank.getDouble("y", row),
+          inc_kin_bank.getDouble("targetM", row));
+      result_bank.putDouble(i_epsilon, row, result_vars.epsilon);
+      result_bank.putDouble(i_A, row, result_vars.A);
+      result_bank.putDouble(i_B, row, result_vars.B);
+      result_bank.putDouble(i_C, row, result_vars.C);
+      result_bank.putDouble(i_V, row, result_vars.V);
+      result_bank.putDouble(i_W, row, result_vars.W);
     }
 
-    ShowBank(result_bank, Logger::Header("CREATED BANK"));
+    ShowBankWithHeader(result_bank, "CREATED BANK");
     return true;
   }
 
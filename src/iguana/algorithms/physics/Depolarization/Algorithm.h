@@ -50,6 +50,8 @@ namespace iguana::physics {
       int i_C;
       int i_V;
       int i_W;
+      /// every column of the created bank, with its type, for zero-filling with `FillBankRows`
+      std::vector<std::pair<int, int>> m_result_columns;
   };
 
 }
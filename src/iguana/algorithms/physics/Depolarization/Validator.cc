@@ -96,15 +96,14 @@ namespace iguana::physics {
       return false;
     }
 
-    // lock mutex and fill the plots
-    std::scoped_lock<std::mutex> lock(m_mutex);
+    // fill this thread's shards of the plots
     for(auto const& row : inc_kin_bank.getRowList()) {
       for(auto& plot : plots_vs_Q2)
-        plot.hist->Fill(inc_kin_bank.getDouble("Q2", row), plot.get_val(depol_bank, row));
+        GetHistShard(plot.hist)->Fill(inc_kin_bank.getDouble("Q2", row), plot.get_val(depol_bank, row));
       for(auto& plot : plots_vs_x)
-        plot.hist->Fill(inc_kin_bank.getDouble("x", row), plot.get_val(depol_bank, row));
+        GetHistShard(plot.hist)->Fill(inc_kin_bank.getDouble("x", row), plot.get_val(depol_bank, row));
       for(auto& plot : plots_vs_y)
-        plot.hist->Fill(inc_kin_bank.getDouble("y", row), plot.get_val(depol_bank, row));
+        GetHistShard(plot.hist)->Fill(inc_kin_bank.getDouble("y", row), plot.get_val(depol_bank, row));
     }
     return true;
   }
@@ -112,6 +111,7 @@ namespace iguana::physics {
 
   void DepolarizationValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
 
       auto make_plots = [this](TString const& name, std::vector<Plot2D> const& plot_list) {
@@ -36,8 +36,8 @@ namespace iguana::physics {
   void DihadronKinematics::StartHook(hipo::banklist& banks)
   {
     // get bank indices
-    b_particle = GetBankIndex(banks, o_particle_bank);
-    b_inc_kin  = GetBankIndex(banks, "physics::InclusiveKinematics");
+    b_particle = GetBankIndex(banks, o_particle_bank, BankAccess::read);
+    b_inc_kin  = GetBankIndex(banks, "physics::InclusiveKinematics", BankAccess::read);
 
     // create the output bank
     auto result_schema = CreateBank(banks, b_result, GetClassName());
@@ -72,7 +72,8 @@ namespace iguana::physics {
       hipo::bank& result_bank) const
   {
     result_bank.reset(); // IMPORTANT: always first `reset` the created bank(s)
-    ShowBank(particle_bank, Logger::Header("INPUT PARTICLES"));
+    ScratchArena::Scope const scratch_scope;
+    ShowBankWithHeader(particle_bank, "INPUT PARTICLES");
 
     if(particle_bank.getRowList().empty() || inc_kin_bank.getRowList().empty()) {
       m_log->Debug("skip this event, since not all required banks have entries");
@@ -110,7 +111,8 @@ namespace iguana::physics {
     auto p_q__breit = boost__breit(p_q);
 
     // build list of dihadron rows (pindices)
-    auto dih_rows = PairHadrons(particle_bank);
+    std::pmr::vector<std::pair<int, int>> dih_rows(&ScratchArena::Get());
+    FindHadronPairs(particle_bank, dih_rows);
 
     // loop over dihadrons
     result_bank.setRows(dih_rows.size());
@@ -212,7 +214,7 @@ namespace iguana::physics {
       dih_row++;
     }
 
-    ShowBank(result_bank, Logger::Header("CREATED BANK"));
+    ShowBankWithHeader(result_bank, "CREATED BANK");
     return result_bank.getRows() > 0;
   }
 
@@ -220,7 +222,17 @@ namespace iguana::physics {
 
   std::vector<std::pair<int, int>> DihadronKinematics::PairHadrons(hipo::bank const& particle_bank) const
   {
-    std::vector<std::pair<int, int>> result;
+    ScratchArena::Scope const scratch_scope;
+    std::pmr::vector<std::pair<int, int>> result(&ScratchArena::Get());
+    FindHadronPairs(particle_bank, result);
+    return {result.begin(), result.end()};
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void DihadronKinematics::FindHadronPairs(hipo::bank const& particle_bank, std::pmr::vector<std::pair<int, int>>& result) const
+  {
+    result.clear();
     // loop over particle bank rows, for hadron A
     for(auto const& row_a : particle_bank.getRowList()) {
       // check PDG is in the hadron-A list
@@ -242,13 +254,12 @@ namespace iguana::physics {
       }
     }
     // trace logging
-    if(m_log->GetLevel() <= Logger::Level::trace) {
+    if(m_log->IsEnabled(Logger::trace)) {
       if(result.empty())
         m_log->Trace("=> no dihadrons in this event");
       else
         m_log->Trace("=> number of dihadrons found: {}", result.size());
     }
-    return result;
   }
 
   ///////////////////////////////////////////////////////////////////////////////
@@ -56,6 +56,11 @@ namespace iguana::physics {
 
     private:
 
+      /// @brief form dihadrons by pairing hadrons, as `::PairHadrons` does
+      /// @param particle_bank the particle bank
+      /// @param result set to the list of pairs of hadron rows
+      void FindHadronPairs(hipo::bank const& particle_bank, std::pmr::vector<std::pair<int, int>>& result) const;
+
       // banklist indices
       hipo::banklist::size_type b_particle;
       hipo::banklist::size_type b_inc_kin;
@@ -62,8 +62,8 @@ namespace iguana::physics {
   void InclusiveKinematics::StartHook(hipo::banklist& banks)
   {
     // get bank indices
-    b_particle = GetBankIndex(banks, o_particle_bank);
-    b_config   = GetBankIndex(banks, "RUN::config");
+    b_particle = GetBankIndex(banks, o_particle_bank, BankAccess::read);
+    b_config   = GetBankIndex(banks, "RUN::config", BankAccess::read);
 
     // create the output bank
     auto result_schema = CreateBank(banks, b_result, GetClassName());
@@ -103,13 +103,13 @@ namespace iguana::physics {
       hipo::bank& result_bank) const
   {
     result_bank.reset(); // IMPORTANT: always first `reset` the created bank(s)
-    ShowBank(particle_bank, Logger::Header("INPUT PARTICLES"));
+    ShowBankWithHeader(particle_bank, "INPUT PARTICLES");
 
     auto key = PrepareEvent(config_bank.getInt("run", 0));
 
     auto const lepton_pindex = FindScatteredLepton(particle_bank, key);
     if(!lepton_pindex.has_value()) {
-      ShowBank(result_bank, Logger::Header("CREATED BANK IS EMPTY"));
+      ShowBankWithHeader(result_bank, "CREATED BANK IS EMPTY");
       return false;
     }
 
@@ -134,7 +134,7 @@ namespace iguana::physics {
     result_bank.putDouble(i_beamPz, 0, result_vars.beamPz);
     result_bank.putDouble(i_targetM, 0, result_vars.targetM);
 
-    ShowBank(result_bank, Logger::Header("CREATED BANK"));
+    ShowBankWithHeader(result_bank, "CREATED BANK");
     return true;
   }
 
@@ -219,11 +219,8 @@ namespace iguana::physics {
     }
 
     // make sure `lepton_row` was not filtered out
-    if(lepton_row.has_value()) {
-      auto rowlist = particle_bank.getRowList();
-      if(std::find(rowlist.begin(), rowlist.end(), lepton_row.value()) == rowlist.end())
-        lepton_row = std::nullopt;
-    }
+    if(lepton_row.has_value() && !GetRowListMask(particle_bank).Contains(lepton_row.value()))
+      lepton_row = std::nullopt;
 
     // return
     if(lepton_row.has_value())
@@ -256,7 +253,9 @@ namespace iguana::physics {
 
   void InclusiveKinematics::Reload(int const runnum, double const user_beam_energy, concurrent_key_t key) const
   {
+    Tracer::Span span(m_name, "Reload"); // includes the time waiting for the lock
     std::lock_guard<std::mutex> const lock(m_mutex);
+    Tracer::Span locked_span(m_name, "Reload(locked)");
     m_log->Trace("-> calling Reload({}, {}, {})", runnum, user_beam_energy, key);
     o_runnum->Save(runnum, key);
 
@@ -85,22 +85,22 @@ namespace iguana::physics {
     while(lepton_phi < -180)
       lepton_phi += 360;
 
-    // lock mutex and fill the plots
-    std::scoped_lock<std::mutex> lock(m_mutex);
-    lepton_p_dist->Fill(lepton_p);
-    lepton_theta_dist->Fill(lepton_theta);
-    lepton_phi_dist->Fill(lepton_phi);
-    lepton_vz_dist->Fill(lepton_vz);
-    Q2_vs_x->Fill(x, Q2);
-    Q2_vs_W->Fill(W, Q2);
-    y_dist->Fill(y);
-    nu_dist->Fill(nu);
+    // fill this thread's shards of the plots
+    GetHistShard(lepton_p_dist)->Fill(lepton_p);
+    GetHistShard(lepton_theta_dist)->Fill(lepton_theta);
+    GetHistShard(lepton_phi_dist)->Fill(lepton_phi);
+    GetHistShard(lepton_vz_dist)->Fill(lepton_vz);
+    GetHistShard(Q2_vs_x)->Fill(x, Q2);
+    GetHistShard(Q2_vs_W)->Fill(W, Q2);
+    GetHistShard(y_dist)->Fill(y);
+    GetHistShard(nu_dist)->Fill(nu);
     return true;
   }
 
 
   void InclusiveKinematicsValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
       int n_rows = 2;
       int n_cols = 4;
@@ -21,8 +21,8 @@ namespace iguana::physics {
   void SingleHadronKinematics::StartHook(hipo::banklist& banks)
   {
     // get bank indices
-    b_particle = GetBankIndex(banks, o_particle_bank);
-    b_inc_kin  = GetBankIndex(banks, "physics::InclusiveKinematics");
+    b_particle = GetBankIndex(banks, o_particle_bank, BankAccess::read);
+    b_inc_kin  = GetBankIndex(banks, "physics::InclusiveKinematics", BankAccess::read);
 
     // create the output bank
     auto result_schema = CreateBank(banks, b_result, GetClassName());
@@ -35,6 +35,11 @@ namespace iguana::physics {
     i_yB               = result_schema.getEntryOrder("yB");
     i_phiH             = result_schema.getEntryOrder("phiH");
     i_xi               = result_schema.getEntryOrder("xi");
+    m_result_columns.clear();
+    for(int item = 0; item < result_schema.getEntries(); item++) {
+      if(item != i_pindex && item != i_pdg)
+        m_result_columns.push_back({item, result_schema.getEntryType(item)});
+    }
 
     m_log->Warn("the kinematic calculations in this algorithm need to be cross checked; use this algorithm at your own risk!");
   }
@@ -55,7 +60,7 @@ namespace iguana::physics {
       hipo::bank& result_bank) const
   {
     result_bank.reset(); // IMPORTANT: always first `reset` the created bank(s)
-    ShowBank(particle_bank, Logger::Header("INPUT PARTICLES"));
+    ShowBankWithHeader(particle_bank, "INPUT PARTICLES");
 
     if(particle_bank.getRowList().empty() || inc_kin_bank.getRowList().empty()) {
       m_log->Debug("skip this event, since not all required banks have entries");
@@ -92,21 +97,26 @@ namespace iguana::physics {
     auto p_q__qp    = boost__qp(p_q);
     auto p_q__breit = boost__breit(p_q);
 
-    // banks' row lists
-    auto const& particle_bank_rowlist = particle_bank.getRowList();
+    // banks' row lists; `particle_bank_rowmask` tests whether a row is in `particle_bank`'s row list in constant time
+    auto const& particle_bank_rowmask = GetRowListMask(particle_bank);
     hipo::bank::rowlist::list_t result_bank_rowlist{};
     result_bank.setRows(particle_bank.getRows());
+    FillBankRows(result_bank, m_result_columns, 0, result_bank.getRows());
 
     // loop over ALL rows of `particle_bank`
-    // - we will calculate kinematics for rows in `particle_bank_rowlist`, and zero out all the other rows
+    // - we will calculate kinematics for rows in `particle_bank`'s row list; all the other rows were zeroed above
     // - we want the `result_bank` to have the same number of rows as `particle_bank` and the same ordering,
     //   so that banks which reference `particle_bank` rows can be used to reference `result_bank` rows too
     for(int row = 0; row < particle_bank.getRows(); row++) {
 
+      // every row has its `pindex` and `pdg`
+      auto pdg{particle_bank.getInt("pid", row)};
+      result_bank.putShort(i_pindex, row, static_cast<int16_t>(row));
+      result_bank.putInt(i_pdg, row, pdg);
+
       // if the particle is in `o_hadron_pdgs` AND the row is in `particle_bank`'s filtered row list
-      if(auto pdg{particle_bank.getInt("pid", row)};
-         o_hadron_pdgs.find(pdg) != o_hadron_pdgs.end() &&
-         std::find(particle_bank_rowlist.begin(), particle_bank_rowlist.end(), row) != particle_bank_rowlist.end()) {
+      if(o_hadron_pdgs.find(pdg) != o_hadron_pdgs.end() &&
+         particle_bank_rowmask.Contains(row)) {
 
         // hadron momentum
         auto p_Ph = ROOT::Math::PxPyPzMVector(
@@ -148,8 +158,6 @@ namespace iguana::physics {
         result_bank_rowlist.push_back(row);
 
         // fill the bank
-        result_bank.putShort(i_pindex, row, static_cast<int16_t>(row));
-        result_bank.putInt(i_pdg, row, pdg);
         result_bank.putDouble(i_z, row, z);
         result_bank.putDouble(i_PhPerp, row, PhPerp);
         result_bank.putDouble(i_MX2, row, MX2);
@@ -158,24 +166,12 @@ namespace iguana::physics {
         result_bank.putDouble(i_phiH, row, phiH);
         result_bank.putDouble(i_xi, row, xi);
       }
-      else {
-        // zero the row
-        result_bank.putShort(i_pindex, row, static_cast<int16_t>(row));
-        result_bank.putInt(i_pdg, row, pdg);
-        result_bank.putDouble(i_z, row, 0);
-        result_bank.putDouble(i_PhPerp, row, 0);
-        result_bank.putDouble(i_MX2, row, 0);
-        result_bank.putDouble(i_xF, row, 0);
-        result_bank.putDouble(i_yB, row, 0);
-        result_bank.putDouble(i_phiH, row, 0);
-        result_bank.putDouble(i_xi, row, 0);
-      }
     }
 
     // apply the filtered rowlist to `result_bank`
     result_bank.getMutableRowList().setList(result_bank_rowlist);
 
-    ShowBank(result_bank, Logger::Header("CREATED BANK"));
+    ShowBankWithHeader(result_bank, "CREATED BANK");
     return result_bank.getRows() > 0;
   }
 
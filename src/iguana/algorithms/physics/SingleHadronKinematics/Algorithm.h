@@ -59,6 +59,8 @@ namespace iguana::physics {
       int i_yB;
       int i_phiH;
       int i_xi;
+      /// every column of the created bank except `pindex` and `pdg`, which are set for every row, with its type, for zero-filling with `FillBankRows`
+      std::vector<std::pair<int, int>> m_result_columns;
 
       // config options
       std::string o_particle_bank;
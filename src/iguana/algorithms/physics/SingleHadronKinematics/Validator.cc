@@ -70,11 +70,11 @@ namespace iguana::physics {
       return false;
     }
 
-    // lock mutex and fill the plots
-    std::scoped_lock<std::mutex> lock(m_mutex);
-    for(auto const& row : result_bank.getRowList()) {
-      for(auto& plot : plot_list)
-        plot.hist->Fill(plot.get_val(result_bank, row));
+    // fill this thread's shards of the plots
+    for(auto& plot : plot_list) {
+      auto hist = GetHistShard(plot.hist);
+      for(auto const& row : result_bank.getRowList())
+        hist->Fill(plot.get_val(result_bank, row));
     }
     return true;
   }
@@ -82,6 +82,7 @@ namespace iguana::physics {
 
   void SingleHadronKinematicsValidator::StopHook()
   {
+    MergeHistShards();
     if(GetOutputDirectory()) {
       int const n_cols = 4;
       int const n_rows = (plot_list.size() - 1) / n_cols + 1;
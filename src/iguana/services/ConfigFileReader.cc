@@ -56,7 +56,7 @@ namespace iguana {
 
   void ConfigFileReader::PrintDirectories(Logger::Level const level)
   {
-    if(m_log->GetLevel() <= level) {
+    if(m_log->IsEnabled(level)) {
       m_log->Print(level, "{:=^60}", " Configuration file search path order: ");
       m_log->Print(level, " - ./");
       for(auto const& dir : m_directories)
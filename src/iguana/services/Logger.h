@@ -5,8 +5,15 @@
 #include <fmt/ranges.h>
 
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
 
+/// The lowest log level which is compiled; log messages below this level are removed at compile time.
+/// It is set by the build option `z_log_min_level`, and must be the name of a `iguana::Logger::Level`.
+#ifndef IGUANA_LOG_MIN_LEVEL
+#define IGUANA_LOG_MIN_LEVEL trace
+#endif
+
 namespace iguana {
 
   /// @brief Simple logger service
@@ -14,6 +21,20 @@ namespace iguana {
   /// - Each algorithm instance should own a `Logger` instance
   /// - The user may control the log level of each `Logger`, thus the log level of each algorithm
   /// - Errors and warnings print to `stderr`, whereas all other levels print to `stdout`
+  /// - Levels below `Logger::MIN_LEVEL` are removed at compile time; use the build option `z_log_min_level` to set it
+  ///
+  /// Log messages in hot loops, _e.g._, for each bank row, should not cost anything when they are not printed:
+  /// - the values of a log message may be callables which take no arguments, such as lambdas; they are only called if the
+  ///   message is printed, so they may be used to defer expensive work
+  /// - for more complicated printouts, guard them with `Logger::IsEnabled`
+  ///
+  /// **Example**
+  /// @code
+  /// m_log->Trace("sectors = {}", [&sectors]() { return fmt::format("{}", fmt::join(sectors, ",")); });
+  /// if(m_log->IsEnabled(Logger::trace)) {
+  ///   // ... expensive printouts ...
+  /// }
+  /// @endcode
   class Logger
   {
 
@@ -42,6 +63,9 @@ namespace iguana {
       /// The default log level
       static Level const DEFAULT_LEVEL = info;
 
+      /// The lowest log level which is compiled, from the build option `z_log_min_level`
+      static Level constexpr MIN_LEVEL = IGUANA_LOG_MIN_LEVEL;
+
       /// @param name the name of this logger instance, which will be include in all of its printouts
       /// @param lev the log level
       /// @param enable_style if true, certain printouts will be styled with color and emphasis
@@ -62,6 +86,15 @@ namespace iguana {
       /// @returns the log level
       Level GetLevel();
 
+      /// Check whether a log level is enabled; this is inlined, and if `lev` is a constant below `Logger::MIN_LEVEL`,
+      /// it is `false` at compile time, so any code guarded by it is removed
+      /// @param lev the log level
+      /// @returns true if messages at level `lev` would be printed
+      bool IsEnabled(Level const lev) const
+      {
+        return lev >= MIN_LEVEL && lev >= m_level;
+      }
+
       /// Get the current log level name
       /// @returns the log level
       std::string GetLevelName();
@@ -80,29 +113,30 @@ namespace iguana {
 
       /// Printout a log message at the `trace` level @see `Logger::Print` for more details
       template <typename... VALUES>
-      void Trace(std::string_view message, const VALUES... vals) const { Print(trace, message, vals...); }
+      void Trace(std::string_view message, VALUES const&... vals) const { Print(trace, message, vals...); }
       /// Printout a log message at the `debug` level @see `Logger::Print` for more details
       template <typename... VALUES>
-      void Debug(std::string_view message, const VALUES... vals) const { Print(debug, message, vals...); }
+      void Debug(std::string_view message, VALUES const&... vals) const { Print(debug, message, vals...); }
       /// Printout a log message at the `info` level @see `Logger::Print` for more details
       template <typename... VALUES>
-      void Info(std::string_view message, const VALUES... vals) const { Print(info, message, vals...); }
+      void Info(std::string_view message, VALUES const&... vals) const { Print(info, message, vals...); }
       /// Printout a log message at the `warn` level @see `Logger::Print` for more details
       template <typename... VALUES>
-      void Warn(std::string_view message, const VALUES... vals) const { Print(warn, message, vals...); }
+      void Warn(std::string_view message, VALUES const&... vals) const { Print(warn, message, vals...); }
       /// Printout a log message at the `error` level @see `Logger::Print` for more details
       template <typename... VALUES>
-      void Error(std::string_view message, const VALUES... vals) const { Print(error, message, vals...); }
+      void Error(std::string_view message, VALUES const&... vals) const { Print(error, message, vals...); }
 
       /// Printout a log message at the specified level. The message will only print if `lev` is at least as high as the current level of
       /// this `Logger` instance, as set by `Logger::SetLevel`.
       /// @param lev the log level for this message
       /// @param message the message to print; this may be a format string, as in `fmt::format`
-      /// @param vals values for the format string `message`
+      /// @param vals values for the format string `message`; a value which is a callable with no arguments is replaced by
+      /// its return value, and it is only called if the message is printed
       template <typename... VALUES>
-      void Print(Level const lev, std::string_view message, const VALUES... vals) const
+      void Print(Level const lev, std::string_view message, VALUES const&... vals) const
       {
-        if(lev >= m_level) {
+        if(IsEnabled(lev)) {
           if(auto it{m_level_names.find(lev)}; it != m_level_names.end()) {
             std::function<std::string(std::string)> style = [](std::string s) { return fmt::format("[{}]", s); };
             if(m_enable_style) {
@@ -120,7 +154,7 @@ namespace iguana {
             fmt::print(
                 lev >= warn ? stderr : stdout,
                 fmt::runtime(fmt::format("{} {} {}\n", style(it->second), style(m_name), message)),
-                vals...);
+                Evaluate(vals)...);
           }
           else {
             Warn("Logger::Print called with unknown log level '{}'; printing as error instead", static_cast<int>(lev)); // FIXME: static_cast -> fmt::underlying, but needs new version of fmt
@@ -131,6 +165,17 @@ namespace iguana {
 
     private:
 
+      /// @param val a log message value
+      /// @returns the return value of `val`, if it is a callable with no arguments, otherwise `val` itself
+      template <typename VALUE>
+      static decltype(auto) Evaluate(VALUE const& val)
+      {
+        if constexpr(std::is_invocable_v<VALUE const&>)
+          return val();
+        else
+          return (val);
+      }
+
       /// The name of this logger, which is included in all printouts
       std::string m_name;
 
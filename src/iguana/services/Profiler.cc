@@ -0,0 +1,238 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace iguana {
+
+  namespace {
+    /// the IDs of the profilers which have not been destroyed, so that threads may drop their counters of destroyed profilers
+    std::unordered_set<unsigned long long> live_profiler_ids;
+    std::mutex live_profiler_ids_mutex;
+  }
+
+  Profiler::Profiler(std::string_view name)
+      : Object(name)
+      , m_id([]() {
+        static std::atomic<unsigned long long> next_id{0};
+        return next_id++;
+      }())
+  {
+    std::lock_guard<std::mutex> const lock(live_profiler_ids_mutex);
+    live_profiler_ids.insert(m_id);
+  }
+
+  Profiler::~Profiler()
+  {
+    std::lock_guard<std::mutex> const lock(live_profiler_ids_mutex);
+    live_profiler_ids.erase(m_id);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  Profiler::Counters& Profiler::GetThreadCounters()
+  {
+    // each thread caches its counters for each profiler; the key is the profiler's ID rather than its address, since a new
+    // profiler may be allocated at the address of a destroyed one, whereas IDs are never reused
+    thread_local std::unordered_map<unsigned long long, Counters*> thread_counters;
+    if(auto it{thread_counters.find(m_id)}; it != thread_counters.end())
+      return *it->second;
+    // drop the dangling entries of destroyed profilers, so that the cache does not grow without bound
+    {
+      std::lock_guard<std::mutex> const lock(live_profiler_ids_mutex);
+      for(auto it = thread_counters.begin(); it != thread_counters.end();) {
+        if(live_profiler_ids.find(it->first) == live_profiler_ids.end())
+          it = thread_counters.erase(it);
+        else
+          ++it;
+      }
+    }
+    std::lock_guard<std::mutex> const lock(m_counters_mutex);
+    auto& counters = m_counters.emplace_back();
+    thread_counters.insert({m_id, &counters});
+    return counters;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  ProfileSummary Profiler::Summarize() const
+  {
+    ProfileSummary summary;
+    summary.name = m_name;
+    unsigned long long total_ns = 0;
+    Counters::Latency event_latency;
+    Counters::Latency batch_latency;
+    auto merge_latency = [](Counters::Latency& merged, Counters::Latency const& latency) {
+      merged.count += latency.count;
+      merged.max_ns = std::max(merged.max_ns, latency.max_ns);
+      for(int bin = 0; bin < Counters::num_bins; bin++)
+        merged.hist[bin] += latency.hist[bin];
+    };
+    for(auto const& counters : m_counters) {
+      summary.calls += counters.calls;
+      summary.batches += counters.batches;
+      summary.passed += counters.passed;
+      summary.rows_in += counters.rows_in;
+      summary.rows_out += counters.rows_out;
+      total_ns += counters.total_ns;
+      merge_latency(event_latency, counters.event_latency);
+      merge_latency(batch_latency, counters.batch_latency);
+    }
+    summary.total_ms    = total_ns / 1e6;
+    summary.timed_calls = event_latency.count;
+    // percentiles; the central value of the bin is used, but it cannot be larger than the maximum
+    auto percentile = [](Counters::Latency const& latency, double const q) {
+      unsigned long long const threshold = std::ceil(q * latency.count);
+      unsigned long long sum             = 0;
+      for(int bin = 0; bin < Counters::num_bins; bin++) {
+        sum += latency.hist[bin];
+        if(sum >= threshold && sum > 0)
+          return std::min(Counters::BinCenter(bin), static_cast<double>(latency.max_ns)) / 1e3;
+      }
+      return 0.0;
+    };
+    summary.p50_us       = percentile(event_latency, 0.50);
+    summary.p99_us       = percentile(event_latency, 0.99);
+    summary.max_us       = event_latency.max_ns / 1e3;
+    summary.batch_p50_us = percentile(batch_latency, 0.50);
+    summary.batch_p99_us = percentile(batch_latency, 0.99);
+    summary.batch_max_us = batch_latency.max_ns / 1e3;
+    return summary;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Profiler::PrintTable(std::vector<ProfileSummary> const& summaries, Logger& log, Logger::Level const level)
+  {
+    std::string::size_type name_width = 9;
+    for(auto const& summary : summaries)
+      name_width = std::max(name_width, summary.name.size());
+    // per-event latencies are of the events processed by `Run`; those processed by `RunBatch` only have per-batch latencies
+    auto const row_format = "{:<{}} {:>12} {:>9} {:>12} {:>11} {:>11} {:>11} {:>11} {:>12} {:>12} {:>9} {:>15} {:>15} {:>15}";
+    auto const width      = name_width + 110 + 58;
+    auto latency          = [](unsigned long long const count, double const us) { return count > 0 ? fmt::format("{:.3f}", us) : "-"; };
+    log.Print(level, "{:=^{}}", " PROFILE ", width);
+    log.Print(level, row_format, "algorithm", name_width, "calls", "pass rate", "total [ms]", "mean [us]", "p50 [us]", "p99 [us]", "max [us]", "rows in", "rows out", "batches", "batch p50 [us]", "batch p99 [us]", "batch max [us]");
+    for(auto const& summary : summaries) {
+      log.Print(level, row_format,
+          summary.name,
+          name_width,
+          summary.calls,
+          summary.calls > 0 ? fmt::format("{:.2f}%", 100.0 * summary.passed / summary.calls) : "-",
+          fmt::format("{:.3f}", summary.total_ms),
+          summary.calls > 0 ? fmt::format("{:.3f}", 1e3 * summary.total_ms / summary.calls) : "-",
+          latency(summary.timed_calls, summary.p50_us),
+          latency(summary.timed_calls, summary.p99_us),
+          latency(summary.timed_calls, summary.max_us),
+          summary.rows_in,
+          summary.rows_out,
+          summary.batches,
+          latency(summary.batches, summary.batch_p50_us),
+          latency(summary.batches, summary.batch_p99_us),
+          latency(summary.batches, summary.batch_max_us));
+    }
+    log.Print(level, "{:=^{}}", "", width);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Profiler::WriteJSON(std::vector<ProfileSummary> const& summaries, std::string const& file_name)
+  {
+    std::ofstream out(file_name);
+    if(!out.is_open())
+      throw std::runtime_error(fmt::format("cannot open profile output file {:?}", file_name));
+    out << "[\n";
+    for(decltype(summaries.size()) i = 0; i < summaries.size(); i++) {
+      auto const& summary = summaries[i];
+      out << fmt::format(
+          "  {{\"name\": {:?}, \"calls\": {}, \"timed_calls\": {}, \"batches\": {}, \"passed\": {}, \"rows_in\": {}, \"rows_out\": {}, "
+          "\"total_ms\": {}, \"p50_us\": {}, \"p99_us\": {}, \"max_us\": {}, \"batch_p50_us\": {}, \"batch_p99_us\": {}, \"batch_max_us\": {}}}{}\n",
+          summary.name,
+          summary.calls,
+          summary.timed_calls,
+          summary.batches,
+          summary.passed,
+          summary.rows_in,
+          summary.rows_out,
+          summary.total_ms,
+          summary.p50_us,
+          summary.p99_us,
+          summary.max_us,
+          summary.batch_p50_us,
+          summary.batch_p99_us,
+          summary.batch_max_us,
+          i + 1 < summaries.size() ? "," : "");
+    }
+    out << "]\n";
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Profiler::Counters::Record(
+      unsigned long long const elapsed_ns,
+      bool const event_passed,
+      unsigned long long const num_rows_in,
+      unsigned long long const num_rows_out)
+  {
+    calls++;
+    passed += event_passed ? 1 : 0;
+    rows_in += num_rows_in;
+    rows_out += num_rows_out;
+    total_ns += elapsed_ns;
+    event_latency.Fill(elapsed_ns);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Profiler::Counters::RecordBatch(
+      unsigned long long const elapsed_ns,
+      unsigned long long const num_calls,
+      unsigned long long const num_passed,
+      unsigned long long const num_rows_in,
+      unsigned long long const num_rows_out)
+  {
+    calls += num_calls;
+    batches++;
+    passed += num_passed;
+    rows_in += num_rows_in;
+    rows_out += num_rows_out;
+    total_ns += elapsed_ns;
+    batch_latency.Fill(elapsed_ns);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Profiler::Counters::Latency::Fill(unsigned long long const ns)
+  {
+    count++;
+    max_ns = std::max(max_ns, ns);
+    hist[Bin(ns)]++;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  int Profiler::Counters::Bin(unsigned long long const ns)
+  {
+    // the first `sub_bins` bins are 1 ns wide; after that, each power of two is split into `sub_bins` bins
+    if(ns < sub_bins)
+      return static_cast<int>(ns);
+    int const msb = 63 - __builtin_clzll(ns);
+    int const bin = (msb - 3) * sub_bins + static_cast<int>((ns >> (msb - 4)) & (sub_bins - 1));
+    return std::min(bin, num_bins - 1);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  double Profiler::Counters::BinCenter(int const bin)
+  {
+    if(bin < sub_bins)
+      return bin;
+    int const msb      = bin / sub_bins + 3;
+    double const width = std::ldexp(1.0, msb - 4);
+    return (sub_bins + bin % sub_bins) * width + width / 2;
+  }
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "Object.h"
+
+namespace iguana {
+
+  /// @brief Summary of an algorithm instance's profile, merged over all threads
+  struct ProfileSummary
+  {
+      /// the algorithm instance name
+      std::string name;
+      /// the number of events processed
+      unsigned long long calls = 0;
+      /// the number of batches processed, by `Algorithm::RunBatch`
+      unsigned long long batches = 0;
+      /// the number of events processed by `Algorithm::Run`, which are timed individually
+      unsigned long long timed_calls = 0;
+      /// the number of events for which the algorithm returned `true`
+      unsigned long long passed = 0;
+      /// the number of bank rows which were input to the algorithm
+      unsigned long long rows_in = 0;
+      /// the number of bank rows which were output from the algorithm
+      unsigned long long rows_out = 0;
+      /// the total wall time, in milliseconds
+      double total_ms = 0;
+      /// the median latency per event, in microseconds; only events processed by `Algorithm::Run` are timed individually
+      double p50_us = 0;
+      /// the 99th percentile latency per event, in microseconds; only events processed by `Algorithm::Run` are timed individually
+      double p99_us = 0;
+      /// the maximum latency per event, in microseconds; only events processed by `Algorithm::Run` are timed individually
+      double max_us = 0;
+      /// the median latency per batch, in microseconds
+      double batch_p50_us = 0;
+      /// the 99th percentile latency per batch, in microseconds
+      double batch_p99_us = 0;
+      /// the maximum latency per batch, in microseconds
+      double batch_max_us = 0;
+  };
+
+  /// @brief Per-algorithm counters for profiling: the number of calls, wall time, latency distribution and number of bank rows
+  ///
+  /// Each thread has its own set of counters, so that recording does not need a lock; they are merged by `Profiler::Summarize`,
+  /// which must only be called when no thread is recording, _e.g._, at `Algorithm::Stop`. The latency distributions are stored in
+  /// histograms with logarithmic bins, which have a relative resolution of about 6%.
+  ///
+  /// The events of a batch are processed together, so their latencies are not known; rather than splitting the batch's latency
+  /// evenly among them, it is recorded in a separate per-batch distribution.
+  class Profiler : public Object
+  {
+
+    public:
+
+      /// clock used for timing
+      using clock_t = std::chrono::steady_clock;
+
+      /// @brief One thread's counters; aligned to a cache line, so that threads do not share one
+      struct alignas(64) Counters
+      {
+          /// the number of histogram bins per power of two
+          static int constexpr sub_bins = 16;
+          /// the number of histogram bins: `sub_bins` 1 ns bins below 16 ns, then `sub_bins` bins for each power of two from 2^4 ns to 2^42 ns,
+          /// so latencies of 2^43 ns (about 2.4 hours) or more are put in the last bin
+          static int constexpr num_bins = 40 * sub_bins;
+
+          /// a latency distribution
+          struct Latency
+          {
+              /// the number of latencies recorded
+              unsigned long long count = 0;
+              unsigned long long max_ns = 0;
+              std::array<unsigned long long, num_bins> hist{};
+
+              /// @param ns a latency, in nanoseconds
+              void Fill(unsigned long long const ns);
+          };
+
+          unsigned long long calls    = 0;
+          unsigned long long batches  = 0;
+          unsigned long long passed   = 0;
+          unsigned long long rows_in  = 0;
+          unsigned long long rows_out = 0;
+          unsigned long long total_ns = 0;
+          /// latencies of events processed by `Algorithm::Run`
+          Latency event_latency;
+          /// latencies of batches processed by `Algorithm::RunBatch`
+          Latency batch_latency;
+
+          /// Record one event
+          /// @param elapsed_ns the wall time of the call, in nanoseconds
+          /// @param event_passed whether the algorithm returned `true`
+          /// @param num_rows_in the number of bank rows input to the call
+          /// @param num_rows_out the number of bank rows output from the call
+          void Record(
+              unsigned long long const elapsed_ns,
+              bool const event_passed,
+              unsigned long long const num_rows_in,
+              unsigned long long const num_rows_out);
+
+          /// Record a batch of events
+          /// @param elapsed_ns the wall time of the call, in nanoseconds
+          /// @param num_calls the number of events processed by the call
+          /// @param num_passed the number of events for which the algorithm returned `true`
+          /// @param num_rows_in the number of bank rows input to the call
+          /// @param num_rows_out the number of bank rows output from the call
+          void RecordBatch(
+              unsigned long long const elapsed_ns,
+              unsigned long long const num_calls,
+              unsigned long long const num_passed,
+              unsigned long long const num_rows_in,
+              unsigned long long const num_rows_out);
+
+          /// @param ns a latency, in nanoseconds
+          /// @returns the histogram bin for this latency
+          static int Bin(unsigned long long const ns);
+
+          /// @param bin a histogram bin
+          /// @returns the central latency of this bin, in nanoseconds
+          static double BinCenter(int const bin);
+      };
+
+      /// @param name the name of the profiled algorithm instance
+      Profiler(std::string_view name = "profiler");
+      ~Profiler();
+
+      /// Get the calling thread's counters, creating them if needed; this is thread safe
+      /// @returns the calling thread's counters
+      Counters& GetThreadCounters();
+
+      /// Merge the counters of all threads
+      /// @returns the merged summary
+      ProfileSummary Summarize() const;
+
+      /// Print a table of profile summaries
+      /// @param summaries the summaries to print, one per row
+      /// @param log the logger to print with
+      /// @param level the log level
+      static void PrintTable(std::vector<ProfileSummary> const& summaries, Logger& log, Logger::Level const level = Logger::info);
+
+      /// Write profile summaries to a JSON file
+      /// @param summaries the summaries to write
+      /// @param file_name the output file name
+      static void WriteJSON(std::vector<ProfileSummary> const& summaries, std::string const& file_name) noexcept(false);
+
+    private:
+
+      /// unique ID of this profiler, used to look up each thread's counters; IDs are never reused
+      unsigned long long const m_id;
+
+      /// all threads' counters; `std::deque` does not move its elements when it grows
+      std::deque<Counters> m_counters;
+      std::mutex m_counters_mutex;
+  };
+}
@@ -1,5 +1,6 @@
 #include "RCDBReader.h"
 #include "GlobalParam.h"
+#include "Tracer.h"
 #include "iguana/algorithms/TypeDefs.h"
 
 #ifdef USE_RCDB
@@ -62,12 +63,18 @@ namespace iguana {
     }
     // otherwise, query the RCDB
 #ifdef USE_RCDB
+    Tracer::Span span(m_name, "GetBeamEnergy"); // includes the time waiting for the lock
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    if(auto it{m_beam_energy_cache.find(runnum)}; it != m_beam_energy_cache.end())
+      return it->second;
     auto cnd = m_rcdb_connection->GetCondition(runnum, "beam_energy");
     if(!cnd) {
       m_log->Error("Failed to find beam energy from RCDB for run {}; assuming it is {} GeV", runnum, default_value);
       return default_value;
     }
-    return cnd->ToDouble() / 1e3; // convert [MeV] -> [GeV]
+    auto beam_energy = cnd->ToDouble() / 1e3; // convert [MeV] -> [GeV]
+    m_beam_energy_cache.insert({runnum, beam_energy});
+    return beam_energy;
 #else
     std::call_once(m_error_once, [&]() { m_log->Error("RCDB dependency not found; RCDBReader::GetBeamEnergy will return the default value of {} GeV.", default_value); });
     return default_value;
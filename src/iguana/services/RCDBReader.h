@@ -2,6 +2,7 @@
 
 #include "Object.h"
 #include <mutex>
+#include <unordered_map>
 
 #ifdef USE_RCDB
 // workaround ODR violations from header-only RCDB:
@@ -41,7 +42,8 @@ namespace iguana {
       ~RCDBReader();
 
       /// @param runnum run number
-      /// @returns the beam energy in GeV
+      /// @returns the beam energy in GeV; the result is cached, so each run number is only queried once
+      /// @note this method is thread safe, so one reader may be shared by several algorithm instances (see `Algorithm::Clone`)
       double GetBeamEnergy(int const runnum);
 
       /// @brief set the beam energy to a _fixed_ value; `GetBeamEnergy` will return _this_ energy
@@ -61,6 +63,12 @@ namespace iguana {
       /// beam energy override
       double m_beam_energy_override{-1};
 
+      /// cache of beam energies, keyed by run number
+      std::unordered_map<int, double> m_beam_energy_cache;
+
+      /// mutex for RCDB queries and the caches
+      std::mutex m_mutex;
+
 #ifdef USE_RCDB
       std::unique_ptr<rcdb::Connection> m_rcdb_connection;
 #endif
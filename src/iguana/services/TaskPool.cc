@@ -0,0 +1,101 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+
+namespace iguana {
+
+  TaskPool::TaskPool(unsigned int const num_threads, std::string_view name)
+      : Object(name)
+  {
+    m_log->Debug("starting {} worker threads", num_threads);
+    for(unsigned int i = 0; i < num_threads; i++)
+      m_workers.emplace_back([this]() { Work(); });
+  }
+
+  TaskPool::~TaskPool()
+  {
+    {
+      std::lock_guard<std::mutex> const lock(m_queue_mutex);
+      m_stopping = true;
+    }
+    m_queue_cv.notify_all();
+    for(auto& worker : m_workers)
+      worker.join();
+  }
+
+  bool TaskPool::RunEach(std::size_t const num_tasks, bool (*call)(void const*, std::size_t), void const* task) noexcept(false)
+  {
+    if(num_tasks == 0)
+      return true;
+
+    // without workers, or with only one task, just run them serially
+    if(m_workers.empty() || num_tasks == 1) {
+      for(std::size_t i = 0; i < num_tasks; i++) {
+        if(!call(task, i))
+          return false;
+      }
+      return true;
+    }
+
+    // offer the tasks to the workers, and claim tasks on this thread too, until none are left
+    job_t job{call, task, num_tasks, 0, 0, false, nullptr};
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    m_jobs.push_back(&job);
+    m_queue_cv.notify_all();
+    while(job.next < job.num_tasks) {
+      auto const i = job.next++;
+      if(job.next == job.num_tasks)
+        m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), &job));
+      RunTask(job, i, lock);
+    }
+
+    // wait for the tasks which the workers claimed; the job must outlive them
+    m_done_cv.wait(lock, [&job]() { return job.finished == job.num_tasks; });
+    if(job.ex)
+      std::rethrow_exception(job.ex);
+    return !job.skip;
+  }
+
+  void TaskPool::RunTask(job_t& job, std::size_t const i, std::unique_lock<std::mutex>& lock)
+  {
+    if(!job.skip) {
+      lock.unlock();
+      bool go_on = false;
+      std::exception_ptr ex;
+      try {
+        go_on = job.call(job.task, i);
+      }
+      catch(...) {
+        ex = std::current_exception();
+      }
+      lock.lock();
+      if(!go_on)
+        job.skip = true;
+      if(ex && !job.ex)
+        job.ex = ex;
+    }
+    if(++job.finished == job.num_tasks)
+      m_done_cv.notify_all();
+  }
+
+  unsigned int TaskPool::GetNumThreads() const
+  {
+    return static_cast<unsigned int>(m_workers.size());
+  }
+
+  void TaskPool::Work()
+  {
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    while(true) {
+      m_queue_cv.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+      if(m_jobs.empty())
+        return;
+      auto& job    = *m_jobs.front();
+      auto const i = job.next++;
+      if(job.next == job.num_tasks)
+        m_jobs.pop_front();
+      RunTask(job, i, lock);
+    }
+  }
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Object.h"
+
+namespace iguana {
+
+  /// @brief A fixed-size pool of worker threads, for running independent tasks concurrently
+  ///
+  /// Tasks are submitted in groups with `TaskPool::RunEach`, which blocks until all of them are done.
+  /// The calling thread runs tasks too, so a pool with `N` workers runs up to `N+1` tasks at a time.
+  /// Submitting a group does not allocate: the tasks are claimed by index from a job on the caller's stack.
+  class TaskPool : public Object
+  {
+
+    public:
+
+      /// @param num_threads the number of worker threads
+      /// @param name the name of this pool
+      TaskPool(unsigned int const num_threads, std::string_view name = "task_pool");
+      ~TaskPool();
+
+      /// Run a group of tasks, numbered from `0` to `num_tasks - 1`, and wait for all of them to finish. Each task returns
+      /// whether the group should go on: once a task returns `false`, or throws an exception, the tasks which have not
+      /// yet started are skipped. The first exception is rethrown after all the started tasks are finished.
+      /// This method is thread safe.
+      /// @param num_tasks the number of tasks
+      /// @param task the function which runs a task, given its number, and returns `false` to skip the remaining tasks
+      /// @returns `true` if every task ran and returned `true`
+      template <typename TASK>
+      bool RunEach(std::size_t const num_tasks, TASK const& task) noexcept(false)
+      {
+        return RunEach(num_tasks, [](void const* task_ptr, std::size_t const i) -> bool { return (*static_cast<TASK const*>(task_ptr))(i); }, &task);
+      }
+
+      /// @returns the number of worker threads
+      unsigned int GetNumThreads() const;
+
+    private:
+
+      /// a group of tasks, which lives on the stack of the `RunEach` caller
+      struct job_t
+      {
+          /// calls the task function
+          bool (*call)(void const*, std::size_t);
+          /// the task function
+          void const* task;
+          std::size_t num_tasks;
+          /// the number of the next task to claim
+          std::size_t next = 0;
+          /// the number of claimed tasks which are finished
+          std::size_t finished = 0;
+          /// whether the remaining tasks are skipped
+          bool skip = false;
+          /// the first exception thrown by a task
+          std::exception_ptr ex;
+      };
+
+      /// type-erased `RunEach`
+      bool RunEach(std::size_t const num_tasks, bool (*call)(void const*, std::size_t), void const* task) noexcept(false);
+
+      /// run a claimed task, then record that it is finished; `lock` must hold `m_queue_mutex`, and is released while the task runs
+      void RunTask(job_t& job, std::size_t const i, std::unique_lock<std::mutex>& lock);
+
+      /// the worker thread loop
+      void Work();
+
+      std::vector<std::thread> m_workers;
+      /// jobs which have unclaimed tasks
+      std::deque<job_t*> m_jobs;
+      std::mutex m_queue_mutex;
+      std::condition_variable m_queue_cv;
+      std::condition_variable m_done_cv;
+      bool m_stopping = false;
+  };
+}
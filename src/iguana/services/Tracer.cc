@@ -0,0 +1,149 @@
+#include "Tracer.h"
+
+#include <fmt/format.h>
+#include <fstream>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace iguana {
+
+  std::atomic<bool> Tracer::s_enabled{false};
+  std::atomic<unsigned long> Tracer::s_generation{0};
+  std::atomic<unsigned int> Tracer::s_sample_period{1};
+  std::atomic<unsigned long long> Tracer::s_num_events{0};
+  std::atomic<Tracer::clock_t::rep> Tracer::s_start{0};
+  std::string Tracer::s_file_name{};
+  std::mutex Tracer::s_mutex{};
+  std::deque<Tracer::thread_buffer_t> Tracer::s_buffers{};
+
+  namespace {
+    /// each thread's event state: how many event spans it is in, and whether the current event is sampled
+    struct event_state_t
+    {
+        unsigned int depth = 0;
+        bool sampled       = false;
+    };
+    thread_local event_state_t t_event_state;
+
+    /// @returns the operating system's ID of the calling thread
+    unsigned long long GetOSThreadID()
+    {
+#ifdef __APPLE__
+      uint64_t tid = 0;
+      pthread_threadid_np(nullptr, &tid);
+      return tid;
+#else
+      return static_cast<unsigned long long>(syscall(SYS_gettid));
+#endif
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Tracer::Span::Begin(SpanKind const kind)
+  {
+    if(kind == SpanKind::event) {
+      if(t_event_state.depth == 0) {
+        auto const sample_period = s_sample_period.load(std::memory_order_relaxed);
+        t_event_state.sampled    = sample_period <= 1 || s_num_events.fetch_add(1, std::memory_order_relaxed) % sample_period == 0;
+      }
+      t_event_state.depth++;
+      m_entered_event = true;
+    }
+    if(t_event_state.depth == 0 || t_event_state.sampled) {
+      m_recording  = true;
+      m_generation = s_generation.load(std::memory_order_acquire);
+      m_start      = clock_t::now();
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Tracer::Span::End()
+  {
+    if(m_entered_event)
+      t_event_state.depth--;
+    if(!m_recording)
+      return;
+    auto const end = clock_t::now();
+    // skip this span if tracing was disabled, or re-enabled, since it began
+    if(!s_enabled.load(std::memory_order_relaxed) || s_generation.load(std::memory_order_acquire) != m_generation)
+      return;
+    auto const start = clock_t::time_point(clock_t::duration(s_start.load(std::memory_order_relaxed)));
+    auto& buffer     = GetThreadBuffer();
+    buffer.records.push_back({fmt::format("{}::{}", m_name, m_phase),
+        m_phase,
+        std::chrono::duration<double, std::micro>(m_start - start).count(),
+        std::chrono::duration<double, std::micro>(end - m_start).count()});
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Tracer::Enable(std::string const& file_name, unsigned int const sample_period)
+  {
+    std::lock_guard<std::mutex> const lock(s_mutex);
+    s_buffers.clear();
+    s_file_name = file_name;
+    s_sample_period.store(sample_period, std::memory_order_relaxed);
+    s_num_events.store(0, std::memory_order_relaxed);
+    s_start.store(clock_t::now().time_since_epoch().count(), std::memory_order_relaxed);
+    s_generation.fetch_add(1, std::memory_order_release);
+    s_enabled.store(true, std::memory_order_relaxed);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Tracer::Disable()
+  {
+    std::lock_guard<std::mutex> const lock(s_mutex);
+    if(!s_enabled.exchange(false))
+      return;
+    s_generation.fetch_add(1, std::memory_order_release);
+    std::ofstream out(s_file_name);
+    if(!out.is_open())
+      throw std::runtime_error(fmt::format("cannot open trace output file {:?}", s_file_name));
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    // the process and thread IDs are those of the operating system
+    auto const pid = static_cast<long>(getpid());
+    out << fmt::format("  {{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": {}, \"args\": {{\"name\": \"iguana\"}}}}", pid);
+    for(auto const& buffer : s_buffers) {
+      out << fmt::format(",\n  {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": {}, \"tid\": {}, \"args\": {{\"name\": \"thread {}\"}}}}", pid, buffer.os_tid, buffer.os_tid);
+      for(auto const& record : buffer.records)
+        out << fmt::format(",\n  {{\"name\": {:?}, \"cat\": {:?}, \"ph\": \"X\", \"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": {}, \"tid\": {}}}",
+            record.name,
+            record.phase,
+            record.ts_us,
+            record.dur_us,
+            pid,
+            buffer.os_tid);
+    }
+    out << "\n]}\n";
+    s_buffers.clear();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool Tracer::IsEnabled()
+  {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  Tracer::thread_buffer_t& Tracer::GetThreadBuffer()
+  {
+    // each thread caches its buffer, until tracing is disabled or re-enabled
+    thread_local unsigned long buffer_generation = 0;
+    thread_local thread_buffer_t* buffer         = nullptr;
+    auto const generation                        = s_generation.load(std::memory_order_acquire);
+    if(buffer == nullptr || buffer_generation != generation) {
+      std::lock_guard<std::mutex> const lock(s_mutex);
+      buffer            = &s_buffers.emplace_back();
+      buffer->os_tid    = GetOSThreadID();
+      buffer_generation = generation;
+    }
+    return *buffer;
+  }
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace iguana {
+
+  /// @brief Records timed spans, such as algorithm `Run` calls, and writes them as a trace-event JSON file
+  ///
+  /// The output file may be loaded directly in a trace viewer, such as [Perfetto](https://ui.perfetto.dev) or
+  /// `chrome://tracing`, to see what each thread was doing; this is useful for diagnosing lock contention and
+  /// slow events. Tracing is global, and is off by default; while it is off, a span costs one atomic load.
+  ///
+  /// Spans are created with `Tracer::Span`. Those of kind `Tracer::SpanKind::event`, such as `Algorithm::Run` and
+  /// `Algorithm::RunBatch`, correspond to events: the outermost such span on a thread decides whether the event
+  /// is sampled, and the spans within an event which is not sampled are not recorded. Spans outside of any event,
+  /// such as `Algorithm::Start` phases, are always recorded.
+  ///
+  /// **Example**
+  /// @code
+  /// iguana::Tracer::Enable("trace.json", 100); // trace one in every 100 events
+  /// // ... start algorithms and process events ...
+  /// iguana::Tracer::Disable(); // writes the file
+  /// @endcode
+  class Tracer
+  {
+
+    public:
+
+      /// clock used for timing
+      using clock_t = std::chrono::steady_clock;
+
+      /// kinds of spans
+      enum class SpanKind {
+        /// a span which is recorded unless it is within an event which is not sampled
+        plain,
+        /// a span which corresponds to an event (or a batch of events); if it is the outermost one on its thread,
+        /// it decides whether the event is sampled
+        event
+      };
+
+      /// @brief A timed span, which is recorded when it goes out of scope, if tracing is enabled
+      class Span
+      {
+        public:
+
+          /// @param name the name of the object, _e.g._, the algorithm instance name; the referenced string must outlive the span
+          /// @param phase what the object is doing, _e.g._, `"Run"`
+          /// @param kind the kind of span
+          Span(std::string_view name, char const* phase, SpanKind const kind = SpanKind::plain)
+              : m_name(name)
+              , m_phase(phase)
+          {
+            if(s_enabled.load(std::memory_order_relaxed))
+              Begin(kind);
+          }
+
+          ~Span()
+          {
+            if(m_entered_event || m_recording)
+              End();
+          }
+
+          Span(Span const&)            = delete;
+          Span& operator=(Span const&) = delete;
+
+        private:
+
+          void Begin(SpanKind const kind);
+          void End();
+
+          std::string_view m_name;
+          char const* m_phase;
+          bool m_entered_event = false;
+          bool m_recording     = false;
+          unsigned long m_generation = 0;
+          clock_t::time_point m_start;
+      };
+
+      Tracer() = delete;
+
+      /// Enable tracing, and discard any spans which were recorded previously
+      /// @param file_name the output file name, which is written by `Tracer::Disable`
+      /// @param sample_period record one in every `sample_period` events; if 0 or 1, record all of them
+      static void Enable(std::string const& file_name, unsigned int const sample_period = 1);
+
+      /// Disable tracing, and write the output file; this must not be called while any algorithm is running
+      static void Disable() noexcept(false);
+
+      /// @returns true if tracing is enabled
+      static bool IsEnabled();
+
+    private:
+
+      /// a recorded span
+      struct record_t
+      {
+          std::string name;
+          char const* phase;
+          double ts_us;
+          double dur_us;
+      };
+
+      /// one thread's recorded spans; aligned to a cache line, so that threads do not share one
+      struct alignas(64) thread_buffer_t
+      {
+          /// the operating system's ID of the thread, as `gettid` returns, so that the trace may be matched with other tools' output
+          unsigned long long os_tid;
+          std::vector<record_t> records;
+      };
+
+      /// @returns the calling thread's buffer, creating it if needed
+      static thread_buffer_t& GetThreadBuffer();
+
+      static std::atomic<bool> s_enabled;
+      static std::atomic<unsigned long> s_generation;
+      static std::atomic<unsigned int> s_sample_period;
+      static std::atomic<unsigned long long> s_num_events;
+      static std::atomic<clock_t::rep> s_start;
+      static std::string s_file_name;
+      static std::mutex s_mutex;
+      static std::deque<thread_buffer_t> s_buffers;
+  };
+}
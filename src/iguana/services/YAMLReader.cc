@@ -4,7 +4,14 @@ namespace iguana {
 
   void YAMLReader::LoadFiles()
   {
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    if(!m_loaded_files.empty() && m_loaded_files == m_files) {
+      m_log->Debug("YAMLReader::LoadFiles(): files are already loaded");
+      return;
+    }
     m_log->Debug("YAMLReader::LoadFiles():");
+    m_configs.clear();
+    m_loaded_files = m_files;
     for(auto const& file : m_files) {
       try {
         m_log->Debug(" - load: {}", file);
@@ -61,6 +68,7 @@ namespace iguana {
   template <typename SCALAR>
   std::optional<SCALAR> YAMLReader::GetScalar(node_path_t node_path)
   {
+    std::lock_guard<std::mutex> const lock(m_mutex);
     for(auto const& [config, filename] : m_configs) {
       auto node = FindNode(config, node_path);
       if(node.IsDefined() && !node.IsNull())
@@ -102,6 +110,7 @@ namespace iguana {
   template <typename SCALAR>
   std::optional<std::vector<SCALAR>> YAMLReader::GetVector(node_path_t node_path)
   {
+    std::lock_guard<std::mutex> const lock(m_mutex);
     for(auto const& [config, filename] : m_configs) {
       auto node = FindNode(config, node_path);
       if(node.IsDefined() && !node.IsNull())
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <optional>
 #include <variant>
 #include <vector>
@@ -33,7 +34,8 @@ namespace iguana {
       {}
       ~YAMLReader() {}
 
-      /// Parse the YAML files added by `ConfigFileReader::AddFile`
+      /// Parse the YAML files added by `ConfigFileReader::AddFile`; if they have already been parsed, this does nothing, so
+      /// that a reader may be shared by several algorithm instances (see `Algorithm::Clone`)
       void LoadFiles();
 
       /// @brief Convert a `YAML::Node` path to a string
@@ -86,5 +88,11 @@ namespace iguana {
 
       /// Stack of `YAML::Node`s used to open files, together with their file names
       std::deque<std::pair<YAML::Node, std::string>> m_configs;
+
+      /// The list of files which were parsed by the most recent `LoadFiles` call
+      std::deque<std::string> m_loaded_files;
+
+      /// Mutex for reading the nodes; `yaml-cpp` node lookup is not thread safe, and a reader may be shared among threads
+      std::mutex m_mutex;
   };
 }
@@ -1,10 +1,28 @@
 #include <getopt.h>
 
 #include "TestAlgorithm.h"
+#include "TestBankColumn.h"
+#include "TestBankIndex.h"
 #include "TestBanklist.h"
+#include "TestBatch.h"
+#ifdef IGUANA_ROOT_FOUND
+#include "TestCatboost.h"
+#endif
 #include "TestConfig.h"
+#include "TestFusion.h"
+#ifdef IGUANA_ROOT_FOUND
+#include "TestLeafPrecision.h"
+#endif
+#include "TestLinker.h"
 #include "TestLogger.h"
 #include "TestMultithreading.h"
+#include "TestProfiler.h"
+#ifdef IGUANA_ROOT_FOUND
+#include "TestProximity.h"
+#endif
+#include "TestScheduler.h"
+#include "TestScratchArena.h"
+#include "TestTracer.h"
 #include "TestValidator.h"
 #include <iguana/services/Tools.h>
 
@@ -20,6 +38,7 @@ int main(int argc, char** argv)
   std::string concurrency_model = "";
   bool vary_run                 = false;
   std::string output_dir        = "";
+  std::string model_dir         = "";
   int verbosity                 = 0;
   std::vector<std::string> bank_names;
   std::vector<std::string> prerequisite_algos;
@@ -31,11 +50,23 @@ int main(int argc, char** argv)
     fmt::print("\n  COMMANDS:\n\n");
     fmt::print("    {:<20} {}\n", "algorithm", "call `Run` on an algorithm");
     fmt::print("    {:<20} {}\n", "multithreading", "call `Run` on an algorithm, multithreaded");
+    fmt::print("    {:<20} {}\n", "batch", "test that RunBatch on an algorithm gives the same results as Run");
     fmt::print("    {:<20} {}\n", "validator", "run an algorithm's validator");
     fmt::print("    {:<20} {}\n", "unit", "call `Test` on an algorithm, for unit tests");
     fmt::print("    {:<20} {}\n", "config", "test config file parsing");
     fmt::print("    {:<20} {}\n", "logger", "test Logger");
+    fmt::print("    {:<20} {}\n", "profiler", "test Profiler");
+    fmt::print("    {:<20} {}\n", "tracer", "test Tracer");
     fmt::print("    {:<20} {}\n", "banklist", "test hipo::banklist");
+    fmt::print("    {:<20} {}\n", "bankcolumn", "test BankColumn and FillBankRows");
+    fmt::print("    {:<20} {}\n", "bankindex", "test PindexIndex, RowListMask and BankIndexCache");
+    fmt::print("    {:<20} {}\n", "scratcharena", "test ScratchArena");
+    fmt::print("    {:<20} {}\n", "catboost", "test PhotonGBTFilter model kernels against the converted models' reference scores");
+    fmt::print("    {:<20} {}\n", "scheduler", "test concurrent scheduling of an algorithm sequence");
+    fmt::print("    {:<20} {}\n", "fusion", "test fusion of an algorithm sequence's filters");
+    fmt::print("    {:<20} {}\n", "linker", "test linking of detector banks to the particle bank");
+    fmt::print("    {:<20} {}\n", "proximity", "test MatchParticleProximity's binned search against comparing every pair");
+    fmt::print("    {:<20} {}\n", "leafprecision", "test that PhotonGBTFilter's reduced leaf precisions keep its decisions");
     fmt::print("\n  OPTIONS:\n\n");
     fmt::print("    Each command has its own set of OPTIONS; either provide no OPTIONS\n");
     fmt::print("    or use the --help option for more usage information about a specific command\n");
@@ -114,6 +145,10 @@ int main(int argc, char** argv)
            fmt::print("    {:<20} {}\n", "-o OUTPUT_DIR", fmt::format("if specified, {} output will write to this directory;", command));
            fmt::print("    {:<20} if not specified, output will not be written\n", "");
          }},
+        {"d", [&]()
+         {
+           fmt::print("    {:<20} {}\n", "-d MODEL_DIR", "directory of the converted models and their reference scores");
+         }},
         {"v", [&]()
          {
            fmt::print("    {:<20} {}\n", "-v", "increase verbosity by one level;");
@@ -123,10 +158,22 @@ int main(int argc, char** argv)
       {"algorithm",      {"f", "n", "a-algo", "b", "p"}},
       {"unit",           {"f", "n", "a-algo", "b", "p"}},
       {"multithreading", {"f", "n", "a-algo", "b", "p", "j", "m", "V"}},
+      {"batch",          {"f", "n", "a-algo", "b", "p", "V"}},
       {"validator",      {"f", "n", "a-vdor", "b", "o"}},
       {"config",         {"t"}},
       {"logger",         {}},
-      {"banklist",       {"f"}}
+      {"profiler",       {}},
+      {"tracer",         {}},
+      {"banklist",       {"f"}},
+      {"bankcolumn",     {}},
+      {"bankindex",      {}},
+      {"scratcharena",   {}},
+      {"catboost",       {"d"}},
+      {"scheduler",      {"f", "n", "j"}},
+      {"fusion",         {"f", "n"}},
+      {"linker",         {"f", "n"}},
+      {"proximity",      {}},
+      {"leafprecision",  {"f", "n"}}
     };
     for(auto& it : available_options)
       it.second.push_back("v");
@@ -149,12 +196,12 @@ int main(int argc, char** argv)
   auto first_option = argc >= 2 ? std::string(argv[1]) : "";
   if(first_option == "--help" || first_option == "-h")
     return UsageOptions(0);
-  if(argc <= 2 && command != "logger")
+  if(argc <= 2 && command != "logger" && command != "profiler" && command != "tracer" && command != "proximity" && command != "bankcolumn" && command != "bankindex" && command != "scratcharena")
     return UsageOptions(2);
 
   // parse option arguments
   int opt;
-  while((opt = getopt(argc, argv, "hf:n:a:b:p:t:j:m:Vo:v|")) != -1) {
+  while((opt = getopt(argc, argv, "hf:n:a:b:p:t:j:m:Vo:d:v|")) != -1) {
     switch(opt) {
     case 'h':
       return UsageOptions(0);
@@ -190,6 +237,9 @@ int main(int argc, char** argv)
     case 'o':
       output_dir = std::string(optarg);
       break;
+    case 'd':
+      model_dir = std::string(optarg);
+      break;
     case 'v':
       verbosity++;
       break;
@@ -222,11 +272,13 @@ int main(int argc, char** argv)
   fmt::print("  {:>20} = {}\n", "concurrency_model", concurrency_model);
   fmt::print("  {:>20} = {}\n", "vary_run", vary_run);
   fmt::print("  {:>20} = {}\n", "output_dir", output_dir);
+  fmt::print("  {:>20} = {}\n", "model_dir", model_dir);
   fmt::print("\n");
 
   // expand `~` in paths
   data_file  = iguana::tools::ExpandTilde(data_file);
   output_dir = iguana::tools::ExpandTilde(output_dir);
+  model_dir  = iguana::tools::ExpandTilde(model_dir);
 
   // set log level
   std::string log_level;
@@ -251,14 +303,56 @@ int main(int argc, char** argv)
     return TestAlgorithm(command, algo_name, prerequisite_algos, bank_names, data_file, num_events, log_level);
   if(command == "multithreading")
     return TestMultithreading(command, algo_name, prerequisite_algos, bank_names, data_file, num_events, num_threads, concurrency_model, vary_run, log_level);
+  else if(command == "batch")
+    return TestBatch(algo_name, prerequisite_algos, bank_names, data_file, num_events, vary_run, log_level);
   else if(command == "validator")
     return TestValidator(algo_name, bank_names, data_file, num_events, output_dir, log_level);
   else if(command == "config")
     return TestConfig(test_num, log_level);
   else if(command == "logger")
     return TestLogger();
+  else if(command == "profiler")
+    return TestProfiler();
+  else if(command == "tracer")
+    return TestTracer();
   else if(command == "banklist")
     return TestBanklist(data_file);
+  else if(command == "bankcolumn")
+    return TestBankColumn();
+  else if(command == "bankindex")
+    return TestBankIndex();
+  else if(command == "scratcharena")
+    return TestScratchArena();
+  else if(command == "scheduler")
+    return TestScheduler(data_file, num_events, num_threads, log_level);
+  else if(command == "fusion")
+    return TestFusion(data_file, num_events, log_level);
+  else if(command == "linker")
+    return TestLinker(data_file, num_events, log_level);
+  else if(command == "catboost") {
+#ifdef IGUANA_ROOT_FOUND
+    return TestCatboost(model_dir);
+#else
+    fmt::print(stderr, "ERROR: command 'catboost' needs ROOT, since PhotonGBTFilter does\n");
+    return 1;
+#endif
+  }
+  else if(command == "leafprecision") {
+#ifdef IGUANA_ROOT_FOUND
+    return TestLeafPrecision(data_file, num_events, log_level);
+#else
+    fmt::print(stderr, "ERROR: command 'leafprecision' needs ROOT, since PhotonGBTFilter does\n");
+    return 1;
+#endif
+  }
+  else if(command == "proximity") {
+#ifdef IGUANA_ROOT_FOUND
+    return TestProximity(log_level);
+#else
+    fmt::print(stderr, "ERROR: command 'proximity' needs ROOT, since MatchParticleProximity does\n");
+    return 1;
+#endif
+  }
   else {
     fmt::print(stderr, "ERROR: unknown command '{}'\n", command);
     return 1;
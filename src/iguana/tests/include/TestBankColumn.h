@@ -0,0 +1,108 @@
+// test BankColumn handles and FillBankRows
+
+#include <iguana/algorithms/BankColumn.h>
+#include <iguana/services/Logger.h>
+
+inline int TestBankColumn()
+{
+
+  iguana::Logger log("test");
+
+  // a bank with one column of each type
+  hipo::schema schema("test::Bank", 0, 0);
+  schema.parse("b/B,s/S,i/I,l/L,f/F,d/D");
+  int const num_rows = 10;
+  hipo::bank bank(schema, num_rows);
+  iguana::BankColumn<int8_t> const c_b("b");
+  iguana::BankColumn<int16_t> const c_s("s");
+  iguana::BankColumn<int32_t> const c_i("i");
+  iguana::BankColumn<int64_t> const c_l("l");
+  iguana::BankColumn<float> const c_f("f");
+  iguana::BankColumn<double> const c_d("d");
+
+  // handles resolve once, and reject missing columns
+  auto resolve = [&](auto const&... columns) {
+    (columns.Resolve(bank), ...);
+    return (columns.IsResolved() && ...);
+  };
+  if(!resolve(c_b, c_s, c_i, c_l, c_f, c_d) || !resolve(c_b, c_s, c_i, c_l, c_f, c_d)) {
+    log.Error("the columns are not resolved");
+    return 1;
+  }
+  try {
+    iguana::BankColumn<float>("missing").Resolve(bank);
+    log.Error("a missing column was resolved");
+    return 1;
+  }
+  catch(std::runtime_error const&) {
+  }
+  try {
+    iguana::BankColumn<int32_t>("s").Resolve(bank);
+    log.Error("a column was resolved by a handle of another type");
+    return 1;
+  }
+  catch(std::runtime_error const&) {
+  }
+
+  // each row's values depend on the row
+  auto value = [](int const row) { return row + 1.5; };
+  for(int row = 0; row < num_rows; row++) {
+    c_b.Put(bank, row, static_cast<int8_t>(value(row)));
+    c_s.Put(bank, row, static_cast<int16_t>(value(row)));
+    c_i.Put(bank, row, static_cast<int32_t>(value(row)));
+    c_l.Put(bank, row, static_cast<int64_t>(value(row)));
+    c_f.Put(bank, row, static_cast<float>(value(row)));
+    c_d.Put(bank, row, value(row));
+  }
+
+  // fill a range of rows of all but the last column, converting the value to each column's type
+  int const first_row = 3;
+  int const last_row  = 7;
+  double const fill   = -2.5;
+  std::vector<std::pair<int, int>> columns;
+  for(int item = 0; item < schema.getEntries() - 1; item++)
+    columns.push_back({item, schema.getEntryType(item)});
+  iguana::FillBankRows(bank, columns, first_row, last_row, fill);
+
+  for(int row = 0; row < num_rows; row++) {
+    auto const filled   = row >= first_row && row < last_row;
+    auto const expected = filled ? fill : value(row);
+    if(c_b.Get(bank, row) != static_cast<int8_t>(expected) ||
+       c_s.Get(bank, row) != static_cast<int16_t>(expected) ||
+       c_i.Get(bank, row) != static_cast<int32_t>(expected) ||
+       c_l.Get(bank, row) != static_cast<int64_t>(expected) ||
+       c_f.Get(bank, row) != static_cast<float>(expected)) {
+      log.Error("row {} does not have the {} value {}", row, filled ? "filled" : "original", expected);
+      return 1;
+    }
+    if(c_d.Get(bank, row) != value(row)) {
+      log.Error("row {} of the column which is not filled changed", row);
+      return 1;
+    }
+  }
+
+  // zero the first rows of all but the last column, which fills each column's rows at once
+  iguana::FillBankRows(bank, columns, 0, first_row);
+  for(int row = 0; row < num_rows; row++) {
+    auto const expected = row < first_row ? 0.0 : row < last_row ? fill : value(row);
+    if(c_b.Get(bank, row) != static_cast<int8_t>(expected) ||
+       c_s.Get(bank, row) != static_cast<int16_t>(expected) ||
+       c_i.Get(bank, row) != static_cast<int32_t>(expected) ||
+       c_l.Get(bank, row) != static_cast<int64_t>(expected) ||
+       c_f.Get(bank, row) != static_cast<float>(expected) ||
+       c_d.Get(bank, row) != value(row)) {
+      log.Error("row {} does not have the value {} after zeroing the first {} rows", row, expected, first_row);
+      return 1;
+    }
+  }
+
+  // gather the values of a list of rows
+  std::vector<float> values;
+  c_f.Gather(bank, {9, 0, 5}, values);
+  if(values != std::vector<float>{static_cast<float>(value(9)), 0.0f, static_cast<float>(fill)}) {
+    log.Error("gathered the wrong values");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+// test PindexIndex, RowListMask and BankIndexCache
+
+#include <numeric>
+
+#include <iguana/algorithms/BankIndex.h>
+#include <iguana/services/Logger.h>
+
+inline int TestBankIndex()
+{
+
+  iguana::Logger log("test");
+
+  // a detector bank, in which some particles have several rows, in several detectors and layers, and one row has no particle
+  hipo::schema schema("test::Detector", 0, 0);
+  schema.parse("pindex/S,detector/B,layer/B");
+  std::vector<int> const pindices  = {2, 0, 2, -1, 1, 2, 0};
+  std::vector<int> const detectors = {6, 7, 6, 6, 7, 7, 6};
+  std::vector<int> const layers    = {4, 1, 1, 1, 1, 1, 1};
+  int const num_rows               = static_cast<int>(pindices.size());
+  hipo::bank bank(schema, num_rows);
+  for(int row = 0; row < num_rows; row++) {
+    bank.putShort(schema.getEntryOrder("pindex"), row, static_cast<int16_t>(pindices[row]));
+    bank.putByte(schema.getEntryOrder("detector"), row, static_cast<int8_t>(detectors[row]));
+    bank.putByte(schema.getEntryOrder("layer"), row, static_cast<int8_t>(layers[row]));
+  }
+  hipo::bank::rowlist::list_t all_rows(num_rows);
+  std::iota(all_rows.begin(), all_rows.end(), 0);
+  bank.getMutableRowList().setList(all_rows);
+
+  // check a range of rows
+  auto check_rows = [&log](std::string_view what, iguana::RowRange const& range, std::vector<int> const& expected) {
+    if(!std::equal(range.begin(), range.end(), expected.begin(), expected.end())) {
+      log.Error("{}: rows are [{}], rather than [{}]", what, fmt::join(range, ", "), fmt::join(expected, ", "));
+      return false;
+    }
+    return true;
+  };
+
+  // a particle's rows are in ascending order; with a detector, they are ordered by layer, then by row
+  iguana::PindexIndex index;
+  index.Build(bank);
+  if(!check_rows("pindex 2", index.GetRows(2), {0, 2, 5}) ||
+     !check_rows("pindex 2, detector 6", index.GetRows(2, 6), {2, 0}) ||
+     !check_rows("pindex 2, detector 7", index.GetRows(2, 7), {5}) ||
+     !check_rows("pindex 2, detector 6, layer 4", index.GetRows(2, 6, 4), {0}) ||
+     !check_rows("pindex 0", index.GetRows(0), {1, 6}) ||
+     !check_rows("pindex 0, detector 5", index.GetRows(0, 5), {}) ||
+     !check_rows("pindex -1", index.GetRows(-1), {}) ||
+     !check_rows("pindex 3", index.GetRows(3), {}))
+    return 1;
+
+  // only the rows in the row list are indexed and in the mask
+  bank.getMutableRowList().setList({1, 2, 3, 5});
+  index.Build(bank);
+  if(index.GetNumRows() != 4 ||
+     !check_rows("filtered, pindex 2", index.GetRows(2), {2, 5}) ||
+     !check_rows("filtered, pindex 0", index.GetRows(0), {1}) ||
+     !check_rows("filtered, pindex 1", index.GetRows(1), {}))
+    return 1;
+  iguana::RowListMask mask;
+  mask.Build(bank);
+  for(int row = -1; row <= num_rows; row++) {
+    bool const expected = row == 1 || row == 2 || row == 3 || row == 5;
+    if(mask.Contains(row) != expected) {
+      log.Error("filtered mask: row {} is {}in the mask", row, expected ? "not " : "");
+      return 1;
+    }
+  }
+
+  // the cache shares the indices of a bank, and rebuilds them if its row list changes, even if its size does not
+  {
+    iguana::BankIndexCache::Scope const scope;
+    auto cache = iguana::BankIndexCache::GetActive();
+    if(cache == nullptr) {
+      log.Error("the scope did not make a cache active");
+      return 1;
+    }
+    auto const& cached_index = cache->GetPindexIndex(bank);
+    auto const& cached_mask  = cache->GetRowListMask(bank);
+    if(&cache->GetPindexIndex(bank) != &cached_index || &cache->GetRowListMask(bank) != &cached_mask) {
+      log.Error("the cache did not share the indices of a bank");
+      return 1;
+    }
+    bank.getMutableRowList().setList({1, 2, 4, 6});
+    if(!check_rows("changed row list, pindex 2", cache->GetPindexIndex(bank).GetRows(2), {2}) ||
+       !check_rows("changed row list, pindex 0", cache->GetPindexIndex(bank).GetRows(0), {1, 6}) ||
+       !cache->GetRowListMask(bank).Contains(6) || cache->GetRowListMask(bank).Contains(5)) {
+      log.Error("the cache did not rebuild the indices of a bank whose row list changed");
+      return 1;
+    }
+
+    // another bank has its own entry; an inner scope shares the cache
+    hipo::bank other_bank(schema, 0);
+    cache->GetRowListMask(other_bank);
+    {
+      iguana::BankIndexCache::Scope const inner_scope;
+      if(iguana::BankIndexCache::GetActive() != cache || cache->GetNumEntries() != 2) {
+        log.Error("an inner scope did not share the cache, which has {} entries", cache->GetNumEntries());
+        return 1;
+      }
+    }
+    if(cache->GetNumEntries() != 2) {
+      log.Error("an inner scope evicted the cache's entries");
+      return 1;
+    }
+  }
+
+  // the outermost scope evicted the entries, so the next one starts empty, and it reuses their storage
+  {
+    iguana::BankIndexCache::Scope const scope;
+    auto cache = iguana::BankIndexCache::GetActive();
+    if(cache->GetNumEntries() != 0) {
+      log.Error("the cache has {} entries from a previous scope", cache->GetNumEntries());
+      return 1;
+    }
+    bank.getMutableRowList().setList(all_rows);
+    if(!check_rows("new scope, pindex 2", cache->GetPindexIndex(bank).GetRows(2), {0, 2, 5}))
+      return 1;
+  }
+  if(iguana::BankIndexCache::GetActive() != nullptr) {
+    log.Error("a cache is active after its scope ended");
+    return 1;
+  }
+
+  // invalidating a cache evicts its entries
+  iguana::BankIndexCache cache;
+  cache.GetPindexIndex(bank);
+  cache.Invalidate();
+  if(cache.GetNumEntries() != 0) {
+    log.Error("the cache has {} entries after it was invalidated", cache.GetNumEntries());
+    return 1;
+  }
+  if(!check_rows("invalidated, pindex 0", cache.GetPindexIndex(bank).GetRows(0), {1, 6}))
+    return 1;
+
+  log.Info("PindexIndex, RowListMask and BankIndexCache passed");
+  return 0;
+}
@@ -0,0 +1,128 @@
+// test that running an algorithm on batches of events, with `Algorithm::RunBatch`, gives the same results as running it on
+// one event at a time, with `Algorithm::Run`: the same accept flags, and the same banks
+
+#include <hipo4/reader.h>
+#include <iguana/algorithms/AlgorithmSequence.h>
+
+#include "TestScheduler.h"
+
+inline int TestBatch(
+    std::string const algo_name,
+    std::vector<std::string> const prerequisite_algos,
+    std::vector<std::string> const bank_names,
+    std::string const data_file,
+    int const num_events,
+    bool const vary_run,
+    std::string const log_level)
+{
+
+  iguana::Logger log("test");
+  log.SetLevel(log_level);
+
+  // check arguments
+  if(algo_name.empty() || bank_names.empty()) {
+    log.Error("need algorithm name and banks");
+    return 1;
+  }
+  if(data_file.empty()) {
+    log.Error("need a data file for command 'batch'");
+    return 1;
+  }
+
+  // if varying the run number, the run number of each event is taken from this list, changing every few events, irregularly,
+  // so that it changes both within a batch and between batches; the runs have different configurations and models
+  std::optional<hipo::banklist::size_type> run_config_bank_idx;
+  if(vary_run) {
+    for(hipo::banklist::size_type idx = 0; idx < bank_names.size(); idx++) {
+      if(bank_names.at(idx) == "RUN::config") {
+        run_config_bank_idx = idx;
+        break;
+      }
+    }
+  }
+  std::vector<int> const runs = {5032, 5423, 16042, 6616, 11093};
+  auto set_run                = [&run_config_bank_idx, &runs](hipo::banklist& banks, int const event_num) {
+    if(run_config_bank_idx.has_value())
+      banks[run_config_bank_idx.value()].putInt("run", 0, runs[(event_num / 3 + event_num / 7) % runs.size()]);
+  };
+
+  // make and start the prerequisite algorithms and the algorithm, which may add created banks to `banks`
+  auto make_algos = [&](hipo::banklist& banks) {
+    std::vector<std::unique_ptr<iguana::Algorithm>> algos;
+    for(auto const& prerequisite_algo : prerequisite_algos)
+      algos.push_back(iguana::AlgorithmFactory::Create(prerequisite_algo));
+    algos.push_back(iguana::AlgorithmFactory::Create(algo_name));
+    for(auto& algo : algos) {
+      algo->SetLogLevel(log_level);
+      algo->Start(banks);
+    }
+    return algos;
+  };
+
+  // batch sizes: one event per batch, batches which do not divide the frames evenly, and batches as large as `EventProcessor`'s frames
+  for(int const batch_size : {1, 7, 64}) {
+
+    // two readers of the same file, so the events are read twice: once for batches, and once for single events
+    hipo::reader reader_batch(data_file.c_str());
+    hipo::reader reader_single(data_file.c_str());
+    auto banks_batch  = reader_batch.getBanks(bank_names);
+    auto banks_single = reader_single.getBanks(bank_names);
+    auto algos_batch  = make_algos(banks_batch);
+    auto algos_single = make_algos(banks_single);
+
+    std::vector<hipo::banklist> batch;
+    std::vector<bool> accepted;
+    int event_num = 0;
+    bool more     = true;
+    while(more && (num_events == 0 || event_num < num_events)) {
+
+      // read a batch; as in `EventProcessor`, each event's bank list is a copy of the template bank list, which was never read
+      batch.clear();
+      while(static_cast<int>(batch.size()) < batch_size && (num_events == 0 || event_num + static_cast<int>(batch.size()) < num_events)) {
+        batch.push_back(banks_batch);
+        if(!reader_batch.next(batch.back())) {
+          batch.pop_back();
+          more = false;
+          break;
+        }
+        set_run(batch.back(), event_num + static_cast<int>(batch.size()) - 1);
+      }
+      accepted.assign(batch.size(), true);
+      for(auto const& algo : algos_batch)
+        algo->RunBatch(batch, accepted);
+
+      // run the same events one at a time, and compare; the created banks are only compared for accepted events, since
+      // an algorithm which is not run for a rejected event leaves its created bank as it was
+      for(decltype(batch.size()) i = 0; i < batch.size(); i++, event_num++) {
+        reader_single.next(banks_single);
+        set_run(banks_single, event_num);
+        bool accepted_single = true;
+        for(auto const& algo : algos_single) {
+          if(!algo->Run(banks_single)) {
+            accepted_single = false;
+            break;
+          }
+        }
+        if(accepted[i] != accepted_single) {
+          log.Error("batch size {}, event {}: RunBatch {} the event, but Run {} it", batch_size, event_num,
+              accepted[i] ? "accepted" : "rejected", accepted_single ? "accepted" : "rejected");
+          return 1;
+        }
+        auto const num_compared_banks = accepted_single ? banks_single.size() : bank_names.size();
+        for(decltype(banks_single.size()) b = 0; b < num_compared_banks; b++) {
+          if(!TestSchedulerBanksEqual(batch[i][b], banks_single[b])) {
+            log.Error("batch size {}, event {}: bank {:?} differs between RunBatch and Run", batch_size, event_num, banks_single[b].getSchema().getName());
+            return 1;
+          }
+        }
+      }
+    }
+
+    for(auto const& algo : algos_batch)
+      algo->Stop();
+    for(auto const& algo : algos_single)
+      algo->Stop();
+    log.Info("batch size {}: compared {} events", batch_size, event_num);
+  }
+  return 0;
+}
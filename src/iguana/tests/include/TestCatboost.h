@@ -0,0 +1,140 @@
+// test the `PhotonGBTFilter` model kernels against the converted model files, and the reference scores which the converter
+// computed for them, as the CatBoost C++ model export computes them; see `convert_catboost_model.py`
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <iguana/algorithms/clas12/PhotonGBTFilter/CatboostModel.h>
+
+// read a reference file, which the converter writes along with the model file
+inline bool ReadCatboostReference(std::string const& file_name, unsigned int const num_features, std::vector<float>& features, std::vector<double>& scores)
+{
+  std::ifstream file(file_name, std::ios::binary);
+  if(!file) {
+    fmt::print(stderr, "ERROR: cannot open reference file {:?}\n", file_name);
+    return false;
+  }
+  uint32_t header[2] = {0, 0};
+  file.read(reinterpret_cast<char*>(header), sizeof(header));
+  if(!file || header[0] == 0 || header[1] != num_features) {
+    fmt::print(stderr, "ERROR: reference file {:?} has {} samples of {} features, but the model has {} features\n", file_name, header[0], header[1], num_features);
+    return false;
+  }
+  features.resize(std::size_t{header[0]} * header[1]);
+  scores.resize(header[0]);
+  file.read(reinterpret_cast<char*>(features.data()), features.size() * sizeof(float));
+  file.read(reinterpret_cast<char*>(scores.data()), scores.size() * sizeof(double));
+  if(!file) {
+    fmt::print(stderr, "ERROR: reference file {:?} is truncated\n", file_name);
+    return false;
+  }
+  return true;
+}
+
+// compare the scores of each available kernel with the reference scores, which must be bit-for-bit identical; the scores of
+// quantized models must be within their error bounds, so those which keep the leaf values' precision must also be identical;
+// with early exits, each sample's score must either be identical, or be infinite, on the same side of the bounds as its score
+inline int TestCatboostModel(std::string const& model_dir, std::string const& model_name)
+{
+  using CatboostModel = iguana::clas12::CatboostModel;
+
+  auto const file_model   = CatboostModel::Load(model_dir + "/" + model_name + ".bin");
+  auto const num_features = file_model.GetFeatureCount();
+  // the converter's samples are not a multiple of the block sizes, so that the last block is partial
+  std::vector<float> features;
+  std::vector<double> expected_scores;
+  if(!ReadCatboostReference(model_dir + "/" + model_name + ".ref", num_features, features, expected_scores))
+    return 1;
+  auto const num_samples = expected_scores.size();
+
+  std::vector<std::pair<std::string, CatboostModel>> const catboost_models = {
+      {"file", file_model},
+      {"float64", file_model.Quantize(CatboostModel::LeafPrecision::float64)},
+      {"float32", file_model.Quantize(CatboostModel::LeafPrecision::float32)},
+      {"fixed16", file_model.Quantize(CatboostModel::LeafPrecision::fixed16)}};
+  // bounds around the median score, so that many samples are near them
+  auto sorted_scores = expected_scores;
+  std::sort(sorted_scores.begin(), sorted_scores.end());
+  auto const median_score = sorted_scores[num_samples / 2];
+  std::vector<std::pair<double, double>> const bounds_list = {{median_score, median_score}, {median_score - 1, median_score + 1}};
+
+  for(auto const& [source, catboost_model] : catboost_models) {
+    // allow for rounding in the sums of the leaf values, which is far smaller than the quantization error
+    auto const tolerance = catboost_model.GetScoreErrorBound() * (1 + 1e-6);
+    for(auto kernel : {CatboostModel::Kernel::scalar, CatboostModel::Kernel::avx2, CatboostModel::Kernel::avx512}) {
+      auto const kernel_name = CatboostModel::GetKernelName(kernel);
+      if(!CatboostModel::IsKernelAvailable(kernel)) {
+        fmt::print("  {:<24} {:<8} {:<8} not available on this CPU; skipped\n", model_name, source, kernel_name);
+        continue;
+      }
+      // evaluate all samples at once, and in uneven chunks, the smallest of which are walked for one sample after another
+      double max_error = 0;
+      for(std::size_t chunk_size : {num_samples, std::size_t{7}, std::size_t{2}}) {
+        std::vector<double> scores(num_samples);
+        for(std::size_t first = 0; first < num_samples; first += chunk_size)
+          catboost_model.Evaluate(features.data() + first * num_features, std::min(chunk_size, num_samples - first), scores.data() + first, kernel);
+        for(std::size_t s = 0; s < num_samples; s++) {
+          auto const error = std::abs(scores[s] - expected_scores[s]);
+          if(tolerance == 0 ? std::memcmp(&scores[s], &expected_scores[s], sizeof(double)) != 0 : !(error <= tolerance)) {
+            fmt::print(stderr, "ERROR: model {:?} from {}, kernel {:?}, chunk size {}: sample {} has score {} (expected {}, tolerance {})\n",
+                model_name, source, kernel_name, chunk_size, s, scores[s], expected_scores[s], tolerance);
+            return 1;
+          }
+          max_error = std::max(max_error, error);
+        }
+      }
+      // evaluate with early exits, all samples at once, and in chunks which are walked for one sample after another
+      std::vector<double> scores(num_samples);
+      catboost_model.Evaluate(features.data(), num_samples, scores.data(), kernel);
+      std::size_t num_exits = 0;
+      for(auto const& [lower, upper] : bounds_list) {
+        std::vector<double> bounded_scores(num_samples);
+        catboost_model.EvaluateBounded(features.data(), num_samples, lower, upper, bounded_scores.data(), kernel);
+        std::vector<double> chunk_scores(num_samples);
+        for(std::size_t first = 0; first < num_samples; first += 2)
+          catboost_model.EvaluateBounded(features.data() + first * num_features, std::min(std::size_t{2}, num_samples - first), lower, upper, chunk_scores.data() + first, kernel);
+        for(std::size_t s = 0; s < num_samples; s++) {
+          if(std::memcmp(&bounded_scores[s], &chunk_scores[s], sizeof(double)) != 0) {
+            fmt::print(stderr, "ERROR: model {:?} from {}, kernel {:?}, bounds [{}, {}]: sample {} has bounded score {} in a chunk (all at once {})\n",
+                model_name, source, kernel_name, lower, upper, s, chunk_scores[s], bounded_scores[s]);
+            return 1;
+          }
+          auto const infinity = std::numeric_limits<double>::infinity();
+          bool const ok       = (bounded_scores[s] == -infinity && scores[s] < lower) ||
+                          (bounded_scores[s] == infinity && scores[s] > upper) ||
+                          std::memcmp(&bounded_scores[s], &scores[s], sizeof(double)) == 0;
+          if(!ok) {
+            fmt::print(stderr, "ERROR: model {:?} from {}, kernel {:?}, bounds [{}, {}]: sample {} has bounded score {} (score {})\n",
+                model_name, source, kernel_name, lower, upper, s, bounded_scores[s], scores[s]);
+            return 1;
+          }
+          num_exits += std::isinf(bounded_scores[s]) ? 1 : 0;
+        }
+      }
+      fmt::print("  {:<24} {:<8} {:<8} early exits for {} of {} samples\n", model_name, source, kernel_name, num_exits, num_samples * bounds_list.size());
+
+      if(tolerance == 0)
+        fmt::print("  {:<24} {:<8} {:<8} matches the reference scores\n", model_name, source, kernel_name);
+      else
+        fmt::print("  {:<24} {:<8} {:<8} is within {:.3g} of the reference scores (bound {:.3g})\n", model_name, source, kernel_name, max_error, tolerance);
+    }
+  }
+  return 0;
+}
+
+inline int TestCatboost(std::string const& model_dir)
+{
+  if(model_dir.empty()) {
+    fmt::print(stderr, "ERROR: need the directory of the converted models, with option '-d'\n");
+    return 1;
+  }
+  fmt::print("best kernel: {}\n", iguana::clas12::CatboostModel::GetKernelName(iguana::clas12::CatboostModel::GetBestKernel()));
+  int result = 0;
+  for(auto const& model_name : {"RGA_inbending_pass1", "RGA_inbending_pass2", "RGA_outbending_pass1", "RGA_outbending_pass2", "RGC_Summer2022_pass1"})
+    result |= TestCatboostModel(model_dir, model_name);
+  return result;
+}
@@ -0,0 +1,157 @@
+// test the fusion of adjacent filter algorithms in an algorithm sequence
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <hipo4/reader.h>
+#include <iguana/algorithms/AlgorithmSequence.h>
+#include <new>
+#include <sstream>
+#include <unistd.h>
+
+// count the heap allocations of the calling thread while `t_count_allocations` is set, to check that a fused stage makes none;
+// the replaced `operator new` is also used by `operator new[]` and the `nothrow` variants
+namespace {
+  thread_local bool t_count_allocations      = false;
+  thread_local unsigned long t_num_allocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+  if(t_count_allocations)
+    t_num_allocations++;
+  if(auto ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr)
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+inline int TestFusion(std::string const data_file, int const num_events, std::string const log_level)
+{
+
+  iguana::Logger log("test");
+  log.SetLevel(log_level);
+
+  if(data_file.empty()) {
+    log.Error("need a data file for command 'fusion'");
+    return 1;
+  }
+
+  // these filters all filter `REC::Particle`, so a sequence of them is fused, unless it is profiled
+  std::vector<std::string> const algo_names = {"clas12::EventBuilderFilter", "clas12::ZVertexFilter", "clas12::rga::FiducialFilterPass2"};
+  std::vector<std::string> const bank_names = {"REC::Particle", "RUN::config"};
+  auto make_sequence                        = [&algo_names](std::string const& name) {
+    auto seq = std::make_unique<iguana::AlgorithmSequence>(name);
+    for(auto const& algo_name : algo_names)
+      seq->Add(algo_name);
+    return seq;
+  };
+  auto seq_fused    = make_sequence("fused");
+  auto seq_profiled = make_sequence("profiled");
+  seq_profiled->EnableProfiling();
+
+  // the reference: the same algorithms, run one at a time
+  std::vector<std::unique_ptr<iguana::Algorithm>> algos;
+  for(auto const& algo_name : algo_names)
+    algos.push_back(iguana::AlgorithmFactory::Create(algo_name));
+
+  hipo::reader reader_fused(data_file.c_str());
+  hipo::reader reader_profiled(data_file.c_str());
+  hipo::reader reader_single(data_file.c_str());
+  auto banks_fused    = reader_fused.getBanks(bank_names);
+  auto banks_profiled = reader_profiled.getBanks(bank_names);
+  auto banks_single   = reader_single.getBanks(bank_names);
+  seq_fused->Start(banks_fused);
+  seq_profiled->Start(banks_profiled);
+  for(auto& algo : algos)
+    algo->Start(banks_single);
+
+  // trace the fused sequence, to check that each fused algorithm has its own spans
+  auto const trace_file = (std::filesystem::temp_directory_path() / fmt::format("iguana_test_fusion_{}.json", getpid())).string();
+  iguana::Tracer::Enable(trace_file);
+
+  // compare the decisions and the filtered rows
+  int num_compared = 0;
+  while(reader_fused.next(banks_fused) && reader_profiled.next(banks_profiled) && reader_single.next(banks_single)) {
+    if(num_events > 0 && num_compared >= num_events)
+      break;
+    bool accepted = true;
+    for(auto const& algo : algos)
+      accepted = accepted && algo->Run(banks_single);
+    auto const accepted_fused    = seq_fused->Run(banks_fused);
+    auto const accepted_profiled = seq_profiled->Run(banks_profiled);
+    if(accepted_fused != accepted || accepted_profiled != accepted) {
+      log.Error("event {}: the decisions differ: fused={} profiled={} one at a time={}", num_compared, accepted_fused, accepted_profiled, accepted);
+      return 1;
+    }
+    auto const& rows = banks_single[0].getRowList();
+    if(banks_fused[0].getRowList() != rows || banks_profiled[0].getRowList() != rows) {
+      log.Error("event {}: the filtered rows differ", num_compared);
+      return 1;
+    }
+    num_compared++;
+  }
+  iguana::Tracer::Disable();
+  log.Info("compared {} events", num_compared);
+
+  // each fused algorithm has spans for making and applying its kernel
+  std::ifstream in(trace_file);
+  std::stringstream trace_stream;
+  trace_stream << in.rdbuf();
+  auto const trace = trace_stream.str();
+  in.close();
+  std::filesystem::remove(trace_file);
+  for(auto const& algo_name : algo_names) {
+    for(auto const& phase : {"MakeRowKernel", "RowKernel"}) {
+      auto const span_name = fmt::format("\"name\": \"fused|{}::{}\"", algo_name, phase);
+      if(num_compared > 0 && trace.find(span_name) == std::string::npos) {
+        log.Error("trace has no span {}", span_name);
+        return 1;
+      }
+    }
+  }
+
+  // the profiled sequence is not fused, so each of its algorithms has its own profile
+  auto const summaries = seq_profiled->GetProfileSummaries();
+  if(summaries.size() != algo_names.size() + 1) {
+    log.Error("the profiled sequence has {} profiles, rather than {}", summaries.size(), algo_names.size() + 1);
+    return 1;
+  }
+  if(summaries.front().calls != static_cast<unsigned long long>(num_compared)) {
+    log.Error("the first algorithm was profiled for {} events, rather than {}", summaries.front().calls, num_compared);
+    return 1;
+  }
+
+  // once the fused stage's scratch memory and reused buffers have grown to the size that the events need, it makes no heap
+  // allocations: run the same events again, and count them
+  hipo::reader reader_again(data_file.c_str());
+  auto banks_again = reader_again.getBanks(bank_names);
+  unsigned long num_allocations = 0;
+  for(int i = 0; i < num_compared && reader_again.next(banks_again); i++) {
+    banks_again[0].getRowList(); // the row list is set up by the reader, not by the stage
+    t_num_allocations   = 0;
+    t_count_allocations = true;
+    seq_fused->Run(banks_again);
+    t_count_allocations = false;
+    num_allocations += t_num_allocations;
+  }
+  if(num_allocations > 0) {
+    log.Error("the fused sequence made {} heap allocations for {} events which it had already run", num_allocations, num_compared);
+    return 1;
+  }
+
+  seq_fused->Stop();
+  seq_profiled->Stop();
+  for(auto& algo : algos)
+    algo->Stop();
+  return 0;
+}
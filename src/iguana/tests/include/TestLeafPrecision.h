@@ -0,0 +1,125 @@
+// test that the decisions of `clas12::PhotonGBTFilter` with reduced leaf precision match those with the models' exact leaf values
+
+#include <algorithm>
+#include <hipo4/reader.h>
+#include <iguana/algorithms/AlgorithmSequence.h>
+#include <iguana/algorithms/clas12/PhotonGBTFilter/CatboostModel.h>
+#include <iguana/services/ConfigFileReader.h>
+#include <iterator>
+#include <optional>
+
+inline int TestLeafPrecision(std::string const data_file, int const num_events, std::string const log_level)
+{
+
+  iguana::Logger log("test");
+  log.SetLevel(log_level);
+
+  if(data_file.empty()) {
+    log.Error("need a data file for command 'leafprecision'");
+    return 1;
+  }
+
+  using CatboostModel = iguana::clas12::CatboostModel;
+
+  std::string const algo_name = "clas12::PhotonGBTFilter";
+
+  std::vector<std::pair<std::string, CatboostModel::LeafPrecision>> const precisions = {
+      {"float32", CatboostModel::LeafPrecision::float32},
+      {"fixed16", CatboostModel::LeafPrecision::fixed16}};
+
+  auto make_algo = [&algo_name, &log_level](std::string const& leaf_precision, std::optional<double> const threshold = std::nullopt) {
+    auto algo = iguana::AlgorithmFactory::Create(algo_name);
+    algo->SetLogLevel(log_level);
+    algo->SetOption("leaf_precision", leaf_precision);
+    if(threshold)
+      algo->SetOption("threshold", threshold.value());
+    return algo;
+  };
+
+  hipo::reader reader(data_file.c_str());
+  auto banks = reader.getBanks({"REC::Particle", "REC::Calorimeter", "RUN::config"});
+
+  // the default configuration
+  auto algo_default = iguana::AlgorithmFactory::Create(algo_name);
+  algo_default->SetLogLevel(log_level);
+  algo_default->Start(banks);
+  auto const threshold    = algo_default->GetOptionScalar<double>({"threshold"});
+  auto const leaf_default = algo_default->GetOptionScalar<std::string>({"leaf_precision"});
+  algo_default->Stop();
+
+  // the reference: the models' exact leaf values
+  auto algo_exact = make_algo("float64");
+  algo_exact->Start(banks);
+
+  // each reduced precision changes a photon's prediction by less than a quarter of its models' largest score error bound, since the
+  // prediction is the sigmoid of the score; so a photon whose decision changes must have an exact prediction within that of the
+  // threshold, and the photons kept with reduced precision must be between those kept with the exact models with shifted thresholds
+  iguana::ConfigFileReader config_file_reader;
+  struct precision_t
+  {
+      std::string name;
+      std::unique_ptr<iguana::Algorithm> algo;
+      std::unique_ptr<iguana::Algorithm> algo_above;
+      std::unique_ptr<iguana::Algorithm> algo_below;
+      int num_changed;
+  };
+  std::vector<precision_t> precision_algos;
+  for(auto const& [name, leaf_precision] : precisions) {
+    double error_bound = 0;
+    for(auto const& model_name : {"RGA_inbending_pass1", "RGA_inbending_pass2", "RGA_outbending_pass1", "RGA_outbending_pass2", "RGC_Summer2022_pass1"}) {
+      auto const model = CatboostModel::Load(config_file_reader.FindFile(fmt::format("algorithms/clas12/PhotonGBTFilter/models/{}.bin", model_name)));
+      error_bound      = std::max(error_bound, model.Quantize(leaf_precision).GetScoreErrorBound());
+    }
+    // allow for rounding in the sums of the leaf values and in the predictions
+    auto const shift = error_bound / 4 * (1 + 1e-6) + 1e-12;
+    log.Info("{} leaf values change the predictions by at most {:.3g}", name, shift);
+    precision_algos.push_back({name, make_algo(name), make_algo("float64", threshold + shift), make_algo("float64", threshold - shift), 0});
+    for(auto* algo : {precision_algos.back().algo.get(), precision_algos.back().algo_above.get(), precision_algos.back().algo_below.get()})
+      algo->Start(banks);
+  }
+
+  int num_compared = 0;
+  while(reader.next(banks)) {
+    if(num_events > 0 && num_compared >= num_events)
+      break;
+    auto run_algo = [&banks](iguana::Algorithm const& algo) {
+      auto algo_banks = banks;
+      algo.Run(algo_banks);
+      return algo_banks.at(0).getRowList();
+    };
+    auto const rows_exact = run_algo(*algo_exact);
+    for(auto& precision : precision_algos) {
+      auto const rows       = run_algo(*precision.algo);
+      auto const rows_above = run_algo(*precision.algo_above);
+      auto const rows_below = run_algo(*precision.algo_below);
+      auto const is_subset  = [](auto const& a, auto const& b) { return std::includes(b.begin(), b.end(), a.begin(), a.end()); };
+      if(!is_subset(rows_above, rows) || !is_subset(rows, rows_below)) {
+        log.Error("event {}: {} leaf values changed a decision by more than their error bound", num_compared, precision.name);
+        return 1;
+      }
+      std::vector<int> changed;
+      std::set_symmetric_difference(rows.begin(), rows.end(), rows_exact.begin(), rows_exact.end(), std::back_inserter(changed));
+      precision.num_changed += static_cast<int>(changed.size());
+    }
+    num_compared++;
+  }
+  log.Info("compared {} events", num_compared);
+
+  // a reduced default precision must not change any decision
+  int result = 0;
+  for(auto const& precision : precision_algos) {
+    log.Info("{} leaf values changed the decisions of {} particles", precision.name, precision.num_changed);
+    if(precision.name == leaf_default && precision.num_changed > 0) {
+      log.Error("the default leaf precision, {}, changed the decisions of {} particles", precision.name, precision.num_changed);
+      result = 1;
+    }
+  }
+
+  algo_exact->Stop();
+  for(auto& precision : precision_algos) {
+    precision.algo->Stop();
+    precision.algo_above->Stop();
+    precision.algo_below->Stop();
+  }
+  return result;
+}
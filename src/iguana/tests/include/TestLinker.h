@@ -0,0 +1,118 @@
+// test the detector-bank linking of `clas12::DetectorLinker`, through its subclasses, against a loop over each particle
+
+#include <hipo4/reader.h>
+#include <iguana/algorithms/AlgorithmSequence.h>
+
+/// @returns the value of a bank item, as a `double`
+inline double TestLinkerGetValue(hipo::bank& bank, int const item, int const row)
+{
+  switch(bank.getSchema().getEntryType(item)) {
+  case hipo::kFloat: return bank.getFloat(item, row);
+  case hipo::kDouble: return bank.getDouble(item, row);
+  case hipo::kLong: return static_cast<double>(bank.getLong(item, row));
+  default: return bank.getInt(item, row);
+  }
+}
+
+inline int TestLinker(std::string const data_file, int const num_events, std::string const log_level)
+{
+
+  iguana::Logger log("test");
+  log.SetLevel(log_level);
+
+  if(data_file.empty()) {
+    log.Error("need a data file for command 'linker'");
+    return 1;
+  }
+
+  // each linker is a configuration of the same engine
+  std::vector<std::string> const algo_names = {"clas12::CalorimeterLinker", "clas12::TrajLinker"};
+  std::vector<std::unique_ptr<iguana::Algorithm>> algos;
+  for(auto const& algo_name : algo_names) {
+    algos.push_back(iguana::AlgorithmFactory::Create(algo_name));
+    algos.back()->SetLogLevel(log_level);
+  }
+
+  hipo::reader reader(data_file.c_str());
+  auto banks = reader.getBanks({"REC::Particle", "REC::Calorimeter", "REC::Traj"});
+  for(auto& algo : algos)
+    algo->Start(banks);
+
+  // the reference: for each particle and layer, the last row of the detector bank which matches them
+  struct link_t
+  {
+      std::string name;
+      hipo::banklist::size_type b_source;
+      hipo::banklist::size_type b_result;
+      int detector;
+      std::vector<int> layers;
+      std::vector<std::string> prefixes;
+      std::vector<std::string> columns;
+  };
+  std::vector<link_t> links;
+  for(auto& algo : algos) {
+    auto const source = algo->GetOptionScalar<std::string>({"source"});
+    links.push_back({
+        algo->GetName(),
+        iguana::tools::GetBankIndex(banks, source),
+        algo->GetCreatedBankIndex(banks),
+        algo->GetOptionScalar<int>({"detector"}),
+        algo->GetOptionVector<int>({"layers"}),
+        algo->GetOptionVector<std::string>({"prefixes"}),
+        algo->GetOptionVector<std::string>({"columns"}),
+    });
+  }
+
+  int num_compared = 0;
+  int num_found    = 0;
+  while(reader.next(banks)) {
+    if(num_events > 0 && num_compared >= num_events)
+      break;
+    for(auto& algo : algos)
+      algo->Run(banks);
+    auto& bank_particle = banks.at(0);
+    for(auto const& link : links) {
+      auto& bank_source         = banks.at(link.b_source);
+      auto& bank_result         = banks.at(link.b_result);
+      auto const& schema_source = bank_source.getSchema();
+      auto const& schema_result = bank_result.getSchema();
+      if(bank_result.getRows() != bank_particle.getRows() || bank_result.getRowList() != bank_particle.getRowList()) {
+        log.Error("event {}: {} created a bank whose rows differ from those of REC::Particle", num_compared, link.name);
+        return 1;
+      }
+      for(auto const& row_particle : bank_particle.getRowList()) {
+        for(decltype(link.layers.size()) l = 0; l < link.layers.size(); l++) {
+          int row_linked = -1;
+          for(auto const& row_source : bank_source.getRowList()) {
+            if(bank_source.getInt("pindex", row_source) == row_particle &&
+               bank_source.getInt("layer", row_source) == link.layers[l] &&
+               (link.detector < 0 || bank_source.getInt("detector", row_source) == link.detector))
+              row_linked = row_source;
+          }
+          auto const found = bank_result.getByte((link.prefixes[l] + "_found").c_str(), row_particle);
+          if(found != (row_linked >= 0 ? 1 : 0)) {
+            log.Error("event {}: {} has {}_found={} for particle {}", num_compared, link.name, link.prefixes[l], found, row_particle);
+            return 1;
+          }
+          if(row_linked < 0)
+            continue;
+          num_found++;
+          for(auto const& column : link.columns) {
+            auto const expected = TestLinkerGetValue(bank_source, schema_source.getEntryOrder(column.c_str()), row_linked);
+            auto const linked   = TestLinkerGetValue(bank_result, schema_result.getEntryOrder((link.prefixes[l] + "_" + column).c_str()), row_particle);
+            if(linked != expected) {
+              log.Error("event {}: {} linked {}_{}={} for particle {}, rather than {}", num_compared, link.name, link.prefixes[l], column, linked, row_particle, expected);
+              return 1;
+            }
+          }
+        }
+      }
+    }
+    num_compared++;
+  }
+  log.Info("compared {} events, with {} linked layers", num_compared, num_found);
+
+  for(auto& algo : algos)
+    algo->Stop();
+  return 0;
+}
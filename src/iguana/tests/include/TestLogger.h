@@ -4,7 +4,7 @@
 
 inline int TestLogger()
 {
-  // this test just runs the `Logger` methods to catch any runtime errors
+  // first, run the `Logger` methods to catch any runtime errors
   std::vector<iguana::Logger> logs;
   logs.push_back({"styled_logger", iguana::Logger::Level::trace});
   logs.push_back({"unstyled_logger", iguana::Logger::Level::trace});
@@ -41,5 +41,45 @@ inline int TestLogger()
     }
   }
 
+  // check `IsEnabled`, which also applies the compile-time cutoff `Logger::MIN_LEVEL`
+  using Level = iguana::Logger::Level;
+  iguana::Logger log("lazy_logger", Level::info);
+  for(auto const lev : {Level::trace, Level::debug, Level::info, Level::warn, Level::error}) {
+    auto const expected = lev >= Level::info && lev >= iguana::Logger::MIN_LEVEL;
+    if(log.IsEnabled(lev) != expected) {
+      log.Error("IsEnabled({}) is {}, but the level is 'info' and the minimum level is {}", static_cast<int>(lev), !expected, static_cast<int>(iguana::Logger::MIN_LEVEL));
+      return 1;
+    }
+  }
+  log.SetLevel(Level::trace);
+  if(log.IsEnabled(Level::trace) != (Level::trace >= iguana::Logger::MIN_LEVEL)) {
+    log.Error("IsEnabled(trace) does not follow the minimum level {}", static_cast<int>(iguana::Logger::MIN_LEVEL));
+    return 1;
+  }
+
+  // a callable value is only called if its message is printed, and then only once
+  int num_calls = 0;
+  auto counter  = [&num_calls]() { return ++num_calls; };
+  log.SetLevel(Level::info);
+  log.Trace("this is not printed: {}", counter);
+  log.Debug("this is not printed: {}", counter);
+  if(num_calls != 0) {
+    log.Error("a callable value of a disabled log message was called {} times", num_calls);
+    return 1;
+  }
+  log.Info("this callable value is called once: {}", counter);
+  auto const expected_calls = log.IsEnabled(Level::info) ? 1 : 0;
+  if(num_calls != expected_calls) {
+    log.Error("a callable value of an enabled log message was called {} times, rather than {}", num_calls, expected_calls);
+    return 1;
+  }
+  log.SetLevel("silent");
+  log.Error("this is not printed: {}", counter);
+  log.SetLevel(Level::info);
+  if(num_calls != expected_calls) {
+    log.Error("a callable value of a silenced log message was called");
+    return 1;
+  }
+
   return 0;
 }
@@ -1,7 +1,9 @@
 // multithreaded test of an iguana algorithm
 
+#include <algorithm>
 #include <hipo4/reader.h>
-#include <iguana/algorithms/AlgorithmSequence.h>
+#include <iguana/algorithms/EventProcessor.h>
+#include <optional>
 
 inline int TestMultithreading(
     std::string const command,
@@ -44,115 +46,88 @@ inline int TestMultithreading(
     }
   }
 
-  // number of events per thread
-  int const default_frame_size = 50;
-  int num_events_per_thread    = (int)std::round((double)num_events / num_threads);
-  int num_events_per_frame     = num_events > 0 ? std::min(num_events_per_thread, default_frame_size) : default_frame_size;
-  int num_frames_per_thread    = num_events > 0 ? (int)std::ceil((double)num_events_per_thread / num_events_per_frame) : 0;
-  int num_events_actual        = num_events_per_frame * num_frames_per_thread * num_threads;
-  log.Info("num_events_per_thread = {}", num_events_per_thread);
-  log.Info("num_events_per_frame  = {}", num_events_per_frame);
-  log.Info("num_frames_per_thread = {}", num_frames_per_thread);
-  if(num_events > 0) {
-    log.Info("=> will actually process num_events = {}", num_events_actual);
-    if(num_events != num_events_actual)
-      log.Warn("argument's num_events ({}) differs from the actual num_events that will be processed ({})",
-               num_events, num_events_actual);
-  }
-  else {
-    log.Info("=> will actually process num_events = ALL OF THEM");
-  }
-
   // start the stream
   hipo::readerstream stream;
   stream.open(data_file.c_str());
 
-  // define the worker function
-  auto ftn = [&stream,
-              algo_name,
-              prerequisite_algos,
-              bank_names,
-              vary_run,
-              log_level,
-              num_events_per_thread,
-              num_events_per_frame,
-              run_config_bank_idx](int order) {
-    // fill a frame
-    std::vector<hipo::event> events;
-    for(int i = 0; i < num_events_per_frame; i++)
-      events.push_back(hipo::event());
-
-    // bank list
-    hipo::banklist banks;
-    for(auto const& bank_name : bank_names)
-      banks.push_back(hipo::bank(stream.dictionary().getSchema(bank_name.c_str()), 48));
-
-    // define the algorithm
-    iguana::AlgorithmSequence seq;
+  // define the event processor
+  iguana::EventProcessor proc("TEST");
+  proc.SetSequence([algo_name, prerequisite_algos, log_level](iguana::AlgorithmSequence& seq) {
     for(auto const& prerequisite_algo : prerequisite_algos)
       seq.Add(prerequisite_algo);
     seq.Add(algo_name);
-    seq.SetName("TEST thread " + std::to_string(order));
     seq.PrintSequence();
     seq.SetLogLevel(algo_name, log_level);
-
-    // start the algorithm
-    seq.Start(banks);
-
-    // loop over frames
-    int nProcessed = 0;
-    while(nProcessed < num_events_per_thread || num_events_per_thread == 0) {
-      stream.pull(events);
-
-      // loop over events in this frame
-      int nNonEmpty = 0;
-      for(auto& event : events) {
-        if(event.getSize() > 16) {
-          nNonEmpty++;
-          nProcessed++;
-
-          // read the banks
-          for(auto& bank : banks)
-            event.read(bank);
-
-          // occasionally vary the run number; so far, algorithms with data-dependent configuration
-          // parameters have dependence on run number, so this variation aims to improve thread
-          // sanitizer test coverage
-          if(vary_run && run_config_bank_idx.has_value()) {
-            // === rapid variation ===
-            /*
-            banks[run_config_bank_idx.value()].putInt("run", 0, std::rand() % 20000);
-            */
-            // === slower variation ===
-            ///*
-            if(std::rand() % 10 == 0) { // randomly increase or decrease the run number
-              auto runnum = banks[run_config_bank_idx.value()].getInt("run", 0);
-              runnum += (std::rand() % 2 == 0) ? 1000 : -1000;
-              runnum = std::max(runnum, 0); // prevent negative run number
-              banks[run_config_bank_idx.value()].putInt("run", 0, runnum);
-            }
-            else if(std::rand() % 10 == 1) {
-              banks[run_config_bank_idx.value()].putInt("run", 0, 1); // set the runnum to '1'
-            }
-            //*/
-          }
-
-          // run the iguana algorithm
-          seq.Run(banks);
-        }
+  });
+  // read 'RUN::config' too, if it is not one of the banks, so that the delivered events may be identified by event number
+  auto proc_bank_names = bank_names;
+  if(std::find(proc_bank_names.begin(), proc_bank_names.end(), "RUN::config") == proc_bank_names.end())
+    proc_bank_names.push_back("RUN::config");
+  auto const run_config_proc_idx = static_cast<hipo::banklist::size_type>(
+      std::find(proc_bank_names.begin(), proc_bank_names.end(), "RUN::config") - proc_bank_names.begin());
+  proc.SetBanks(proc_bank_names);
+  proc.SetNumThreads(num_threads);
+  // use small frames, so that the threads finish frames out of order, which the reorder buffer must undo
+  proc.SetFrameSize(2);
+  proc.SetMaxEvents(std::max(num_events, 0));
+  if(num_events > 0)
+    log.Info("=> will process num_events = {}", num_events);
+  else
+    log.Info("=> will process num_events = ALL OF THEM");
+
+  // occasionally vary the run number; so far, algorithms with data-dependent configuration
+  // parameters have dependence on run number, so this variation aims to improve thread
+  // sanitizer test coverage
+  if(vary_run && run_config_bank_idx.has_value()) {
+    proc.SetEventPreparer([run_config_bank_idx](hipo::banklist& banks) {
+      // === rapid variation ===
+      /*
+      banks[run_config_bank_idx.value()].putInt("run", 0, std::rand() % 20000);
+      */
+      // === slower variation ===
+      ///*
+      if(std::rand() % 10 == 0) { // randomly increase or decrease the run number
+        auto runnum = banks[run_config_bank_idx.value()].getInt("run", 0);
+        runnum += (std::rand() % 2 == 0) ? 1000 : -1000;
+        runnum = std::max(runnum, 0); // prevent negative run number
+        banks[run_config_bank_idx.value()].putInt("run", 0, runnum);
       }
-      if(nNonEmpty == 0)
-        break;
-    }
-
-    // stop the algorithm
-    seq.Stop();
+      else if(std::rand() % 10 == 1) {
+        banks[run_config_bank_idx.value()].putInt("run", 0, 1); // set the runnum to '1'
+      }
+      //*/
+    });
+  }
 
-    seq.GetLog()->Info("nProcessed = {}", nProcessed);
-    return nProcessed;
-  };
+  // record the event number of each event handed back by the reorder buffer; the banks of rejected events may not have been
+  // read, in which case the event number is unknown
+  std::vector<std::optional<int>> delivered_events;
+  proc.SetEventCallback([&delivered_events, run_config_proc_idx](hipo::banklist const& banks, bool) {
+    auto const& config_bank = banks.at(run_config_proc_idx);
+    delivered_events.push_back(config_bank.getRows() > 0 ? std::optional<int>{config_bank.getInt("event", 0)} : std::nullopt);
+  });
 
   // run
-  stream.run(ftn, num_threads);
+  auto num_processed = proc.Process(stream);
+  if(delivered_events.size() != num_processed) {
+    log.Error("processed {} events, but {} were delivered", num_processed, delivered_events.size());
+    return 1;
+  }
+
+  // the events must be delivered in input order
+  if(num_threads == 1)
+    log.Warn("with one thread, the events are processed in order, so the reorder buffer is not tested");
+  hipo::reader reader(data_file.c_str());
+  hipo::banklist input_banks = reader.getBanks({"RUN::config"});
+  for(decltype(delivered_events.size()) i = 0; i < delivered_events.size(); i++) {
+    if(!reader.next(input_banks)) {
+      log.Error("delivered {} events, but the input has only {}", delivered_events.size(), i);
+      return 1;
+    }
+    if(delivered_events[i].has_value() && input_banks.at(0).getRows() > 0 && delivered_events[i].value() != input_banks.at(0).getInt("event", 0)) {
+      log.Error("event {} was delivered out of order: it has event number {}, but the input event has {}", i, delivered_events[i].value(), input_banks.at(0).getInt("event", 0));
+      return 1;
+    }
+  }
   return 0;
 }
@@ -0,0 +1,85 @@
+// test Profiler
+
+#include <iguana/services/Profiler.h>
+#include <thread>
+
+inline int TestProfiler()
+{
+
+  iguana::Logger log("test");
+  using Counters = iguana::Profiler::Counters;
+
+  // a latency's bin center is within the histogram's resolution of it
+  for(unsigned long long ns = 1; ns < (1ULL << 40); ns = ns * 3 / 2 + 1) {
+    auto const center = Counters::BinCenter(Counters::Bin(ns));
+    if(std::abs(center - ns) > 0.035 * ns + 0.5) {
+      log.Error("latency {} ns is in a bin centered at {} ns", ns, center);
+      return 1;
+    }
+  }
+
+  // events timed individually by `Run`: latencies of 1, 2, ..., 100 us
+  auto const within_resolution = [](double const value, double const expected) { return std::abs(value - expected) <= 0.035 * expected; };
+  {
+    iguana::Profiler profiler("run");
+    auto& counters = profiler.GetThreadCounters();
+    for(unsigned long long us = 1; us <= 100; us++)
+      counters.Record(us * 1000, us % 2 == 0, 3, 2);
+    auto const summary = profiler.Summarize();
+    if(summary.calls != 100 || summary.timed_calls != 100 || summary.batches != 0 || summary.passed != 50 || summary.rows_in != 300 || summary.rows_out != 200) {
+      log.Error("wrong counts for events run individually");
+      return 1;
+    }
+    if(!within_resolution(summary.p50_us, 50) || !within_resolution(summary.p99_us, 99) || summary.max_us != 100 || summary.total_ms != 5.05) {
+      log.Error("wrong latencies for events run individually: p50={} p99={} max={} total={}", summary.p50_us, summary.p99_us, summary.max_us, summary.total_ms);
+      return 1;
+    }
+  }
+
+  // batches: their latencies are per batch, and do not enter the per-event distribution
+  {
+    iguana::Profiler profiler("batch");
+    auto& counters = profiler.GetThreadCounters();
+    counters.Record(2000, true, 0, 0);
+    for(unsigned long long batch = 1; batch <= 4; batch++)
+      counters.RecordBatch(batch * 1000000, 10, 5, 0, 0);
+    auto const summary = profiler.Summarize();
+    if(summary.calls != 41 || summary.timed_calls != 1 || summary.batches != 4 || summary.passed != 21) {
+      log.Error("wrong counts for batches");
+      return 1;
+    }
+    if(!within_resolution(summary.p50_us, 2) || summary.max_us != 2 || !within_resolution(summary.batch_p50_us, 2000) || summary.batch_max_us != 4000) {
+      log.Error("wrong latencies for batches: p50={} max={} batch_p50={} batch_max={}", summary.p50_us, summary.max_us, summary.batch_p50_us, summary.batch_max_us);
+      return 1;
+    }
+  }
+
+  // each thread has its own counters, which are merged
+  {
+    iguana::Profiler profiler("threads");
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; t++)
+      threads.emplace_back([&profiler]() {
+        for(int i = 0; i < 1000; i++)
+          profiler.GetThreadCounters().Record(1000, true, 1, 1);
+      });
+    for(auto& thread : threads)
+      thread.join();
+    if(auto const summary = profiler.Summarize(); summary.calls != 4000 || summary.rows_in != 4000) {
+      log.Error("merged {} calls from 4 threads, rather than 4000", summary.calls);
+      return 1;
+    }
+  }
+
+  // a new profiler, even if allocated where a destroyed one was, starts with new counters
+  for(int i = 0; i < 100; i++) {
+    auto profiler = std::make_unique<iguana::Profiler>("replaced");
+    profiler->GetThreadCounters().Record(1000, true, 0, 0);
+    if(auto const summary = profiler->Summarize(); summary.calls != 1) {
+      log.Error("new profiler {} has {} calls, rather than 1", i, summary.calls);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+// test the binned search of `clas12::MatchParticleProximity` against a comparison of every pair of particles
+
+#include <iguana/algorithms/clas12/MatchParticleProximity/Algorithm.h>
+#include <iguana/algorithms/physics/Tools.h>
+#include <random>
+
+inline int TestProximity(std::string const log_level)
+{
+
+  iguana::Logger log("test");
+  log.SetLevel(log_level);
+
+  hipo::schema particle_schema("MC::Particle", 0, 0);
+  particle_schema.parse("pid/I,px/F,py/F,pz/F");
+  std::mt19937 rng(7);
+  std::vector<int> const pids = {11, 22, 211};
+  auto random_int             = [&rng](int const n) { return static_cast<int>(rng() % n); };
+  auto random_double          = [&rng](double const min, double const max) { return std::uniform_real_distribution<double>(min, max)(rng); };
+
+  // fill a particle's momentum; some are at the edges of the (theta,phi) bins, where phi wraps around and at the poles
+  auto fill_particle = [&](hipo::bank& bank, int const row) {
+    double theta = random_double(0, M_PI);
+    double phi   = random_double(-M_PI, M_PI);
+    switch(random_int(6)) {
+    case 0: phi = M_PI - random_double(0, 0.05); break;
+    case 1: phi = -M_PI + random_double(0, 0.05); break;
+    case 2: theta = random_double(0, 0.05); break;
+    case 3: theta = M_PI; phi = M_PI; break; // exactly at the edges
+    case 4: phi = -random_double(0, 0.05); break; // just below the phi bin edge at zero
+    }
+    double const p = random_double(0.1, 10);
+    bank.putInt("pid", row, pids[random_int(static_cast<int>(pids.size()))]);
+    bank.putFloat("px", row, static_cast<float>(p * std::sin(theta) * std::cos(phi)));
+    bank.putFloat("py", row, static_cast<float>(p * std::sin(theta) * std::sin(phi)));
+    bank.putFloat("pz", row, static_cast<float>(p * std::cos(theta)));
+  };
+  // copy a particle, scaling its `py` by `py_scale`: a copy (1) or a copy mirrored in phi (-1) of a bank-B particle ties with it
+  // for a bank-A particle in the same direction, or for one projected to phi of zero (0), respectively; for the latter, if phi
+  // is just below zero, the tied particles are in different bins, and the one in the bank-A particle's bin has the larger row
+  auto copy_particle = [](hipo::bank const& bank_from, int const row_from, hipo::bank& bank_to, int const row_to, float const py_scale) {
+    bank_to.putInt("pid", row_to, bank_from.getInt("pid", row_from));
+    bank_to.putFloat("px", row_to, bank_from.getFloat("px", row_from));
+    bank_to.putFloat("py", row_to, py_scale * bank_from.getFloat("py", row_from));
+    bank_to.putFloat("pz", row_to, bank_from.getFloat("pz", row_from));
+  };
+  auto get_angles = [](hipo::bank const& bank, int const row) {
+    ROOT::Math::XYZVector const p(bank.getFloat("px", row), bank.getFloat("py", row), bank.getFloat("pz", row));
+    return std::pair{p.theta(), p.phi()};
+  };
+
+  for(auto const max_proximity : {-1.0, 0.05}) {
+    iguana::clas12::MatchParticleProximity algo;
+    algo.SetLogLevel(log_level);
+    algo.SetOption("max_proximity", max_proximity);
+    algo.Start();
+    auto bank_result = algo.GetCreatedBank();
+    int num_matched  = 0;
+
+    for(int event = 0; event < 2000; event++) {
+      // enough bank-B particles of each PID that some groups are binned, while others are not
+      hipo::bank bank_a(particle_schema, random_int(40));
+      hipo::bank bank_b(particle_schema, random_int(event % 2 == 0 ? 100 : 20));
+      for(int row = 0; row < bank_b.getRows(); row++) {
+        auto const choice = random_int(6);
+        if(row > 0 && choice < 2)
+          copy_particle(bank_b, random_int(row), bank_b, row, choice == 0 ? 1 : -1);
+        else
+          fill_particle(bank_b, row);
+      }
+      for(int row = 0; row < bank_a.getRows(); row++) {
+        auto const choice = random_int(4);
+        if(bank_b.getRows() > 0 && choice < 2)
+          copy_particle(bank_b, random_int(bank_b.getRows()), bank_a, row, choice == 0 ? 1 : 0);
+        else
+          fill_particle(bank_a, row);
+      }
+      algo.Run(bank_a, bank_b, bank_result);
+
+      // compare to every bank-B particle with the same PID, in order, keeping the first one with the smallest proximity
+      int result_row = 0;
+      for(int row_a = 0; row_a < bank_a.getRows(); row_a++) {
+        auto const [theta_a, phi_a] = get_angles(bank_a, row_a);
+        double min_prox             = -1;
+        int pindex_b                = -1;
+        for(int row_b = 0; row_b < bank_b.getRows(); row_b++) {
+          if(bank_b.getInt("pid", row_b) != bank_a.getInt("pid", row_a))
+            continue;
+          auto const [theta_b, phi_b] = get_angles(bank_b, row_b);
+          auto const prox             = std::hypot(
+              iguana::physics::tools::AdjustAnglePi(theta_b - theta_a),
+              iguana::physics::tools::AdjustAnglePi(phi_b - phi_a));
+          if(pindex_b < 0 || prox < min_prox) {
+            min_prox = prox;
+            pindex_b = row_b;
+          }
+        }
+        if(pindex_b < 0 || (max_proximity >= 0 && min_prox > max_proximity))
+          continue;
+        if(result_row >= bank_result.getRows() ||
+           bank_result.getShort("pindex_a", result_row) != row_a ||
+           bank_result.getShort("pindex_b", result_row) != pindex_b ||
+           bank_result.getDouble("proximity", result_row) != min_prox) {
+          log.Error("event {} with max_proximity={}: particle {} should match particle {}, with proximity {}", event, max_proximity, row_a, pindex_b, min_prox);
+          return 1;
+        }
+        result_row++;
+      }
+      if(result_row != bank_result.getRows()) {
+        log.Error("event {} with max_proximity={}: {} matches, rather than {}", event, max_proximity, bank_result.getRows(), result_row);
+        return 1;
+      }
+      num_matched += result_row;
+    }
+    log.Info("max_proximity={}: matched {} particles", max_proximity, num_matched);
+    algo.Stop();
+  }
+
+  return 0;
+}
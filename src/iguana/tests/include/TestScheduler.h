@@ -0,0 +1,156 @@
+// test the concurrent scheduling of an algorithm sequence's independent algorithms
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <hipo4/reader.h>
+#include <iguana/algorithms/AlgorithmSequence.h>
+#include <iguana/services/TaskPool.h>
+
+/// @returns true if the banks have the same rows and values
+inline bool TestSchedulerBanksEqual(hipo::bank& bank_a, hipo::bank& bank_b)
+{
+  auto const& rows_a = bank_a.getRowList();
+  auto const& rows_b = bank_b.getRowList();
+  if(!std::equal(rows_a.begin(), rows_a.end(), rows_b.begin(), rows_b.end()))
+    return false;
+  auto const& schema = bank_a.getSchema();
+  for(auto const& row : rows_a) {
+    for(int item = 0; item < schema.getEntries(); item++) {
+      switch(schema.getEntryType(item)) {
+      case hipo::kFloat:
+        if(bank_a.getFloat(item, row) != bank_b.getFloat(item, row))
+          return false;
+        break;
+      case hipo::kDouble:
+        if(bank_a.getDouble(item, row) != bank_b.getDouble(item, row))
+          return false;
+        break;
+      case hipo::kLong:
+        if(bank_a.getLong(item, row) != bank_b.getLong(item, row))
+          return false;
+        break;
+      default: // `getInt` reads the narrower integer types too, but `getLong` does not
+        if(bank_a.getInt(item, row) != bank_b.getInt(item, row))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+inline int TestScheduler(std::string const data_file, int const num_events, int const num_threads, std::string const log_level)
+{
+
+  iguana::Logger log("test");
+  log.SetLevel(log_level);
+
+  // check the task pool: all tasks run, unless one rejects or throws
+  {
+    iguana::TaskPool pool(3);
+    std::atomic<int> num_run{0};
+    if(!pool.RunEach(100, [&num_run](std::size_t const) { num_run++; return true; }) || num_run != 100) {
+      log.Error("task pool ran {} of 100 tasks", num_run.load());
+      return 1;
+    }
+    // the calling thread claims the first task, which rejects at once; the others are slow, so each worker
+    // claims at most one of them before the rest are skipped
+    num_run = 0;
+    auto const reject_first = [&num_run](std::size_t const i) {
+      num_run++;
+      if(i == 0)
+        return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      return true;
+    };
+    if(pool.RunEach(1000, reject_first) ||
+       num_run > 1 + static_cast<int>(pool.GetNumThreads())) {
+      log.Error("task pool ran {} tasks after the first one rejected", num_run.load() - 1);
+      return 1;
+    }
+    bool thrown = false;
+    try {
+      pool.RunEach(100, [](std::size_t const i) {
+        if(i == 50)
+          throw std::runtime_error("task failed");
+        return true;
+      });
+    }
+    catch(std::runtime_error const&) {
+      thrown = true;
+    }
+    if(!thrown) {
+      log.Error("task pool did not rethrow a task's exception");
+      return 1;
+    }
+    // without workers, the tasks run in order, and stop at the first which rejects
+    iguana::TaskPool serial_pool(0);
+    num_run = 0;
+    if(serial_pool.RunEach(10, [&num_run](std::size_t const i) { num_run++; return i != 3; }) || num_run != 4) {
+      log.Error("serial task pool ran {} tasks, rather than 4", num_run.load());
+      return 1;
+    }
+  }
+
+  if(data_file.empty()) {
+    log.Error("need a data file for command 'scheduler'");
+    return 1;
+  }
+
+  // run the same sequence serially and concurrently; after the filter, the rest of the algorithms are independent,
+  // so they form one level, in which `physics::InclusiveKinematics` rejects events without an electron
+  std::vector<std::string> const bank_names = {
+      "REC::Particle",
+      "RUN::config",
+      "REC::Track",
+      "REC::Calorimeter",
+      "REC::Scintillator",
+  };
+  auto make_sequence = [&log_level](unsigned int const threads) {
+    auto seq = std::make_unique<iguana::AlgorithmSequence>();
+    seq->Add("clas12::EventBuilderFilter");
+    seq->Add("physics::InclusiveKinematics");
+    seq->Add("clas12::SectorFinder");
+    seq->Add("clas12::CalorimeterLinker");
+    seq->SetNumThreads(threads);
+    seq->ForEachAlgorithm([&log_level](auto& algo) { algo->SetLogLevel(log_level); });
+    return seq;
+  };
+  auto seq_serial     = make_sequence(1);
+  auto seq_concurrent = make_sequence(std::max(num_threads, 2));
+
+  hipo::reader reader_serial(data_file.c_str());
+  hipo::reader reader_concurrent(data_file.c_str());
+  auto banks_serial     = reader_serial.getBanks(bank_names);
+  auto banks_concurrent = reader_concurrent.getBanks(bank_names);
+  seq_serial->Start(banks_serial);
+  seq_concurrent->Start(banks_concurrent);
+
+  // compare the decisions, and the banks of the accepted events
+  int num_compared = 0;
+  int num_accepted = 0;
+  while(reader_serial.next(banks_serial) && reader_concurrent.next(banks_concurrent)) {
+    if(num_events > 0 && num_compared >= num_events)
+      break;
+    auto const accepted = seq_serial->Run(banks_serial);
+    if(seq_concurrent->Run(banks_concurrent) != accepted) {
+      log.Error("event {}: the concurrent sequence's decision differs from the serial sequence's", num_compared);
+      return 1;
+    }
+    if(accepted) {
+      for(decltype(banks_serial)::size_type i = 0; i < banks_serial.size(); i++) {
+        if(!TestSchedulerBanksEqual(banks_serial[i], banks_concurrent[i])) {
+          log.Error("event {}: bank {:?} differs between the serial and concurrent sequences", num_compared, banks_serial[i].getSchema().getName());
+          return 1;
+        }
+      }
+      num_accepted++;
+    }
+    num_compared++;
+  }
+  log.Info("compared {} events, {} of them accepted", num_compared, num_accepted);
+
+  seq_serial->Stop();
+  seq_concurrent->Stop();
+  return 0;
+}
@@ -0,0 +1,120 @@
+// test ScratchArena
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <iguana/algorithms/ScratchArena.h>
+#include <iguana/services/Logger.h>
+
+inline int TestScratchArena()
+{
+
+  iguana::Logger log("test");
+  auto& arena = iguana::ScratchArena::Get();
+
+  // allocating outside of a scope throws
+  try {
+    static_cast<void>(arena.allocate(16));
+    log.Error("allocating outside of a scope did not throw");
+    return 1;
+  }
+  catch(std::runtime_error const&) {
+  }
+
+  // an object made in the arena, which counts its destructions
+  int num_destroyed = 0;
+  struct counted_t
+  {
+      explicit counted_t(int* num_destroyed_)
+          : num_destroyed(num_destroyed_)
+      {}
+      counted_t(counted_t&& other) noexcept
+          : num_destroyed(std::exchange(other.num_destroyed, nullptr))
+      {}
+      ~counted_t()
+      {
+        if(num_destroyed != nullptr)
+          ++*num_destroyed;
+      }
+      int* num_destroyed;
+  };
+
+  // an inner scope does not reclaim the memory or destroy the objects of its outer scope, nor its own, since the outer scope
+  // may still use them; the outermost scope reclaims all of them
+  void* first_ptr = nullptr;
+  {
+    iguana::ScratchArena::Scope const scope;
+    auto* outer = static_cast<char*>(arena.allocate(64, 8));
+    first_ptr   = outer;
+    std::memset(outer, 'a', 64);
+    void* inner = nullptr;
+    {
+      iguana::ScratchArena::Scope const inner_scope;
+      inner = arena.allocate(64, 8);
+      std::memset(inner, 'b', 64);
+      arena.Make(counted_t(&num_destroyed));
+    }
+    if(num_destroyed != 0) {
+      log.Error("an inner scope destroyed an object made in the arena");
+      return 1;
+    }
+    for(int i = 0; i < 64; i++) {
+      if(outer[i] != 'a') {
+        log.Error("an inner scope overwrote the memory of its outer scope");
+        return 1;
+      }
+    }
+    if(arena.allocate(64, 8) == inner) {
+      log.Error("an inner scope reclaimed its memory before the outermost scope ended");
+      return 1;
+    }
+  }
+  if(num_destroyed != 1) {
+    log.Error("the outermost scope destroyed {} objects made in the arena, rather than 1", num_destroyed);
+    return 1;
+  }
+
+  // the next scope reuses the blocks: it starts from the same address, and the arena does not grow for the same allocations
+  auto const capacity = arena.GetCapacity();
+  for(int scope_num = 0; scope_num < 3; scope_num++) {
+    iguana::ScratchArena::Scope const scope;
+    if(arena.allocate(64, 8) != first_ptr) {
+      log.Error("scope {} did not reuse the arena's first block", scope_num);
+      return 1;
+    }
+    static_cast<void>(arena.allocate(64, 8));
+    if(arena.GetCapacity() != capacity) {
+      log.Error("scope {} grew the arena from {} to {} bytes, for the same allocations", scope_num, capacity, arena.GetCapacity());
+      return 1;
+    }
+  }
+
+  // allocations larger than a block, and with large alignments, are given their own, larger block, which is then reused
+  std::size_t const large_size = 1024 * 1024;
+  std::size_t large_capacity   = 0;
+  for(int scope_num = 0; scope_num < 2; scope_num++) {
+    iguana::ScratchArena::Scope const scope;
+    static_cast<void>(arena.allocate(64, 8));
+    auto* large = arena.allocate(large_size, 256);
+    if(reinterpret_cast<std::uintptr_t>(large) % 256 != 0) {
+      log.Error("a large allocation is not aligned");
+      return 1;
+    }
+    std::memset(large, 'c', large_size);
+    if(arena.GetCapacity() < capacity + large_size) {
+      log.Error("the arena has {} bytes, which is too few for a large allocation", arena.GetCapacity());
+      return 1;
+    }
+    if(scope_num == 0)
+      large_capacity = arena.GetCapacity();
+    else if(arena.GetCapacity() != large_capacity) {
+      log.Error("the arena grew from {} to {} bytes, rather than reusing the block of a large allocation", large_capacity, arena.GetCapacity());
+      return 1;
+    }
+  }
+
+  log.Info("ScratchArena passed");
+  return 0;
+}
@@ -0,0 +1,92 @@
+// test Tracer
+
+#include <filesystem>
+#include <fstream>
+#include <iguana/services/Logger.h>
+#include <iguana/services/Tracer.h>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+inline int TestTracer()
+{
+
+  iguana::Logger log("test");
+  using Tracer = iguana::Tracer;
+
+  auto const trace_file = (std::filesystem::temp_directory_path() / fmt::format("iguana_test_trace_{}.json", getpid())).string();
+
+  // a span before tracing is enabled is not recorded
+  {
+    Tracer::Span span("test", "Before");
+  }
+
+  // sample one in every 2 events; nested event spans belong to their outermost event
+  Tracer::Enable(trace_file, 2);
+  {
+    Tracer::Span span("test", "Start");
+  }
+  for(int event = 0; event < 10; event++) {
+    Tracer::Span span("test", "Run", Tracer::SpanKind::event);
+    Tracer::Span inner_span("test|inner", "Run", Tracer::SpanKind::event);
+    Tracer::Span plain_span("test|inner", "Step");
+  }
+  std::thread([]() { Tracer::Span span("thread", "Start"); }).join();
+  Tracer::Disable();
+
+  // a span after tracing is disabled is not recorded
+  {
+    Tracer::Span span("test", "After");
+  }
+
+  std::ifstream in(trace_file);
+  if(!in.is_open()) {
+    log.Error("trace file {:?} was not written", trace_file);
+    return 1;
+  }
+  std::stringstream trace_stream;
+  trace_stream << in.rdbuf();
+  auto const trace = trace_stream.str();
+  in.close();
+  std::filesystem::remove(trace_file);
+
+  auto count = [&trace](std::string const& text) {
+    int num = 0;
+    for(auto pos = trace.find(text); pos != std::string::npos; pos = trace.find(text, pos + 1))
+      num++;
+    return num;
+  };
+  std::vector<std::pair<std::string, int>> const expected_counts = {
+      {"\"name\": \"test::Before\"", 0},
+      {"\"name\": \"test::Start\"", 1},
+      {"\"name\": \"test::Run\"", 5},
+      {"\"name\": \"test|inner::Run\"", 5},
+      {"\"name\": \"test|inner::Step\"", 5},
+      {"\"name\": \"thread::Start\"", 1},
+      {"\"name\": \"test::After\"", 0},
+      {"\"name\": \"thread_name\"", 2},
+  };
+  for(auto const& [text, expected_count] : expected_counts) {
+    if(auto const num = count(text); num != expected_count) {
+      log.Error("trace has {} of {}, rather than {}", num, text, expected_count);
+      return 1;
+    }
+  }
+
+  // the process and thread IDs are the operating system's
+  if(count(fmt::format("\"pid\": {},", getpid())) != count("\"pid\": ")) {
+    log.Error("trace has a process ID which is not {}", getpid());
+    return 1;
+  }
+#ifdef __linux__
+  if(count(fmt::format("\"tid\": {}, \"args\"", syscall(SYS_gettid))) != 1) {
+    log.Error("trace has no thread with ID {}", syscall(SYS_gettid));
+    return 1;
+  }
+#endif
+
+  return 0;
+}